@@ -0,0 +1,446 @@
+#include "ClusterCuller.h"
+#include "VulkanMemory.h"
+#include "Debug.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+
+#include "../Maths/LinAlg.h"
+
+namespace Engine
+{
+	constexpr u32 MIN_CLUSTER_CAPACITY = 1024;
+	constexpr u32 MIN_DRAW_CAPACITY = 64;
+
+	namespace {
+		//------------------------------------------------------------------------------------
+		// The center of projection is the point clip x, y and w all vanish at: A * eye = -b, A and b the linear and
+		// translation parts of those rows. Vulkan rasterizes a triangle with the winding sign( det( A ) ) * sign( dot( normal, position - eye ) ),
+		// so with the pipeline's clockwise front faces a counter-clockwise normal faces away when det( A ) * dot( normal, position - eye ) < 0
+		Maths::Vector4 ProjectionEye( const Maths::Matrix4& _viewProjection )
+		{
+			const Maths::Vector3 a0{ .x = _viewProjection.c1.x, .y = _viewProjection.c1.y, .z = _viewProjection.c1.w };
+			const Maths::Vector3 a1{ .x = _viewProjection.c2.x, .y = _viewProjection.c2.y, .z = _viewProjection.c2.w };
+			const Maths::Vector3 a2{ .x = _viewProjection.c3.x, .y = _viewProjection.c3.y, .z = _viewProjection.c3.w };
+			const Maths::Vector3 b{ .x = -_viewProjection.c4.x, .y = -_viewProjection.c4.y, .z = -_viewProjection.c4.w };
+
+			const f32 det = Maths::LinAlg::Dot( a0, Maths::LinAlg::Cross( a1, a2 ) );
+
+			// Orthographic, no eye: the cone test is disabled
+			if ( std::abs( det ) < 1e-12f )
+				return Maths::Vector4{ 0.0f, 0.0f, 0.0f, 0.0f };
+
+			// Cramer's rule
+			return Maths::Vector4{
+				Maths::LinAlg::Dot( b, Maths::LinAlg::Cross( a1, a2 ) ) / det,
+				Maths::LinAlg::Dot( a0, Maths::LinAlg::Cross( b, a2 ) ) / det,
+				Maths::LinAlg::Dot( a0, Maths::LinAlg::Cross( a1, b ) ) / det,
+				det > 0.0f ? -1.0f : 1.0f
+			};
+		}
+	} // end anonymous namespace
+
+	//------------------------------------------------------------------------------------
+	ClusterCuller::ClusterCuller( VkDevice _device, VkPhysicalDevice _physDevice )
+		: m_Device( _device )
+		, m_PhysDevice( _physDevice )
+	{
+		createDescriptorSetLayout();
+		createDescriptorPool();
+
+		std::array<VkDescriptorSetLayout, MAX_FRAMES_IN_FLIGHT> layouts;
+		layouts.fill( m_DescriptorSetLayout );
+
+		VkDescriptorSetAllocateInfo allocInfo{
+			.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
+			.pNext = nullptr,
+			.descriptorPool = m_DescriptorPool,
+			.descriptorSetCount = static_cast<u32>( layouts.size() ),
+			.pSetLayouts = layouts.data()
+		};
+
+		std::array<VkDescriptorSet, MAX_FRAMES_IN_FLIGHT> sets;
+		VK_ASSERT( vkAllocateDescriptorSets( m_Device, &allocInfo, sets.data() ) );
+
+		for ( u32 i = 0; i < MAX_FRAMES_IN_FLIGHT; i++ )
+		{
+			m_Frames[i].m_DescriptorSet = sets[i];
+		}
+	}
+
+	//------------------------------------------------------------------------------------
+	ClusterCuller::~ClusterCuller()
+	{
+		destroyPipeline();
+
+		for ( FrameResources& frame : m_Frames )
+		{
+			release( frame.m_Clusters );
+			release( frame.m_Input );
+			release( frame.m_Commands );
+			release( frame.m_Counts );
+		}
+
+		vkDestroyDescriptorPool( m_Device, m_DescriptorPool, nullptr );
+		vkDestroyDescriptorSetLayout( m_Device, m_DescriptorSetLayout, nullptr );
+	}
+
+	//------------------------------------------------------------------------------------
+	void ClusterCuller::createDescriptorSetLayout()
+	{
+		// Models, clusters, input, commands, counts
+		std::array<VkDescriptorSetLayoutBinding, 5> bindings;
+		for ( u32 i = 0; i < bindings.size(); i++ )
+		{
+			bindings[i] = VkDescriptorSetLayoutBinding{
+				.binding = i,
+				.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+				.descriptorCount = 1,
+				.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT,
+				.pImmutableSamplers = nullptr
+			};
+		}
+
+		VkDescriptorSetLayoutCreateInfo layoutInfo{
+			.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
+			.pNext = nullptr,
+			.flags = 0,
+			.bindingCount = static_cast<u32>( bindings.size() ),
+			.pBindings = bindings.data()
+		};
+
+		VK_ASSERT( vkCreateDescriptorSetLayout( m_Device, &layoutInfo, nullptr, &m_DescriptorSetLayout ) );
+	}
+
+	//------------------------------------------------------------------------------------
+	void ClusterCuller::createDescriptorPool()
+	{
+		VkDescriptorPoolSize poolSize{
+			.type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+			.descriptorCount = 5 * MAX_FRAMES_IN_FLIGHT
+		};
+
+		VkDescriptorPoolCreateInfo poolInfo{
+			.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
+			.pNext = nullptr,
+			.flags = 0,
+			.maxSets = MAX_FRAMES_IN_FLIGHT,
+			.poolSizeCount = 1,
+			.pPoolSizes = &poolSize
+		};
+
+		VK_ASSERT( vkCreateDescriptorPool( m_Device, &poolInfo, nullptr, &m_DescriptorPool ) );
+	}
+
+	//------------------------------------------------------------------------------------
+	void ClusterCuller::createPipeline( VkShaderModule _module, TransformEncoding _encoding, bool _vertexPulling )
+	{
+		m_VertexPulling = _vertexPulling;
+
+		// cull.comp: constant_id 0 is TRANSFORM_ENCODING, as in main.vert, 1 is VERTEX_PULLING
+		struct {
+			u32 m_TransformEncoding;
+			VkBool32 m_VertexPulling;
+		} constants{ static_cast<u32>( _encoding ), _vertexPulling ? VK_TRUE : VK_FALSE };
+
+		const std::array<VkSpecializationMapEntry, 2> entries{
+			VkSpecializationMapEntry{.constantID = 0, .offset = offsetof( decltype( constants ), m_TransformEncoding ), .size = sizeof( u32 ) },
+			VkSpecializationMapEntry{.constantID = 1, .offset = offsetof( decltype( constants ), m_VertexPulling ), .size = sizeof( VkBool32 ) }
+		};
+
+		const VkSpecializationInfo specialization{
+			.mapEntryCount = static_cast<u32>( entries.size() ),
+			.pMapEntries = entries.data(),
+			.dataSize = sizeof( constants ),
+			.pData = &constants
+		};
+
+		VkPushConstantRange pushConstantRange{
+			.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT,
+			.offset = 0,
+			.size = sizeof( u32 )
+		};
+
+		VkPipelineLayoutCreateInfo pipelineLayoutCreateInfo{
+			.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
+			.pNext = nullptr,
+			.flags = 0,
+			.setLayoutCount = 1,
+			.pSetLayouts = &m_DescriptorSetLayout,
+			.pushConstantRangeCount = 1,
+			.pPushConstantRanges = &pushConstantRange
+		};
+
+		VK_ASSERT( vkCreatePipelineLayout( m_Device, &pipelineLayoutCreateInfo, nullptr, &m_PipelineLayout ) );
+
+		VkComputePipelineCreateInfo pipelineCreateInfo{
+			.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO,
+			.pNext = nullptr,
+			.flags = 0,
+			.stage = VkPipelineShaderStageCreateInfo{
+				.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
+				.pNext = nullptr,
+				.flags = 0,
+				.stage = VK_SHADER_STAGE_COMPUTE_BIT,
+				.module = _module,
+				.pName = "main",
+				.pSpecializationInfo = &specialization
+			},
+			.layout = m_PipelineLayout,
+			.basePipelineHandle = VK_NULL_HANDLE,
+			.basePipelineIndex = -1
+		};
+
+		VK_ASSERT( vkCreateComputePipelines( m_Device, VK_NULL_HANDLE, 1, &pipelineCreateInfo, nullptr, &m_Pipeline ) );
+	}
+
+	//------------------------------------------------------------------------------------
+	void ClusterCuller::destroyPipeline()
+	{
+		if ( m_Pipeline != VK_NULL_HANDLE )
+			vkDestroyPipeline( m_Device, m_Pipeline, nullptr );
+
+		if ( m_PipelineLayout != VK_NULL_HANDLE )
+			vkDestroyPipelineLayout( m_Device, m_PipelineLayout, nullptr );
+
+		m_Pipeline = VK_NULL_HANDLE;
+		m_PipelineLayout = VK_NULL_HANDLE;
+	}
+
+	//------------------------------------------------------------------------------------
+	u32 ClusterCuller::addClusters( std::span<const Scene::GeometryCluster> _clusters )
+	{
+		const u32 first = static_cast<u32>( m_Clusters.size() );
+
+		for ( const Scene::GeometryCluster& cluster : _clusters )
+		{
+			m_Clusters.push_back( GpuCluster{
+				.m_Sphere = Maths::Vector4{ cluster.m_Center.x, cluster.m_Center.y, cluster.m_Center.z, cluster.m_Radius },
+				.m_Cone = Maths::Vector4{ cluster.m_ConeAxis.x, cluster.m_ConeAxis.y, cluster.m_ConeAxis.z, cluster.m_ConeCutoff },
+				.m_FirstIndex = cluster.m_FirstIndex,
+				.m_IndexCount = cluster.m_IndexCount,
+				.m_Padding = { 0, 0 }
+			} );
+		}
+
+		// Geometry uploads are rare, each frame copies the whole table once
+		for ( FrameResources& frame : m_Frames )
+		{
+			frame.m_ClustersDirty = true;
+		}
+
+		return first;
+	}
+
+	//------------------------------------------------------------------------------------
+	void ClusterCuller::removeClusters( u32 _first, u32 _count )
+	{
+		assert( u64( _first ) + _count <= m_Clusters.size() );
+
+		m_Clusters.erase( m_Clusters.begin() + _first, m_Clusters.begin() + _first + _count );
+
+		for ( FrameResources& frame : m_Frames )
+		{
+			frame.m_ClustersDirty = true;
+		}
+	}
+
+	//------------------------------------------------------------------------------------
+	void ClusterCuller::setCamera( const Maths::Matrix4& _viewProjection )
+	{
+		const Maths::Frustum frustum = Maths::Frustum::FromMatrix( _viewProjection );
+
+		m_Camera = CullCamera{
+			.m_Planes = frustum.m_Planes,
+			.m_Eye = ProjectionEye( _viewProjection )
+		};
+	}
+
+	//------------------------------------------------------------------------------------
+	void ClusterCuller::clearDraws()
+	{
+		m_Draws.clear();
+		m_CommandCount = 0;
+		m_GroupCount = 0;
+	}
+
+	//------------------------------------------------------------------------------------
+	u32 ClusterCuller::queueDraw( u32 _modelIndex, u32 _firstCluster, u32 _clusterCount )
+	{
+		assert( _clusterCount > 0 && u64( _firstCluster ) + _clusterCount <= m_Clusters.size() );
+
+		m_Draws.push_back( CullDraw{
+			.m_ModelIndex = _modelIndex,
+			.m_FirstCluster = _firstCluster,
+			.m_ClusterCount = _clusterCount,
+			.m_FirstCommand = m_CommandCount,
+			.m_FirstGroup = m_GroupCount
+		} );
+
+		// Room for every cluster surviving
+		m_CommandCount += _clusterCount;
+		m_GroupCount += ( _clusterCount + WORKGROUP_SIZE - 1 ) / WORKGROUP_SIZE;
+
+		return static_cast<u32>( m_Draws.size() - 1 );
+	}
+
+	//------------------------------------------------------------------------------------
+	void ClusterCuller::recordCulling( VkCommandBuffer _commandBuffer, u32 _frame, VkBuffer _modelBuffer )
+	{
+		if ( m_Draws.empty() )
+			return;
+
+		assert( m_Pipeline != VK_NULL_HANDLE );
+		FrameResources& frame = m_Frames[_frame];
+
+		// The frame's timeline value has been waited on, its buffers can be reallocated and rewritten
+		bool reallocated = false;
+		if ( frame.m_ClustersDirty )
+		{
+			const VkDeviceSize clusterBytes = sizeof( GpuCluster ) * std::bit_ceil( std::max<size_t>( m_Clusters.size(), MIN_CLUSTER_CAPACITY ) );
+			reallocated |= reserve( frame.m_Clusters, clusterBytes, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, true );
+
+			memcpy( frame.m_Clusters.m_Mapped, m_Clusters.data(), m_Clusters.size() * sizeof( GpuCluster ) );
+			frame.m_ClustersDirty = false;
+		}
+
+		const size_t drawCapacity = std::bit_ceil( std::max<size_t>( m_Draws.size(), MIN_DRAW_CAPACITY ) );
+		const size_t commandCapacity = std::bit_ceil( std::max<size_t>( m_CommandCount, MIN_CLUSTER_CAPACITY ) );
+		reallocated |= reserve( frame.m_Input, sizeof( CullCamera ) + sizeof( CullDraw ) * drawCapacity, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, true );
+		reallocated |= reserve( frame.m_Commands, sizeof( VkDrawIndexedIndirectCommand ) * commandCapacity,
+			VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT, false );
+		reallocated |= reserve( frame.m_Counts, sizeof( u32 ) * drawCapacity,
+			VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, false );
+
+		if ( reallocated || frame.m_DescriptorDirty )
+		{
+			writeDescriptorSet( frame, _modelBuffer );
+		}
+
+		auto* pInput = static_cast<std::byte*>( frame.m_Input.m_Mapped );
+		memcpy( pInput, &m_Camera, sizeof( CullCamera ) );
+		memcpy( pInput + sizeof( CullCamera ), m_Draws.data(), m_Draws.size() * sizeof( CullDraw ) );
+
+		// Counts start at zero, the shader appends to them
+		vkCmdFillBuffer( _commandBuffer, frame.m_Counts.m_Buffer, 0, sizeof( u32 ) * m_Draws.size(), 0 );
+
+		VkMemoryBarrier clearBarrier{
+			.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+			.pNext = nullptr,
+			.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+			.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT
+		};
+		vkCmdPipelineBarrier( _commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &clearBarrier, 0, nullptr, 0, nullptr );
+
+		vkCmdBindPipeline( _commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_Pipeline );
+		vkCmdBindDescriptorSets( _commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_PipelineLayout, 0, 1, &frame.m_DescriptorSet, 0, nullptr );
+
+		const u32 drawCount = static_cast<u32>( m_Draws.size() );
+		vkCmdPushConstants( _commandBuffer, m_PipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof( u32 ), &drawCount );
+		vkCmdDispatch( _commandBuffer, m_GroupCount, 1, 1 );
+
+		VkMemoryBarrier cullBarrier{
+			.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+			.pNext = nullptr,
+			.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT,
+			.dstAccessMask = VK_ACCESS_INDIRECT_COMMAND_READ_BIT
+		};
+		vkCmdPipelineBarrier( _commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT, 0, 1, &cullBarrier, 0, nullptr, 0, nullptr );
+	}
+
+	//------------------------------------------------------------------------------------
+	void ClusterCuller::recordDraw( VkCommandBuffer _commandBuffer, u32 _frame, u32 _draw ) const
+	{
+		assert( _draw < m_Draws.size() );
+
+		const FrameResources& frame = m_Frames[_frame];
+		const CullDraw& draw = m_Draws[_draw];
+
+		const VkDeviceSize commandOffset = VkDeviceSize{ draw.m_FirstCommand } * sizeof( VkDrawIndexedIndirectCommand );
+		const VkDeviceSize countOffset = VkDeviceSize{ _draw } * sizeof( u32 );
+
+		// Same stride either way, non-indexed commands leave the fifth word unused
+		if ( m_VertexPulling )
+		{
+			vkCmdDrawIndirectCount( _commandBuffer, frame.m_Commands.m_Buffer, commandOffset, frame.m_Counts.m_Buffer, countOffset,
+				draw.m_ClusterCount, sizeof( VkDrawIndexedIndirectCommand ) );
+		}
+		else
+		{
+			vkCmdDrawIndexedIndirectCount( _commandBuffer, frame.m_Commands.m_Buffer, commandOffset, frame.m_Counts.m_Buffer, countOffset,
+				draw.m_ClusterCount, sizeof( VkDrawIndexedIndirectCommand ) );
+		}
+	}
+
+	//------------------------------------------------------------------------------------
+	bool ClusterCuller::reserve( Buffer& _buffer, VkDeviceSize _size, VkBufferUsageFlags _usage, bool _hostVisible )
+	{
+		if ( _buffer.m_Size >= _size )
+			return false;
+
+		release( _buffer );
+
+		const VkMemoryPropertyFlags properties = _hostVisible ? VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT : VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+		VulkanMemory::createBuffer( m_Device, m_PhysDevice, _size, _usage, properties, _buffer.m_Buffer, _buffer.m_Memory );
+
+		if ( _hostVisible )
+		{
+			VK_ASSERT( vkMapMemory( m_Device, _buffer.m_Memory, 0, _size, 0, &_buffer.m_Mapped ) );
+		}
+
+		_buffer.m_Size = _size;
+		return true;
+	}
+
+	//------------------------------------------------------------------------------------
+	void ClusterCuller::release( Buffer& _buffer )
+	{
+		if ( _buffer.m_Buffer == VK_NULL_HANDLE )
+			return;
+
+		if ( _buffer.m_Mapped )
+			vkUnmapMemory( m_Device, _buffer.m_Memory );
+
+		vkDestroyBuffer( m_Device, _buffer.m_Buffer, nullptr );
+		vkFreeMemory( m_Device, _buffer.m_Memory, nullptr );
+
+		_buffer = Buffer{};
+	}
+
+	//------------------------------------------------------------------------------------
+	void ClusterCuller::writeDescriptorSet( FrameResources& _frame, VkBuffer _modelBuffer )
+	{
+		const std::array<VkDescriptorBufferInfo, 5> bufferInfos{
+			VkDescriptorBufferInfo{.buffer = _modelBuffer, .offset = 0, .range = VK_WHOLE_SIZE },
+			VkDescriptorBufferInfo{.buffer = _frame.m_Clusters.m_Buffer, .offset = 0, .range = VK_WHOLE_SIZE },
+			VkDescriptorBufferInfo{.buffer = _frame.m_Input.m_Buffer, .offset = 0, .range = VK_WHOLE_SIZE },
+			VkDescriptorBufferInfo{.buffer = _frame.m_Commands.m_Buffer, .offset = 0, .range = VK_WHOLE_SIZE },
+			VkDescriptorBufferInfo{.buffer = _frame.m_Counts.m_Buffer, .offset = 0, .range = VK_WHOLE_SIZE }
+		};
+
+		std::array<VkWriteDescriptorSet, 5> writes;
+		for ( u32 i = 0; i < writes.size(); i++ )
+		{
+			writes[i] = VkWriteDescriptorSet{
+				.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+				.pNext = nullptr,
+				.dstSet = _frame.m_DescriptorSet,
+				.dstBinding = i,
+				.dstArrayElement = 0,
+				.descriptorCount = 1,
+				.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+				.pImageInfo = nullptr,
+				.pBufferInfo = &bufferInfos[i],
+				.pTexelBufferView = nullptr
+			};
+		}
+
+		vkUpdateDescriptorSets( m_Device, static_cast<u32>( writes.size() ), writes.data(), 0, nullptr );
+
+		_frame.m_DescriptorDirty = false;
+	}
+
+} // end namespace Engine
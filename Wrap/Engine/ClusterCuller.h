@@ -0,0 +1,139 @@
+#pragma once
+
+#include "../Utils/Common.h"
+#include <span>
+
+#include "vulkan/vulkan_core.h"
+#include "VulkanConstants.h"
+#include "TransformEncoding.h"
+#include "../Maths/Frustum.h"
+#include "../Scene/GeometryAsset.h"
+
+namespace Engine
+{
+	// Cluster table entry, layout of cull.comp's Cluster
+	struct GpuCluster
+	{
+		// Object space center and radius
+		Maths::Vector4 m_Sphere;
+		// Object space axis and cutoff, see Scene::GeometryCluster
+		Maths::Vector4 m_Cone;
+		u32 m_FirstIndex;
+		u32 m_IndexCount;
+		u32 m_Padding[2];
+	};
+
+	// Header of cull.comp's input, world space
+	struct CullCamera
+	{
+		std::array<Maths::Vector4, Maths::Frustum::PLANE_COUNT> m_Planes;
+		// Center of projection. w orients the cone axes so that clusters facing away test positive, 0 disables the cone test
+		Maths::Vector4 m_Eye;
+	};
+
+	// One instance's clusters, follows CullCamera in cull.comp's input
+	struct CullDraw
+	{
+		u32 m_ModelIndex;
+		u32 m_FirstCluster;
+		u32 m_ClusterCount;
+		// Of the instance's commands and of its count
+		u32 m_FirstCommand;
+		// Workgroups before this draw's, the shader finds its draw by binary search on it
+		u32 m_FirstGroup;
+	};
+
+	// Frustum and normal cone culling of geometry clusters on the GPU, before any vertex is shaded.
+	// The clusters of every resident geometry share one table; each frame a compute pass writes an indexed indirect
+	// command per surviving cluster and a count per instance, drawn with vkCmdDrawIndexedIndirectCount.
+	// Per-frame resources only change once that frame's timeline value has been waited on, like ModelMatrixBuffer
+	class ClusterCuller
+	{
+	public:
+		// cull.comp's local_size_x
+		static constexpr u32 WORKGROUP_SIZE = 64;
+
+		ClusterCuller( VkDevice _device, VkPhysicalDevice _physDevice );
+		~ClusterCuller();
+
+		ClusterCuller( const ClusterCuller& _other ) = delete;
+		ClusterCuller& operator=( const ClusterCuller& ) = delete;
+
+		ClusterCuller( ClusterCuller&& _other ) = delete;
+		ClusterCuller& operator=( ClusterCuller&& ) = delete;
+
+		// Appended to the table, returns the index of the first
+		u32 addClusters( std::span<const Scene::GeometryCluster> _clusters );
+		// Clusters past the range move down by _count, holders of their indices must follow
+		void removeClusters( u32 _first, u32 _count );
+
+		void setCamera( const Maths::Matrix4& _viewProjection );
+
+		// Recreated along with the graphics pipeline, the shader decodes transforms as _encoding.
+		// With _vertexPulling the commands are non-indexed and carry the model index as their first instance, for pull.vert
+		void createPipeline( VkShaderModule _module, TransformEncoding _encoding, bool _vertexPulling );
+		void destroyPipeline();
+
+		// Instances queued since the last call are dropped, once per recorded frame
+		void clearDraws();
+		// Returns the slot recordDraw() takes
+		u32 queueDraw( u32 _modelIndex, u32 _firstCluster, u32 _clusterCount );
+
+		// The model buffer of _frame was reallocated, its descriptor is rewritten by the next recordCulling()
+		void invalidateModelBuffer( u32 _frame ) { m_Frames[_frame].m_DescriptorDirty = true; };
+
+		// Outside of a render pass, after every draw of the frame is queued
+		void recordCulling( VkCommandBuffer _commandBuffer, u32 _frame, VkBuffer _modelBuffer );
+		// In the render pass, with the instance's index buffer bound and its model index pushed unless pulling vertices
+		void recordDraw( VkCommandBuffer _commandBuffer, u32 _frame, u32 _draw ) const;
+
+	private:
+		struct Buffer
+		{
+			VkBuffer m_Buffer{ VK_NULL_HANDLE };
+			VkDeviceMemory m_Memory{ VK_NULL_HANDLE };
+			// Host visible buffers only
+			void* m_Mapped{ nullptr };
+			VkDeviceSize m_Size{ 0 };
+		};
+
+		struct FrameResources
+		{
+			Buffer m_Clusters;
+			// CullCamera then CullDraw[]
+			Buffer m_Input;
+			Buffer m_Commands;
+			Buffer m_Counts;
+
+			VkDescriptorSet m_DescriptorSet{ VK_NULL_HANDLE };
+			bool m_DescriptorDirty{ true };
+			bool m_ClustersDirty{ true };
+		};
+
+		void createDescriptorSetLayout();
+		void createDescriptorPool();
+
+		// Grows _buffer to at least _size, returns true if it was reallocated
+		bool reserve( Buffer& _buffer, VkDeviceSize _size, VkBufferUsageFlags _usage, bool _hostVisible );
+		void release( Buffer& _buffer );
+		void writeDescriptorSet( FrameResources& _frame, VkBuffer _modelBuffer );
+
+		std::vector<GpuCluster> m_Clusters;
+		std::vector<CullDraw> m_Draws;
+		u32 m_CommandCount{ 0 };
+		u32 m_GroupCount{ 0 };
+		CullCamera m_Camera{};
+
+		std::array<FrameResources, MAX_FRAMES_IN_FLIGHT> m_Frames;
+
+		VkDescriptorSetLayout m_DescriptorSetLayout{ VK_NULL_HANDLE };
+		VkDescriptorPool m_DescriptorPool{ VK_NULL_HANDLE };
+		VkPipelineLayout m_PipelineLayout{ VK_NULL_HANDLE };
+		VkPipeline m_Pipeline{ VK_NULL_HANDLE };
+		bool m_VertexPulling{ false };
+
+		VkDevice m_Device;
+		VkPhysicalDevice m_PhysDevice;
+	};
+
+} // end namespace Engine
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <deque>
+
+#include "../Utils/Common.h"
+
+namespace Engine
+{
+	// Defers destruction of GPU resources until no submission can still reference them.
+	// Each deleter is tagged with a value of the queue's TimelineSemaphore and runs once the semaphore has reached it
+	class DeletionQueue
+	{
+	public:
+		DeletionQueue() = default;
+
+		DeletionQueue( const DeletionQueue& _other ) = delete;
+		DeletionQueue& operator=( const DeletionQueue& ) = delete;
+
+		DeletionQueue( DeletionQueue&& _other ) = delete;
+		DeletionQueue& operator=( DeletionQueue&& ) = delete;
+
+		// _retireValue is the last submission that may use the resource, values must not decrease from one push to the next
+		void push( std::function<void()>&& _deleter, u64 _retireValue );
+
+		// Runs every deleter whose value is at most _completedValue
+		void flush( u64 _completedValue );
+
+		// Only once the device is idle
+		void flushAll();
+
+	private:
+		struct Entry
+		{
+			std::function<void()> m_Deleter;
+			u64 m_RetireValue;
+		};
+
+		std::deque<Entry> m_Entries;
+	};
+
+	//------------------------------------------------------------------------------------
+	inline void Engine::DeletionQueue::push( std::function<void()>&& _deleter, u64 _retireValue )
+	{
+		assert( m_Entries.empty() || m_Entries.back().m_RetireValue <= _retireValue );
+		m_Entries.push_back( Entry{ .m_Deleter = std::move( _deleter ), .m_RetireValue = _retireValue } );
+	}
+
+	//------------------------------------------------------------------------------------
+	inline void Engine::DeletionQueue::flush( u64 _completedValue )
+	{
+		while ( !m_Entries.empty() && m_Entries.front().m_RetireValue <= _completedValue )
+		{
+			m_Entries.front().m_Deleter();
+			m_Entries.pop_front();
+		}
+	}
+
+	//------------------------------------------------------------------------------------
+	inline void Engine::DeletionQueue::flushAll()
+	{
+		for ( auto& entry : m_Entries )
+		{
+			entry.m_Deleter();
+		}
+		m_Entries.clear();
+	}
+
+} // end namespace Engine
@@ -0,0 +1,126 @@
+#include "DrawRecordBuffer.h"
+#include "VulkanMemory.h"
+#include "Debug.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+
+namespace Engine
+{
+	constexpr u32 MIN_RECORD_CAPACITY = 64;
+
+	static_assert( sizeof( DrawRecord ) == 48 && offsetof( DrawRecord, m_Frame ) == 32, "Must match pull.vert's std430 DrawRecord" );
+
+	//------------------------------------------------------------------------------------
+	DrawRecordBuffer::DrawRecordBuffer( VkDevice _device, VkPhysicalDevice _physDevice )
+		: m_Device( _device )
+		, m_PhysDevice( _physDevice )
+	{
+		VkPhysicalDeviceProperties props;
+		vkGetPhysicalDeviceProperties( m_PhysDevice, &props );
+		m_MaxDrawsPerCall = std::max( props.limits.maxDrawIndirectCount, 1u );
+
+		// Descriptors need a buffer before the first frame is recorded
+		for ( FrameBuffers& frame : m_Frames )
+		{
+			reserve( frame.m_Records, sizeof( DrawRecord ) * MIN_RECORD_CAPACITY, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT );
+		}
+	}
+
+	//------------------------------------------------------------------------------------
+	DrawRecordBuffer::~DrawRecordBuffer()
+	{
+		for ( FrameBuffers& frame : m_Frames )
+		{
+			release( frame.m_Records );
+			release( frame.m_Commands );
+		}
+	}
+
+	//------------------------------------------------------------------------------------
+	bool DrawRecordBuffer::begin( u32 _frame, u32 _recordCount )
+	{
+		FrameBuffers& frame = m_Frames[_frame];
+
+		m_Frame = _frame;
+		m_RecordCount = _recordCount;
+		m_DrawCount = 0;
+
+		// The frame's timeline value has been waited on, its previous buffers are no longer in use
+		const VkDeviceSize capacity = std::bit_ceil( std::max( _recordCount, MIN_RECORD_CAPACITY ) );
+		reserve( frame.m_Commands, sizeof( VkDrawIndirectCommand ) * capacity, VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT );
+
+		return reserve( frame.m_Records, sizeof( DrawRecord ) * capacity, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT );
+	}
+
+	//------------------------------------------------------------------------------------
+	void DrawRecordBuffer::setRecord( u32 _index, const DrawRecord& _record )
+	{
+		assert( _index < m_RecordCount );
+
+		// memcpy, the mapping is write-combined on most drivers
+		auto* pRecords = static_cast<std::byte*>( m_Frames[m_Frame].m_Records.m_Mapped );
+		memcpy( pRecords + size_t( _index ) * sizeof( DrawRecord ), &_record, sizeof( DrawRecord ) );
+	}
+
+	//------------------------------------------------------------------------------------
+	void DrawRecordBuffer::pushDraw( u32 _record, u32 _firstIndex, u32 _indexCount )
+	{
+		assert( _record < m_RecordCount && m_DrawCount < m_RecordCount );
+
+		// pull.vert reads index gl_VertexIndex of the record gl_InstanceIndex
+		const VkDrawIndirectCommand command{
+			.vertexCount = _indexCount,
+			.instanceCount = 1,
+			.firstVertex = _firstIndex,
+			.firstInstance = _record
+		};
+
+		auto* pCommands = static_cast<std::byte*>( m_Frames[m_Frame].m_Commands.m_Mapped );
+		memcpy( pCommands + size_t( m_DrawCount ) * sizeof( VkDrawIndirectCommand ), &command, sizeof( VkDrawIndirectCommand ) );
+		m_DrawCount++;
+	}
+
+	//------------------------------------------------------------------------------------
+	void DrawRecordBuffer::recordDraws( VkCommandBuffer _commandBuffer ) const
+	{
+		const VkBuffer commands = m_Frames[m_Frame].m_Commands.m_Buffer;
+
+		for ( u32 first = 0; first < m_DrawCount; first += m_MaxDrawsPerCall )
+		{
+			const u32 count = std::min( m_DrawCount - first, m_MaxDrawsPerCall );
+			vkCmdDrawIndirect( _commandBuffer, commands, VkDeviceSize{ first } * sizeof( VkDrawIndirectCommand ), count, sizeof( VkDrawIndirectCommand ) );
+		}
+	}
+
+	//------------------------------------------------------------------------------------
+	bool DrawRecordBuffer::reserve( Buffer& _buffer, VkDeviceSize _size, VkBufferUsageFlags _usage )
+	{
+		if ( _buffer.m_Size >= _size )
+			return false;
+
+		release( _buffer );
+
+		VulkanMemory::createBuffer( m_Device, m_PhysDevice, _size, _usage,
+			VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, _buffer.m_Buffer, _buffer.m_Memory );
+		VK_ASSERT( vkMapMemory( m_Device, _buffer.m_Memory, 0, _size, 0, &_buffer.m_Mapped ) );
+
+		_buffer.m_Size = _size;
+		return true;
+	}
+
+	//------------------------------------------------------------------------------------
+	void DrawRecordBuffer::release( Buffer& _buffer )
+	{
+		if ( _buffer.m_Buffer == VK_NULL_HANDLE )
+			return;
+
+		vkUnmapMemory( m_Device, _buffer.m_Memory );
+		vkDestroyBuffer( m_Device, _buffer.m_Buffer, nullptr );
+		vkFreeMemory( m_Device, _buffer.m_Memory, nullptr );
+
+		_buffer = Buffer{};
+	}
+
+} // end namespace Engine
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "../Utils/Common.h"
+#include "vulkan/vulkan_core.h"
+#include "VertexFormat.h"
+#include "VulkanConstants.h"
+
+namespace Engine
+{
+	// What pull.vert knows about the mesh it draws, indexed by gl_InstanceIndex (the draw's model index)
+	struct DrawRecord
+	{
+		// Buffer device addresses of the geometry's buffers
+		VkDeviceAddress m_Vertices;
+		VkDeviceAddress m_Indices;
+		// 2 or 4
+		u32 m_IndexSize;
+		// In 4-byte words, the layout's attributes start at the front of each vertex
+		u32 m_VertexStride;
+		// Of the geometry's stored positions, a vec4 in pull.vert and aligned like one
+		alignas( 16 ) PositionFrame m_Frame;
+	};
+
+	// Per frame in flight, one host visible storage buffer of DrawRecord and one of non-indexed indirect commands.
+	// pull.vert fetches indices and vertices itself, so meshes of any geometry go into the same vkCmdDrawIndirect.
+	// Rewritten every frame for the meshes drawn, once that frame's timeline value has been waited on
+	class DrawRecordBuffer
+	{
+	public:
+		DrawRecordBuffer( VkDevice _device, VkPhysicalDevice _physDevice );
+		~DrawRecordBuffer();
+
+		DrawRecordBuffer( const DrawRecordBuffer& _other ) = delete;
+		DrawRecordBuffer& operator=( const DrawRecordBuffer& ) = delete;
+
+		DrawRecordBuffer( DrawRecordBuffer&& _other ) = delete;
+		DrawRecordBuffer& operator=( DrawRecordBuffer&& ) = delete;
+
+		// Room for _recordCount records and as many commands. Returns true if the frame's record buffer
+		// was reallocated and its descriptor must be rewritten
+		bool begin( u32 _frame, u32 _recordCount );
+
+		void setRecord( u32 _index, const DrawRecord& _record );
+		// _firstIndex and _indexCount address the record's index buffer
+		void pushDraw( u32 _record, u32 _firstIndex, u32 _indexCount );
+
+		// Every draw pushed since begin() in one call, inside the render pass with the pulling pipeline bound
+		void recordDraws( VkCommandBuffer _commandBuffer ) const;
+
+		VkBuffer getRecordBuffer( u32 _frame ) const { return m_Frames[_frame].m_Records.m_Buffer; };
+
+	private:
+		struct Buffer
+		{
+			VkBuffer m_Buffer{ VK_NULL_HANDLE };
+			VkDeviceMemory m_Memory{ VK_NULL_HANDLE };
+			void* m_Mapped{ nullptr };
+			VkDeviceSize m_Size{ 0 };
+		};
+
+		struct FrameBuffers
+		{
+			Buffer m_Records;
+			Buffer m_Commands;
+		};
+
+		// Grows _buffer to at least _size, returns true if it was reallocated
+		bool reserve( Buffer& _buffer, VkDeviceSize _size, VkBufferUsageFlags _usage );
+		void release( Buffer& _buffer );
+
+		std::array<FrameBuffers, MAX_FRAMES_IN_FLIGHT> m_Frames;
+
+		// Of the frame begun last
+		u32 m_Frame{ 0 };
+		u32 m_RecordCount{ 0 };
+		u32 m_DrawCount{ 0 };
+		// maxDrawIndirectCount, larger batches are split
+		u32 m_MaxDrawsPerCall{ 1 };
+
+		VkDevice m_Device;
+		VkPhysicalDevice m_PhysDevice;
+	};
+
+} // end namespace Engine
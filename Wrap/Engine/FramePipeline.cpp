@@ -0,0 +1,69 @@
+#include "FramePipeline.h"
+
+namespace Engine
+{
+	//----------------------------------------------------------------------------------
+	FramePipeline::FramePipeline( std::function<void()> _renderFrame )
+		: m_RenderFrame( std::move( _renderFrame ) )
+		, m_RenderThread( [this]( std::stop_token _stopToken ) { renderLoop( _stopToken ); } )
+	{
+	}
+
+	//----------------------------------------------------------------------------------
+	FramePipeline::~FramePipeline()
+	{
+		stop();
+	}
+
+	//----------------------------------------------------------------------------------
+	void FramePipeline::submitFrame()
+	{
+		const u64 frame = m_SubmittedFrame.fetch_add( 1, std::memory_order_acq_rel ) + 1;
+		m_SubmittedFrame.notify_one();
+
+		// Block only while the render thread is still behind on the previous frame
+		u64 started = m_StartedFrame.load( std::memory_order_acquire );
+		while ( started + 1 < frame )
+		{
+			m_StartedFrame.wait( started, std::memory_order_acquire );
+			started = m_StartedFrame.load( std::memory_order_acquire );
+		}
+	}
+
+	//----------------------------------------------------------------------------------
+	void FramePipeline::stop()
+	{
+		if ( !m_RenderThread.joinable() )
+			return;
+
+		m_RenderThread.request_stop();
+
+		// Wake the render thread if it is waiting for work
+		m_SubmittedFrame.fetch_add( 1, std::memory_order_acq_rel );
+		m_SubmittedFrame.notify_one();
+
+		m_RenderThread.join();
+	}
+
+	//----------------------------------------------------------------------------------
+	void FramePipeline::renderLoop( std::stop_token _stopToken )
+	{
+		u64 rendered = 0;
+
+		while ( true )
+		{
+			m_SubmittedFrame.wait( rendered, std::memory_order_acquire );
+
+			if ( _stopToken.stop_requested() )
+				break;
+
+			// Frames submitted while the previous one rendered collapse into the latest snapshot
+			rendered = m_SubmittedFrame.load( std::memory_order_acquire );
+
+			m_StartedFrame.store( rendered, std::memory_order_release );
+			m_StartedFrame.notify_one();
+
+			m_RenderFrame();
+		}
+	}
+} // end namespace Engine
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "../Utils/Common.h"
+#include <atomic>
+#include <thread>
+
+namespace Engine
+{
+	// Runs the render stage on its own thread so frame N is recorded and submitted while frame N+1 is simulated.
+	// The simulation stays at most one frame ahead, frame time becomes roughly the slower of the two stages.
+	class FramePipeline
+	{
+	public:
+		// _renderFrame runs on the render thread, once per submitted frame (skipped frames are coalesced)
+		explicit FramePipeline( std::function<void()> _renderFrame );
+		~FramePipeline();
+
+		FramePipeline( const FramePipeline& _other ) = delete;
+		FramePipeline& operator=( const FramePipeline& ) = delete;
+
+		FramePipeline( FramePipeline&& _other ) = delete;
+		FramePipeline& operator=( FramePipeline&& ) = delete;
+
+		// Simulation thread, once the frame's snapshot is published.
+		// Returns as soon as the render thread has picked up the previous frame.
+		void submitFrame();
+
+		// Finishes the frame being rendered and joins the render thread
+		void stop();
+
+	private:
+		void renderLoop( std::stop_token _stopToken );
+
+		std::function<void()> m_RenderFrame;
+
+		std::atomic<u64> m_SubmittedFrame{ 0 };
+		std::atomic<u64> m_StartedFrame{ 0 };
+
+		// Last member, the thread must start after everything it reads is constructed
+		std::jthread m_RenderThread;
+	};
+} // end namespace Engine
@@ -0,0 +1,182 @@
+#include "ModelMatrixBuffer.h"
+#include "VulkanMemory.h"
+#include "Debug.h"
+
+#include <bit>
+#include <cstring>
+
+namespace Engine
+{
+	constexpr u32 MIN_MODEL_CAPACITY = 64;
+
+	//------------------------------------------------------------------------------------
+	ModelMatrixBuffer::ModelMatrixBuffer( VkDevice _device, VkPhysicalDevice _physDevice, TransformEncoding _encoding /*= TransformEncoding::MATRIX_4X4*/ )
+		: m_Encoding( _encoding )
+		, m_Device( _device )
+		, m_PhysDevice( _physDevice )
+	{
+		for ( auto& frame : m_Frames )
+		{
+			allocate( frame, VkDeviceSize{ MIN_MODEL_CAPACITY } * TransformEncoder::stride( m_Encoding ) );
+		}
+	}
+
+	//------------------------------------------------------------------------------------
+	ModelMatrixBuffer::~ModelMatrixBuffer()
+	{
+		for ( auto& frame : m_Frames )
+		{
+			release( frame );
+		}
+	}
+
+	//------------------------------------------------------------------------------------
+	u32 ModelMatrixBuffer::push( const Maths::Matrix4& _model )
+	{
+		m_Models.push_back( _model );
+
+		const u32 index = size() - 1;
+		markDirty( index );
+
+		return index;
+	}
+
+	//------------------------------------------------------------------------------------
+	void ModelMatrixBuffer::set( u32 _index, const Maths::Matrix4& _model )
+	{
+		assert( _index < size() );
+
+		m_Models[_index] = _model;
+		markDirty( _index );
+	}
+
+	//------------------------------------------------------------------------------------
+	void ModelMatrixBuffer::remove( u32 _index )
+	{
+		assert( _index < size() );
+
+		const u32 last = size() - 1;
+		if ( _index != last )
+		{
+			m_Models[_index] = m_Models[last];
+			markDirty( _index );
+		}
+
+		m_Models.pop_back();
+	}
+
+	//------------------------------------------------------------------------------------
+	void ModelMatrixBuffer::setEncoding( TransformEncoding _encoding )
+	{
+		if ( _encoding == m_Encoding )
+			return;
+
+		m_Encoding = _encoding;
+
+		// Buffers too small for the new stride are reallocated by flush()
+		for ( auto& frame : m_Frames )
+		{
+			frame.m_FullUpload = true;
+			frame.m_DirtyIndices.clear();
+		}
+	}
+
+	//------------------------------------------------------------------------------------
+	void ModelMatrixBuffer::markDirty( u32 _index )
+	{
+		for ( auto& frame : m_Frames )
+		{
+			if ( frame.m_FullUpload )
+				continue;
+
+			// Past this point a single copy of the whole array is cheaper than tracking indices
+			if ( frame.m_DirtyIndices.size() >= m_Models.size() / 2 )
+			{
+				frame.m_FullUpload = true;
+				frame.m_DirtyIndices.clear();
+				continue;
+			}
+
+			frame.m_DirtyIndices.push_back( _index );
+		}
+	}
+
+	//------------------------------------------------------------------------------------
+	bool ModelMatrixBuffer::flush( u32 _frame )
+	{
+		FrameBuffer& frame = m_Frames[_frame];
+		bool reallocated = false;
+
+		const u32 stride = TransformEncoder::stride( m_Encoding );
+
+		if ( frame.m_Size < VkDeviceSize{ stride } * m_Models.size() )
+		{
+			// The frame's timeline value has been waited on, its previous buffer is no longer in use
+			release( frame );
+			const u32 capacity = std::max( MIN_MODEL_CAPACITY, static_cast<u32>( std::bit_ceil( m_Models.size() ) ) );
+			allocate( frame, VkDeviceSize{ stride } * capacity );
+			reallocated = true;
+		}
+
+		// Sequential writes only, the mapping is write-combined on most drivers
+		auto* pDest = static_cast<std::byte*>( frame.m_Mapped );
+
+		if ( frame.m_FullUpload )
+		{
+			if ( m_Encoding == TransformEncoding::MATRIX_4X4 )
+			{
+				memcpy( pDest, m_Models.data(), m_Models.size() * sizeof( Maths::Matrix4 ) );
+			}
+			else
+			{
+				for ( size_t index = 0; index < m_Models.size(); index++ )
+				{
+					TransformEncoder::encode( m_Encoding, m_Models[index], pDest + index * stride );
+				}
+			}
+		}
+		else
+		{
+			for ( const u32 index : frame.m_DirtyIndices )
+			{
+				// Entries may have been popped since they were marked
+				if ( index < m_Models.size() )
+				{
+					TransformEncoder::encode( m_Encoding, m_Models[index], pDest + size_t( index ) * stride );
+				}
+			}
+		}
+
+		frame.m_DirtyIndices.clear();
+		frame.m_FullUpload = false;
+
+		return reallocated;
+	}
+
+	//------------------------------------------------------------------------------------
+	void ModelMatrixBuffer::allocate( FrameBuffer& _frame, VkDeviceSize _size )
+	{
+		VulkanMemory::createBuffer( m_Device, m_PhysDevice, _size, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+			VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, _frame.m_Buffer, _frame.m_Memory );
+
+		VK_ASSERT( vkMapMemory( m_Device, _frame.m_Memory, 0, _size, 0, &_frame.m_Mapped ) );
+
+		_frame.m_Size = _size;
+		_frame.m_FullUpload = true;
+		_frame.m_DirtyIndices.clear();
+	}
+
+	//------------------------------------------------------------------------------------
+	void ModelMatrixBuffer::release( FrameBuffer& _frame )
+	{
+		if ( _frame.m_Buffer == VK_NULL_HANDLE )
+			return;
+
+		vkUnmapMemory( m_Device, _frame.m_Memory );
+		vkDestroyBuffer( m_Device, _frame.m_Buffer, nullptr );
+		vkFreeMemory( m_Device, _frame.m_Memory, nullptr );
+
+		_frame = FrameBuffer{};
+	}
+
+} // end namespace Engine
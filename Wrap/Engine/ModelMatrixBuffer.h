@@ -0,0 +1,68 @@
+#pragma once
+
+#include "../Utils/Common.h"
+#include "../Maths/Matrix4.h"
+#include "vulkan/vulkan_core.h"
+#include "VulkanConstants.h"
+#include "UniformBuffer.h"
+#include "TransformEncoding.h"
+
+namespace Engine
+{
+	// One host visible storage buffer per frame in flight holding every model matrix, indexed by draw.
+	// Writes go to a CPU mirror and are only encoded into a frame's buffer once that frame is safe to touch
+	class ModelMatrixBuffer
+	{
+	public:
+		ModelMatrixBuffer( VkDevice _device, VkPhysicalDevice _physDevice, TransformEncoding _encoding = TransformEncoding::MATRIX_4X4 );
+
+		ModelMatrixBuffer( const ModelMatrixBuffer& _other ) = delete;
+		ModelMatrixBuffer& operator=( const ModelMatrixBuffer& ) = delete;
+
+		ModelMatrixBuffer( ModelMatrixBuffer&& _other ) = delete;
+		ModelMatrixBuffer& operator=( ModelMatrixBuffer&& ) = delete;
+
+		~ModelMatrixBuffer();
+
+		u32 push( const Maths::Matrix4& _model );
+		void set( u32 _index, const Maths::Matrix4& _model );
+		// Swap and pop, the last entry moves into _index
+		void remove( u32 _index );
+
+		u32 size() const { return static_cast<u32>( m_Models.size() ); };
+
+		// Every frame is re-encoded at its next flush, the pipeline must be rebuilt with the matching shader constant
+		void setEncoding( TransformEncoding _encoding );
+		TransformEncoding getEncoding() const { return m_Encoding; };
+
+		// Uploads what changed since _frame was last flushed. Returns true if the frame's buffer
+		// was reallocated and its descriptor must be rewritten
+		bool flush( u32 _frame );
+
+		VkBuffer getBuffer( u32 _frame ) const { return m_Frames[_frame].m_Buffer; };
+
+	private:
+		struct FrameBuffer
+		{
+			VkBuffer m_Buffer{ VK_NULL_HANDLE };
+			VkDeviceMemory m_Memory{ VK_NULL_HANDLE };
+			void* m_Mapped{ nullptr };
+			VkDeviceSize m_Size{ 0 };
+
+			std::vector<u32> m_DirtyIndices;
+			bool m_FullUpload{ true };
+		};
+
+		void markDirty( u32 _index );
+		void allocate( FrameBuffer& _frame, VkDeviceSize _size );
+		void release( FrameBuffer& _frame );
+
+		std::vector<Maths::Matrix4> m_Models;
+		TransformEncoding m_Encoding;
+		std::array<FrameBuffer, MAX_FRAMES_IN_FLIGHT> m_Frames;
+
+		VkDevice m_Device;
+		VkPhysicalDevice m_PhysDevice;
+	};
+
+} // end namespace Engine
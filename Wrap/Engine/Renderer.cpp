@@ -1,4 +1,7 @@
 #include "Renderer.h"
+
+#include <cstring>
+
 #include "ShaderModule.h"
 #include "RuntimeShaderCompiler.h"
 #include "VulkanTypes.h"
@@ -24,9 +27,11 @@ namespace Engine {
 		vkDeviceWaitIdle( m_LogicalDevice );
 
 		destroyBuffersFreeMemory();
+		m_DeletionQueue.flushAll();
 
 		vkDestroyPipeline( m_LogicalDevice, m_GraphicsPipeline, nullptr );
 		vkDestroyPipelineLayout( m_LogicalDevice, m_PipelineLayout, nullptr );
+		m_ClusterCuller.reset();
 		m_Swapchain.reset();
 
 		vkDestroyDescriptorPool( m_LogicalDevice, m_DescriptorPool, nullptr );
@@ -37,19 +42,20 @@ namespace Engine {
 
 		vkDestroyCommandPool( m_LogicalDevice, m_CommandPool, nullptr );
 
+		if ( m_TimestampQueryPool != VK_NULL_HANDLE )
+			vkDestroyQueryPool( m_LogicalDevice, m_TimestampQueryPool, nullptr );
+
 		for ( size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++ )
 		{
 			vkDestroySemaphore( m_LogicalDevice, m_ImageAvailableSemaphores[i], nullptr );
 			vkDestroySemaphore( m_LogicalDevice, m_RenderFinishedSemaphores[i], nullptr );
-			vkDestroyFence( m_LogicalDevice, m_inFlightFences[i], nullptr );
 		}
+		m_GraphicsTimeline.reset();
 
 		// Necessary even on smart ptrs as they need to go before detroyDevice
 		m_CameraUBO.reset();
-		for ( auto& ubo : m_ModelUBOs )
-		{
-			ubo.reset();
-		}
+		m_ModelBuffer.reset();
+		m_DrawRecords.reset();
 
 		vkDestroyDevice( m_LogicalDevice, nullptr );
 
@@ -73,16 +79,29 @@ namespace Engine {
 		m_ShaderWatcher = std::make_unique<FileWatcher>( "./Shaders", [this]( const std::filesystem::path& _path ) { this->onShaderModification( _path ); } );
 
 		m_CameraUBO = std::make_unique<UniformBuffer>( m_LogicalDevice, m_PhysicalDevice, sizeof( CameraUBO ) );
-		m_ModelUBOs.push_back( std::make_unique<UniformBuffer>( m_LogicalDevice, m_PhysicalDevice, sizeof( ModelUBO ) ) );
-		m_ModelUBOs.push_back( std::make_unique<UniformBuffer>( m_LogicalDevice, m_PhysicalDevice, sizeof( ModelUBO ) ) );
+		m_ModelBuffer = std::make_unique<ModelMatrixBuffer>( m_LogicalDevice, m_PhysicalDevice, m_TransformEncoding );
+
+		if ( isClusterCullingSupported() )
+			m_ClusterCuller = std::make_unique<ClusterCuller>( m_LogicalDevice, m_PhysicalDevice );
+		else
+			std::cerr << "drawIndirectCount not supported, cluster culling disabled" << std::endl;
+
+		if ( isVertexPullingSupported() )
+			m_DrawRecords = std::make_unique<DrawRecordBuffer>( m_LogicalDevice, m_PhysicalDevice );
+		else
+			std::cerr << "bufferDeviceAddress not supported, vertex pulling disabled" << std::endl;
 
 		createDescriptorSetLayout();
 		createDescriptorPool();
 		createDescriptorSets();
-		createGraphicsPipeline( true );
+		loadShaderArchive();
+		createGraphicsPipeline( m_ShaderArchive == nullptr );
+		createCullPipeline( m_ShaderArchive == nullptr );
 		createCommandPool();
 		createCommandBuffers();
+		m_GraphicsTimeline = std::make_unique<TimelineSemaphore>( m_LogicalDevice );
 		createSyncObjects();
+		createTimestampQueryPool();
 	}
 
 	//----------------------------------------------------------------------------------
@@ -215,8 +234,25 @@ namespace Engine {
 		features12.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
 		features12.runtimeDescriptorArray = VK_TRUE;
 		features12.shaderUniformBufferArrayNonUniformIndexing = VK_TRUE;
+		// Core in 1.2, frames and uploads are tracked with it rather than fences
+		features12.timelineSemaphore = VK_TRUE;
 		features12.pNext = &features13;
 
+		// One indirect draw per instance, as many commands as the culling pass kept
+		if ( isClusterCullingSupported() )
+		{
+			enabledFeatures.multiDrawIndirect = VK_TRUE;
+			features12.drawIndirectCount = VK_TRUE;
+		}
+
+		// Geometry read through buffer addresses, the model index passed as the first instance
+		if ( isVertexPullingSupported() )
+		{
+			enabledFeatures.multiDrawIndirect = VK_TRUE;
+			enabledFeatures.drawIndirectFirstInstance = VK_TRUE;
+			features12.bufferDeviceAddress = VK_TRUE;
+		}
+
 		VkDeviceCreateInfo createInfo{
 			.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO,
 			.pNext = &features12,
@@ -254,15 +290,25 @@ namespace Engine {
 			.pImmutableSamplers = nullptr
 		};
 
+		// All model matrices live in one storage buffer, the layout does not change with the mesh count
 		VkDescriptorSetLayoutBinding uboModelBinding{
 			.binding = 1,
-			.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
-			.descriptorCount = static_cast<u32>( m_ModelUBOs.size() ),
+			.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+			.descriptorCount = 1,
+			.stageFlags = VK_SHADER_STAGE_VERTEX_BIT,
+			.pImmutableSamplers = nullptr
+		};
+
+		// pull.vert's DrawRecords, one per model
+		VkDescriptorSetLayoutBinding drawRecordBinding{
+			.binding = 2,
+			.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+			.descriptorCount = 1,
 			.stageFlags = VK_SHADER_STAGE_VERTEX_BIT,
 			.pImmutableSamplers = nullptr
 		};
 
-		std::array<VkDescriptorSetLayoutBinding, 2> bindings{ uboCameraBinding , uboModelBinding };
+		std::array<VkDescriptorSetLayoutBinding, 3> bindings{ uboCameraBinding , uboModelBinding, drawRecordBinding };
 
 		VkDescriptorSetLayoutCreateInfo layoutInfo{
 			.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
@@ -283,9 +329,10 @@ namespace Engine {
 			.descriptorCount = static_cast<u32>( MAX_FRAMES_IN_FLIGHT )
 		};
 
+		// Models and draw records
 		VkDescriptorPoolSize ModelsPoolSize{
-			.type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
-			.descriptorCount = static_cast<u32>( MAX_FRAMES_IN_FLIGHT * m_ModelUBOs.size() )
+			.type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+			.descriptorCount = static_cast<u32>( 2 * MAX_FRAMES_IN_FLIGHT )
 		};
 
 		std::array<VkDescriptorPoolSize, 2> poolSizes{ CamPoolSize, ModelsPoolSize };
@@ -339,35 +386,66 @@ namespace Engine {
 				.pTexelBufferView = nullptr
 			};
 
-			std::vector<VkDescriptorBufferInfo> modelBufferInfos( m_ModelUBOs.size() );
-			for ( size_t j = 0; j < m_ModelUBOs.size(); j++ )
-			{
-				modelBufferInfos[j] = VkDescriptorBufferInfo{
-					.buffer = m_ModelUBOs[j]->getBuffer()[i],
-					.offset = 0,
-					.range = m_ModelUBOs[j]->getUBOSize()
-				};
-			}
-
-			VkWriteDescriptorSet descWriteModels{
-				.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
-				.pNext = nullptr,
-				.dstSet = m_DescriptorSets[i],
-				.dstBinding = 1,
-				.dstArrayElement = 0,
-				.descriptorCount = static_cast<u32>( m_ModelUBOs.size() ),
-				.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
-				.pImageInfo = nullptr,
-				.pBufferInfo = modelBufferInfos.data(),
-				.pTexelBufferView = nullptr
-			};
+			vkUpdateDescriptorSets( m_LogicalDevice, 1, &descWriteCamera, 0, nullptr );
 
-			std::array<VkWriteDescriptorSet, 2> descWrites{ descWriteModels, descWriteCamera };
+			writeModelBufferDescriptor( static_cast<u32>( i ) );
 
-			vkUpdateDescriptorSets( m_LogicalDevice, static_cast<u32>( descWrites.size() ), descWrites.data(), 0, nullptr );
+			// Left unwritten without support, main.vert never reads it
+			if ( m_DrawRecords )
+				writeDrawRecordDescriptor( static_cast<u32>( i ) );
 		}
 	}
 
+	//----------------------------------------------------------------------------------
+	void Renderer::writeModelBufferDescriptor( u32 _frame )
+	{
+		VkDescriptorBufferInfo modelBufferInfo{
+			.buffer = m_ModelBuffer->getBuffer( _frame ),
+			.offset = 0,
+			.range = VK_WHOLE_SIZE
+		};
+
+		VkWriteDescriptorSet descWriteModels{
+			.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+			.pNext = nullptr,
+			.dstSet = m_DescriptorSets[_frame],
+			.dstBinding = 1,
+			.dstArrayElement = 0,
+			.descriptorCount = 1,
+			.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+			.pImageInfo = nullptr,
+			.pBufferInfo = &modelBufferInfo,
+			.pTexelBufferView = nullptr
+		};
+
+		vkUpdateDescriptorSets( m_LogicalDevice, 1, &descWriteModels, 0, nullptr );
+	}
+
+	//----------------------------------------------------------------------------------
+	void Renderer::writeDrawRecordDescriptor( u32 _frame )
+	{
+		VkDescriptorBufferInfo recordBufferInfo{
+			.buffer = m_DrawRecords->getRecordBuffer( _frame ),
+			.offset = 0,
+			.range = VK_WHOLE_SIZE
+		};
+
+		VkWriteDescriptorSet descWriteRecords{
+			.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+			.pNext = nullptr,
+			.dstSet = m_DescriptorSets[_frame],
+			.dstBinding = 2,
+			.dstArrayElement = 0,
+			.descriptorCount = 1,
+			.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+			.pImageInfo = nullptr,
+			.pBufferInfo = &recordBufferInfo,
+			.pTexelBufferView = nullptr
+		};
+
+		vkUpdateDescriptorSets( m_LogicalDevice, 1, &descWriteRecords, 0, nullptr );
+	}
+
 	//----------------------------------------------------------------------------------
 	void Renderer::onShaderModification( const std::filesystem::path& _path )
 	{
@@ -376,35 +454,205 @@ namespace Engine {
 		std::filesystem::path outdir{ "./Shaders/Compiled" };
 		std::filesystem::path outfile{ outdir / _path.filename().concat( ".spv" ) };
 
-		if ( RuntimeShaderCompiler::compile( _path, outfile ) )
+		if ( RuntimeShaderCompiler::compile( _path, outfile, m_ShaderProfile ) )
+		{
+			// The baked archive is stale once a source changes, fall back to per-file shaders
+			const bool recompileAll = m_ShaderArchive != nullptr;
+			m_ShaderArchive.reset();
+
+			rebuildGraphicsPipeline( recompileAll );
+		}
+	}
+
+	//----------------------------------------------------------------------------------
+	void Renderer::loadShaderArchive()
+	{
+		auto archive = std::make_unique<ShaderArchive>();
+
+		if ( archive->open( ShaderArchiveFormat::DEFAULT_ARCHIVE_PATH ) )
+		{
+			m_ShaderArchive = std::move( archive );
+		}
+	}
+
+	//----------------------------------------------------------------------------------
+	std::unique_ptr<ShaderModule> Renderer::loadShaderModule( std::string_view _name )
+	{
+		if ( m_ShaderArchive )
+		{
+			auto code = m_ShaderArchive->find( _name, m_ShaderProfile );
+			if ( !code.empty() )
+			{
+				return std::make_unique<Engine::ShaderModule>( code, m_LogicalDevice );
+			}
+
+			std::cerr << "Shader " << _name << " missing from archive, loading from file" << std::endl;
+		}
+
+		std::filesystem::path compiledPath{ "./Shaders/Compiled" };
+		compiledPath /= std::string( _name ) + ".spv";
+
+		return std::make_unique<Engine::ShaderModule>( compiledPath, m_LogicalDevice );
+	}
+
+	//----------------------------------------------------------------------------------
+	void Renderer::setShaderBuildProfile( ShaderBuildProfile _profile )
+	{
+		std::lock_guard<std::mutex> guard( m_mutPipelineAccess );
+
+		if ( _profile == m_ShaderProfile )
+			return;
+
+		m_ShaderProfile = _profile;
+		rebuildGraphicsPipeline( m_ShaderArchive == nullptr );
+	}
+
+	//----------------------------------------------------------------------------------
+	void Renderer::setTransformEncoding( TransformEncoding _encoding )
+	{
+		std::lock_guard<std::mutex> guard( m_mutPipelineAccess );
+
+		// Before init() the buffer and pipeline are simply created with it
+		if ( !m_ModelBuffer )
 		{
-			vkDeviceWaitIdle( m_LogicalDevice );
+			m_TransformEncoding = _encoding;
+			return;
+		}
+
+		m_PendingTransformEncoding = _encoding;
+	}
+
+	//----------------------------------------------------------------------------------
+	void Renderer::applyTransformEncoding()
+	{
+		std::lock_guard<std::mutex> guard( m_mutPipelineAccess );
+
+		if ( !m_PendingTransformEncoding )
+			return;
+
+		const TransformEncoding encoding = *m_PendingTransformEncoding;
+		m_PendingTransformEncoding.reset();
+
+		if ( encoding == m_TransformEncoding )
+			return;
+
+		m_TransformEncoding = encoding;
+
+		// Same SPIR-V, only the specialization constant changes. The rebuild waits for all submitted work,
+		// the buffers are re-encoded by each frame's next flush
+		rebuildGraphicsPipeline( false );
+		m_ModelBuffer->setEncoding( encoding );
+	}
+
+	//----------------------------------------------------------------------------------
+	void Renderer::rebuildGraphicsPipeline( bool _compile )
+	{
+		waitForSubmittedWork();
+
+		if ( m_GraphicsPipeline != VK_NULL_HANDLE )
+			vkDestroyPipeline( m_LogicalDevice, m_GraphicsPipeline, nullptr );
 
-			if ( m_GraphicsPipeline != VK_NULL_HANDLE )
-				vkDestroyPipeline( m_LogicalDevice, m_GraphicsPipeline, nullptr );
+		if ( m_PipelineLayout != VK_NULL_HANDLE )
+			vkDestroyPipelineLayout( m_LogicalDevice, m_PipelineLayout, nullptr );
 
-			if ( m_PipelineLayout != VK_NULL_HANDLE )
-				vkDestroyPipelineLayout( m_LogicalDevice, m_PipelineLayout, nullptr );
+		createGraphicsPipeline( _compile );
 
-			createGraphicsPipeline( false );
+		if ( m_ClusterCuller )
+		{
+			m_ClusterCuller->destroyPipeline();
+			createCullPipeline( _compile );
+		}
+	}
+
+	//----------------------------------------------------------------------------------
+	bool Renderer::isClusterCullingSupported()
+	{
+		VkPhysicalDeviceVulkan12Features features12{};
+		features12.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+
+		VkPhysicalDeviceFeatures2 features{};
+		features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+		features.pNext = &features12;
+
+		vkGetPhysicalDeviceFeatures2( m_PhysicalDevice, &features );
+
+		return features12.drawIndirectCount && features.features.multiDrawIndirect;
+	}
+
+	//----------------------------------------------------------------------------------
+	bool Renderer::isVertexPullingSupported()
+	{
+		VkPhysicalDeviceVulkan12Features features12{};
+		features12.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+
+		VkPhysicalDeviceFeatures2 features{};
+		features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+		features.pNext = &features12;
+
+		vkGetPhysicalDeviceFeatures2( m_PhysicalDevice, &features );
+
+		return features12.bufferDeviceAddress && features.features.multiDrawIndirect && features.features.drawIndirectFirstInstance;
+	}
+
+	//----------------------------------------------------------------------------------
+	void Renderer::setVertexPulling( bool _enabled )
+	{
+		std::lock_guard<std::mutex> guard( m_mutPipelineAccess );
+
+		if ( _enabled == m_VertexPulling )
+			return;
+
+		m_VertexPulling = _enabled;
+
+		// Before init() the pipeline is simply created with it, without support it stays off
+		if ( m_DrawRecords )
+		{
+			rebuildGraphicsPipeline( false );
 		}
 	}
 
 	//----------------------------------------------------------------------------------
 	void Renderer::createGraphicsPipeline( bool _compile )
 	{
-		if ( _compile )
+		const bool pullVertices = isVertexPullingEnabled();
+
+		// Compiled shaders are build output, a fresh checkout has none until the first run compiles them
+		if ( _compile || !std::filesystem::exists( "./Shaders/Compiled/main.vert.spv" ) )
+		{
+			RuntimeShaderCompiler::compile( "./Shaders/main.vert", "./Shaders/Compiled/main.vert.spv", m_ShaderProfile );
+		}
+		if ( _compile || !std::filesystem::exists( "./Shaders/Compiled/main.frag.spv" ) )
+		{
+			RuntimeShaderCompiler::compile( "./Shaders/main.frag", "./Shaders/Compiled/main.frag.spv", m_ShaderProfile );
+		}
+
+		// Archives baked before vertex pulling lack it, loadShaderModule() then falls back to the file
+		if ( pullVertices && ( _compile || !std::filesystem::exists( "./Shaders/Compiled/pull.vert.spv" ) ) )
 		{
-			RuntimeShaderCompiler::compile( "./Shaders/main.vert", "./Shaders/Compiled/main.vert.spv" );
-			RuntimeShaderCompiler::compile( "./Shaders/main.frag", "./Shaders/Compiled/main.frag.spv" );
+			RuntimeShaderCompiler::compile( "./Shaders/pull.vert", "./Shaders/Compiled/pull.vert.spv", m_ShaderProfile );
 		}
 
-		auto pVertShader = std::make_unique<Engine::ShaderModule>( std::filesystem::path( "./Shaders/Compiled/main.vert.spv" ), m_LogicalDevice );
-		auto pFragShader = std::make_unique<Engine::ShaderModule>( std::filesystem::path( "./Shaders/Compiled/main.frag.spv" ), m_LogicalDevice );
+		auto pVertShader = loadShaderModule( pullVertices ? "pull.vert" : "main.vert" );
+		auto pFragShader = loadShaderModule( "main.frag" );
 
 		VkShaderModule vertModule = pVertShader->getShaderModule();
 		VkShaderModule fragModule = pFragShader->getShaderModule();
 
+		// main.vert and pull.vert: constant_id 0 is TRANSFORM_ENCODING, the decode path is resolved when the pipeline is compiled
+		const u32 transformEncoding = static_cast<u32>( m_TransformEncoding );
+		const VkSpecializationMapEntry encodingEntry{
+			.constantID = 0,
+			.offset = 0,
+			.size = sizeof( transformEncoding )
+		};
+
+		const VkSpecializationInfo vertSpecialization{
+			.mapEntryCount = 1,
+			.pMapEntries = &encodingEntry,
+			.dataSize = sizeof( transformEncoding ),
+			.pData = &transformEncoding
+		};
+
 		VkPipelineShaderStageCreateInfo vertCreateInfo{
 			.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
 			.pNext = nullptr,
@@ -412,7 +660,7 @@ namespace Engine {
 			.stage = VK_SHADER_STAGE_VERTEX_BIT,
 			.module = vertModule,
 			.pName = "main",
-			.pSpecializationInfo = nullptr
+			.pSpecializationInfo = &vertSpecialization
 		};
 
 		VkPipelineShaderStageCreateInfo fragCreateInfo{
@@ -437,17 +685,18 @@ namespace Engine {
 			.pDynamicStates = dynamicStates.data()
 		};
 
-		auto bindingDesc = Vertex::getBindingDescrition();
-		auto attributeDesc = Vertex::getAttributesDescription();
+		constexpr VkVertexInputBindingDescription bindingDesc = VertexLayout<Vertex>::binding();
+		constexpr auto attributeDesc = VertexLayout<Vertex>::attributeDescriptions();
 
+		// pull.vert has no vertex inputs
 		VkPipelineVertexInputStateCreateInfo vertInputCreateInfo{
 			.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO,
 			.pNext = nullptr,
 			.flags = 0,
-			.vertexBindingDescriptionCount = 1,
-			.pVertexBindingDescriptions = &bindingDesc,
-			.vertexAttributeDescriptionCount = (u32)attributeDesc.size(),
-			.pVertexAttributeDescriptions = attributeDesc.data()
+			.vertexBindingDescriptionCount = pullVertices ? 0u : 1u,
+			.pVertexBindingDescriptions = pullVertices ? nullptr : &bindingDesc,
+			.vertexAttributeDescriptionCount = pullVertices ? 0u : (u32)attributeDesc.size(),
+			.pVertexAttributeDescriptions = pullVertices ? nullptr : attributeDesc.data()
 		};
 
 		VkPipelineInputAssemblyStateCreateInfo assemblyCreateInfo{
@@ -535,7 +784,7 @@ namespace Engine {
 		VkPushConstantRange pushConstantRange{
 			.stageFlags = VK_SHADER_STAGE_VERTEX_BIT,
 			.offset = 0,
-			.size = sizeof( u32 )
+			.size = sizeof( MeshPushConstants )
 		};
 
 		VkPipelineLayoutCreateInfo pipelineLayoutCreateInfo{
@@ -578,6 +827,22 @@ namespace Engine {
 		pFragShader.reset();
 	}
 
+	//----------------------------------------------------------------------------------
+	void Renderer::createCullPipeline( bool _compile )
+	{
+		if ( !m_ClusterCuller )
+			return;
+
+		// Archives baked before the culling pass lack it, loadShaderModule() then falls back to the file
+		if ( _compile || !std::filesystem::exists( "./Shaders/Compiled/cull.comp.spv" ) )
+		{
+			RuntimeShaderCompiler::compile( "./Shaders/cull.comp", "./Shaders/Compiled/cull.comp.spv", m_ShaderProfile );
+		}
+
+		auto pCullShader = loadShaderModule( "cull.comp" );
+		m_ClusterCuller->createPipeline( pCullShader->getShaderModule(), m_TransformEncoding, isVertexPullingEnabled() );
+	}
+
 	//----------------------------------------------------------------------------------
 	void Renderer::createCommandPool()
 	{
@@ -614,7 +879,6 @@ namespace Engine {
 	{
 		m_ImageAvailableSemaphores.resize( MAX_FRAMES_IN_FLIGHT );
 		m_RenderFinishedSemaphores.resize( MAX_FRAMES_IN_FLIGHT );
-		m_inFlightFences.resize( MAX_FRAMES_IN_FLIGHT );
 
 		for ( size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++ )
 		{
@@ -624,27 +888,107 @@ namespace Engine {
 				.flags = 0
 			};
 
-			VkFenceCreateInfo fenceInfo{
-				.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO,
-				.pNext = nullptr,
-				.flags = VK_FENCE_CREATE_SIGNALED_BIT
-			};
-
 			VK_ASSERT( vkCreateSemaphore( m_LogicalDevice, &semaphoreInfo, nullptr, &m_ImageAvailableSemaphores[i] ) );
 			VK_ASSERT( vkCreateSemaphore( m_LogicalDevice, &semaphoreInfo, nullptr, &m_RenderFinishedSemaphores[i] ) );
-			VK_ASSERT( vkCreateFence( m_LogicalDevice, &fenceInfo, nullptr, &m_inFlightFences[i] ) );
 		}
 	}
 
 	//----------------------------------------------------------------------------------
-	void Renderer::updateDescriptors()
+	void Renderer::waitForSubmittedWork()
 	{
-		vkDestroyDescriptorPool( m_LogicalDevice, m_DescriptorPool, nullptr );
-		vkDestroyDescriptorSetLayout( m_LogicalDevice, m_DescriptorSetLayout, nullptr );
+		// Every submission goes to the graphics queue, reaching its last value is the same as the device going idle
+		const u64 submitted = m_GraphicsTimeline->getSubmittedValue();
+		while ( !m_GraphicsTimeline->wait( submitted, FRAME_WAIT_TIMEOUT_NS ) )
+		{
+			std::cerr << "Still waiting for GPU work " << submitted << ", completed " << m_GraphicsTimeline->getCompletedValue() << std::endl;
+		}
+	}
 
-		createDescriptorSetLayout();
-		createDescriptorPool();
-		createDescriptorSets();
+	//----------------------------------------------------------------------------------
+	UploadContext Renderer::getUploadContext()
+	{
+		// Same queue as the frames, the timeline orders uploads among them
+		return UploadContext{
+			.m_Pool = m_CommandPool,
+			.m_Queue = m_GraphicsQueue,
+			.m_Timeline = *m_GraphicsTimeline,
+			.m_DeletionQueue = m_DeletionQueue
+		};
+	}
+
+	//----------------------------------------------------------------------------------
+	void Renderer::createTimestampQueryPool()
+	{
+		VkPhysicalDeviceProperties props;
+		vkGetPhysicalDeviceProperties( m_PhysicalDevice, &props );
+
+		if ( !props.limits.timestampComputeAndGraphics )
+		{
+			std::cerr << "Timestamp queries not supported, GPU frame timings disabled" << std::endl;
+			return;
+		}
+
+		m_TimestampPeriod = props.limits.timestampPeriod;
+
+		VkQueryPoolCreateInfo queryPoolInfo{
+			.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO,
+			.pNext = nullptr,
+			.flags = 0,
+			.queryType = VK_QUERY_TYPE_TIMESTAMP,
+			.queryCount = 2 * MAX_FRAMES_IN_FLIGHT,
+			.pipelineStatistics = 0
+		};
+
+		VK_ASSERT( vkCreateQueryPool( m_LogicalDevice, &queryPoolInfo, nullptr, &m_TimestampQueryPool ) );
+	}
+
+	//----------------------------------------------------------------------------------
+	void Renderer::readGpuFrameTime()
+	{
+		// Only called once the frame's timeline value is reached, results are guaranteed available
+		if ( m_TimestampQueryPool == VK_NULL_HANDLE || !m_TimestampsWritten[m_CurrentFrame] )
+			return;
+
+		std::array<u64, 2> timestamps{};
+		VkResult res = vkGetQueryPoolResults( m_LogicalDevice, m_TimestampQueryPool, 2 * m_CurrentFrame, 2,
+			sizeof( timestamps ), timestamps.data(), sizeof( u64 ), VK_QUERY_RESULT_64_BIT );
+
+		if ( res == VK_SUCCESS )
+		{
+			m_GpuFrameTimeAccumMs += static_cast<f64>( timestamps[1] - timestamps[0] ) * m_TimestampPeriod * 1e-6;
+			m_GpuFrameCount++;
+		}
+
+		m_TimestampsWritten[m_CurrentFrame] = false;
+	}
+
+	//----------------------------------------------------------------------------------
+	f64 Renderer::getAverageGpuFrameTimeMs() const
+	{
+		return m_GpuFrameCount > 0 ? m_GpuFrameTimeAccumMs / static_cast<f64>( m_GpuFrameCount ) : 0.0;
+	}
+
+	//----------------------------------------------------------------------------------
+	void Renderer::resetGpuFrameTimings()
+	{
+		m_GpuFrameTimeAccumMs = 0.0;
+		m_GpuFrameCount = 0;
+	}
+
+	//----------------------------------------------------------------------------------
+	void Renderer::flushFrameResources()
+	{
+		// The current frame's timeline value has been waited on: its descriptor set and model buffer are free to update.
+		// Deleters retire on the completed value, which may be past the frame's
+		m_DeletionQueue.flush( m_GraphicsTimeline->getCompletedValue() );
+
+		if ( m_ModelBuffer->flush( m_CurrentFrame ) )
+		{
+			writeModelBufferDescriptor( m_CurrentFrame );
+
+			if ( m_ClusterCuller )
+				m_ClusterCuller->invalidateModelBuffer( m_CurrentFrame );
+		}
 	}
 
 	//----------------------------------------------------------------------------------
@@ -661,6 +1005,39 @@ namespace Engine {
 
 		VK_ASSERT( vkBeginCommandBuffer( m_CommandBuffers[m_CurrentFrame], &beginInfo ) );
 
+		if ( m_TimestampQueryPool != VK_NULL_HANDLE )
+		{
+			vkCmdResetQueryPool( m_CommandBuffers[m_CurrentFrame], m_TimestampQueryPool, 2 * m_CurrentFrame, 2 );
+			vkCmdWriteTimestamp( m_CommandBuffers[m_CurrentFrame], VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, m_TimestampQueryPool, 2 * m_CurrentFrame );
+		}
+
+		// Records are written by the draw loop, the descriptor must be current before the set is bound
+		const bool pullVertices = isVertexPullingEnabled();
+		if ( pullVertices && m_DrawRecords->begin( m_CurrentFrame, static_cast<u32>( m_Meshes.size() ) ) )
+		{
+			writeDrawRecordDescriptor( m_CurrentFrame );
+		}
+
+		// Clustered levels go through the culling pass before the render pass, the draw loop takes them in the same order
+		const bool cullClusters = isClusterCullingEnabled();
+		if ( cullClusters )
+		{
+			m_ClusterCuller->clearDraws();
+
+			for ( size_t i = 0; i < m_Meshes.size(); i++ )
+			{
+				const GpuGeometry* pGeometry = m_Meshes[i].m_pGeometry;
+				const Scene::GeometryLod& lod = pGeometry->m_Lods[m_Meshes[i].m_Lod];
+
+				if ( m_Meshes[i].m_Visible && lod.m_ClusterCount > 0 )
+				{
+					m_ClusterCuller->queueDraw( static_cast<u32>( i ), pGeometry->m_FirstCluster + lod.m_FirstCluster, lod.m_ClusterCount );
+				}
+			}
+
+			m_ClusterCuller->recordCulling( m_CommandBuffers[m_CurrentFrame], m_CurrentFrame, m_ModelBuffer->getBuffer( m_CurrentFrame ) );
+		}
+
 		VkClearValue clearColor = { {{0.0f, 0.0f, 0.0f, 1.0f}} };
 		VkRenderPassBeginInfo passInfo{
 			.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO,
@@ -695,20 +1072,77 @@ namespace Engine {
 		vkCmdBindDescriptorSets( m_CommandBuffers[m_CurrentFrame], VK_PIPELINE_BIND_POINT_GRAPHICS, m_PipelineLayout, 0, 1,
 			&m_DescriptorSets[m_CurrentFrame], 0, nullptr );
 
+		const GpuGeometry* pBound = nullptr;
+		u32 culledDraw = 0;
+		m_DrawnTriangles = 0;
 		for ( size_t i = 0; i < m_Meshes.size(); i++ )
 		{
-			std::vector<VkDeviceSize> offsets( m_Meshes.size() );
-			vkCmdBindVertexBuffers( m_CommandBuffers[m_CurrentFrame], 0, 1, &m_VertexBuffers[i], offsets.data() );
-			vkCmdBindIndexBuffer( m_CommandBuffers[m_CurrentFrame], m_IndexBuffers[i], 0, VK_INDEX_TYPE_UINT16 );
+			if ( !m_Meshes[i].m_Visible )
+				continue;
 
-			u32 modelIndex = static_cast<u32>( i );
-			vkCmdPushConstants( m_CommandBuffers[m_CurrentFrame], m_PipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof( u32 ), &modelIndex );
+			const GpuGeometry* pGeometry = m_Meshes[i].m_pGeometry;
+			const Scene::GeometryLod& lod = pGeometry->m_Lods[m_Meshes[i].m_Lod];
+			const u32 modelIndex = static_cast<u32>( i );
 
-			u32 indexCount = static_cast<u32>( m_Meshes[i].getIndices().size() );
-			vkCmdDrawIndexed( m_CommandBuffers[m_CurrentFrame], indexCount, 1, 0, 0, 0 );
+			if ( pullVertices )
+			{
+				// Nothing to bind, the record tells pull.vert where the geometry is
+				m_DrawRecords->setRecord( modelIndex, DrawRecord{
+					.m_Vertices = pGeometry->m_VertexAddress,
+					.m_Indices = pGeometry->m_IndexAddress,
+					.m_IndexSize = static_cast<u32>( VulkanMemory::indexSize( pGeometry->m_IndexType ) ),
+					.m_VertexStride = sizeof( Vertex ) / sizeof( u32 ),
+					.m_Frame = pGeometry->m_Frame
+				} );
+			}
+			else
+			{
+				// Instances of the same asset share buffers, skip redundant rebinds
+				if ( pGeometry != pBound )
+				{
+					VkDeviceSize offset = 0;
+					vkCmdBindVertexBuffers( m_CommandBuffers[m_CurrentFrame], 0, 1, &pGeometry->m_VertexBuffer, &offset );
+					vkCmdBindIndexBuffer( m_CommandBuffers[m_CurrentFrame], pGeometry->m_IndexBuffer, 0, pGeometry->m_IndexType );
+					vkCmdPushConstants( m_CommandBuffers[m_CurrentFrame], m_PipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, offsetof( MeshPushConstants, m_Frame ),
+						sizeof( PositionFrame ), &pGeometry->m_Frame );
+					pBound = pGeometry;
+				}
+
+				vkCmdPushConstants( m_CommandBuffers[m_CurrentFrame], m_PipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, offsetof( MeshPushConstants, m_ModelIndex ),
+					sizeof( u32 ), &modelIndex );
+			}
+
+			if ( cullClusters && lod.m_ClusterCount > 0 )
+			{
+				m_ClusterCuller->recordDraw( m_CommandBuffers[m_CurrentFrame], m_CurrentFrame, culledDraw++ );
+			}
+			else if ( pullVertices )
+			{
+				m_DrawRecords->pushDraw( modelIndex, lod.m_FirstIndex, lod.m_IndexCount );
+			}
+			else
+			{
+				vkCmdDrawIndexed( m_CommandBuffers[m_CurrentFrame], lod.m_IndexCount, 1, lod.m_FirstIndex, 0, 0 );
+			}
+
+			// Before cluster culling
+			m_DrawnTriangles += lod.m_IndexCount / 3;
+		}
+
+		// Every unclustered mesh, whatever its geometry
+		if ( pullVertices )
+		{
+			m_DrawRecords->recordDraws( m_CommandBuffers[m_CurrentFrame] );
 		}
 
 		vkCmdEndRenderPass( m_CommandBuffers[m_CurrentFrame] );
+
+		if ( m_TimestampQueryPool != VK_NULL_HANDLE )
+		{
+			vkCmdWriteTimestamp( m_CommandBuffers[m_CurrentFrame], VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, m_TimestampQueryPool, 2 * m_CurrentFrame + 1 );
+			m_TimestampsWritten[m_CurrentFrame] = true;
+		}
+
 		VK_ASSERT( vkEndCommandBuffer( m_CommandBuffers[m_CurrentFrame] ) );
 	}
 
@@ -816,118 +1250,288 @@ namespace Engine {
 	}
 
 	//----------------------------------------------------------------------------------
-	void Renderer::loadMeshes( std::vector<Scene::Mesh> _meshes )
+	void Renderer::addMesh( Utils::NameId _meshId, const Scene::GeometryAssetRef& _geometry, const Maths::Matrix4& _model )
 	{
-		m_Meshes = _meshes;
+		assert( !m_MeshIdToIdx.contains( _meshId ) && _geometry );
+
+		const size_t idx = m_Meshes.size();
+		m_Meshes.push_back( RenderMesh{
+			.m_MeshId = _meshId,
+			.m_GeometryId = _geometry->getId(),
+			.m_pGeometry = acquireGeometry( _geometry )
+		} );
+
+		[[maybe_unused]] u32 modelIdx = m_ModelBuffer->push( _model );
+		assert( modelIdx == idx );
+
+		m_MeshIdToIdx[_meshId] = idx;
+	}
+
+	//----------------------------------------------------------------------------------
+	void Renderer::removeMesh( Utils::NameId _meshId )
+	{
+		auto it = m_MeshIdToIdx.find( _meshId );
+		if ( it != m_MeshIdToIdx.end() )
+		{
+			const size_t index = it->second;
+			const size_t last = m_Meshes.size() - 1;
+
+			releaseGeometry( m_Meshes[index].m_GeometryId );
+
+			// Swap and pop, draw order does not matter and the model buffer mirrors the move
+			if ( index != last )
+			{
+				m_Meshes[index] = m_Meshes[last];
+				m_MeshIdToIdx[m_Meshes[index].m_MeshId] = index;
+			}
+
+			m_Meshes.pop_back();
+			m_ModelBuffer->remove( static_cast<u32>( index ) );
+
+			m_MeshIdToIdx.erase( it );
+		}
+	}
 
-		size_t numMeshes = m_Meshes.size();
-		m_VertexBuffers.resize( numMeshes );
-		m_IndexBuffers.resize( numMeshes );
-		m_VertexBuffersMemory.resize( numMeshes );
-		m_IndexBuffersMemory.resize( numMeshes );
-		m_ModelUBOs.resize( numMeshes );
+	//----------------------------------------------------------------------------------
+	void Renderer::updateMeshTransform( Utils::NameId _meshId, const Maths::Matrix4& _model )
+	{
+		auto it = m_MeshIdToIdx.find( _meshId );
+		if ( it != m_MeshIdToIdx.end() )
+		{
+			m_ModelBuffer->set( static_cast<u32>( it->second ), _model );
+		}
+	}
 
-		for ( size_t i = 0; i < numMeshes; i++ )
+	//----------------------------------------------------------------------------------
+	void Renderer::updateMeshGeometry( Utils::NameId _meshId, const Scene::GeometryAssetRef& _geometry )
+	{
+		auto it = m_MeshIdToIdx.find( _meshId );
+		if ( it != m_MeshIdToIdx.end() && _geometry )
 		{
-			VulkanMemory::createMeshVertexBuffer( m_LogicalDevice, m_PhysicalDevice, m_Meshes[i], m_VertexBuffers[i],
-				m_VertexBuffersMemory[i], m_CommandPool, m_GraphicsQueue );
-			VulkanMemory::createMeshIndexBuffer( m_LogicalDevice, m_PhysicalDevice, m_Meshes[i], m_IndexBuffers[i],
-				m_IndexBuffersMemory[i], m_CommandPool, m_GraphicsQueue );
+			RenderMesh& mesh = m_Meshes[it->second];
+			if ( mesh.m_GeometryId == _geometry->getId() )
+				return;
+
+			// Acquire first so an asset shared with the old geometry is never dropped in between
+			const GpuGeometry* pGeometry = acquireGeometry( _geometry );
+			releaseGeometry( mesh.m_GeometryId );
+
+			mesh.m_GeometryId = _geometry->getId();
+			mesh.m_pGeometry = pGeometry;
+			// The scene sends the new geometry's level separately
+			mesh.m_Lod = 0;
+		}
+	}
 
-			m_ModelUBOs[i] = std::make_unique<UniformBuffer>( m_LogicalDevice, m_PhysicalDevice, sizeof( ModelUBO ) );
-			updateModelUBOs( i, m_Meshes[i].getModelMat() );
+	//----------------------------------------------------------------------------------
+	void Renderer::updateMeshVisibility( Utils::NameId _meshId, bool _visible )
+	{
+		auto it = m_MeshIdToIdx.find( _meshId );
+		if ( it != m_MeshIdToIdx.end() )
+		{
+			m_Meshes[it->second].m_Visible = _visible;
 		}
+	}
 
-		updateDescriptors();
+	//----------------------------------------------------------------------------------
+	void Renderer::updateMeshLod( Utils::NameId _meshId, u32 _lod )
+	{
+		auto it = m_MeshIdToIdx.find( _meshId );
+		if ( it != m_MeshIdToIdx.end() )
+		{
+			RenderMesh& mesh = m_Meshes[it->second];
+			assert( _lod < mesh.m_pGeometry->m_Lods.size() );
+			mesh.m_Lod = std::min( _lod, static_cast<u32>( mesh.m_pGeometry->m_Lods.size() - 1 ) );
+		}
 	}
 
 	//----------------------------------------------------------------------------------
-	void Renderer::addMesh( Scene::Mesh _mesh )
+	const GpuGeometry* Renderer::acquireGeometry( const Scene::GeometryAssetRef& _geometry )
 	{
-		m_Meshes.push_back( _mesh );
-		size_t idx = m_Meshes.size() - 1;
+		if ( auto asset = m_AssetGeometries.find( _geometry->getId() ); asset != m_AssetGeometries.end() )
+		{
+			asset->second->m_RefCount++;
+			return asset->second;
+		}
 
-		m_VertexBuffers.resize( idx + 1 );
-		m_IndexBuffers.resize( idx + 1 );
-		m_VertexBuffersMemory.resize( idx + 1 );
-		m_IndexBuffersMemory.resize( idx + 1 );
-		m_ModelUBOs.resize( idx + 1 );
+		// A released asset can't be uploaded again, keep its CPU data if it may come back
+		assert( _geometry->hasCpuData() || _geometry->hasWriter() );
+
+		// Byte-identical assets, like procedurally duplicated ones, share one allocation. The key alone is not trusted:
+		// on a collision the second hash or the counts differ, and the content gets its own entry under the same key
+		const Scene::GeometryHash& contentHash = _geometry->getContentHash();
+		auto [first, last] = m_Geometries.equal_range( contentHash.m_Key );
+		auto it = std::find_if( first, last, [&]( const auto& _entry ) {
+			const GpuGeometry& candidate = _entry.second;
+			return candidate.m_Hash == contentHash && candidate.m_VertexCount == _geometry->getVertexCount() && candidate.m_IndexCount == _geometry->getIndexCount();
+		} );
+
+		const bool inserted = it == last;
+		if ( inserted )
+		{
+			it = m_Geometries.emplace( contentHash.m_Key, GpuGeometry{} );
+		}
+
+		GpuGeometry& gpuGeometry = it->second;
+		gpuGeometry.m_RefCount++;
+		gpuGeometry.m_AssetIds.push_back( _geometry->getId() );
+		m_AssetGeometries.emplace( _geometry->getId(), &gpuGeometry );
+
+		if ( inserted )
+		{
+			gpuGeometry.m_IndexType = VulkanMemory::selectIndexType( _geometry->getVertexCount() );
+			m_UploadValue = VulkanMemory::createMeshBuffers( m_LogicalDevice, m_PhysicalDevice, _geometry->getVertexCount(), _geometry->getIndexCount(), gpuGeometry.m_IndexType,
+				[&_geometry]( std::span<Vertex> _vertices, std::span<u32> _indices ) { _geometry->write( _vertices, _indices ); },
+				gpuGeometry.m_VertexBuffer, gpuGeometry.m_VertexMemory, gpuGeometry.m_IndexBuffer, gpuGeometry.m_IndexMemory, getUploadContext(), m_DrawRecords != nullptr );
+			gpuGeometry.m_VertexCount = _geometry->getVertexCount();
+			gpuGeometry.m_IndexCount = _geometry->getIndexCount();
+			gpuGeometry.m_Hash = contentHash;
+			gpuGeometry.m_Frame = _geometry->getPositionFrame();
+
+			// Whenever supported, so switching to vertex pulling needs no upload
+			if ( m_DrawRecords )
+			{
+				gpuGeometry.m_VertexAddress = VulkanMemory::getBufferAddress( m_LogicalDevice, gpuGeometry.m_VertexBuffer );
+				gpuGeometry.m_IndexAddress = VulkanMemory::getBufferAddress( m_LogicalDevice, gpuGeometry.m_IndexBuffer );
+			}
+			gpuGeometry.m_Lods.assign( _geometry->getLods().begin(), _geometry->getLods().end() );
 
-		VulkanMemory::createMeshVertexBuffer( m_LogicalDevice, m_PhysicalDevice, m_Meshes[idx], m_VertexBuffers[idx],
-			m_VertexBuffersMemory[idx], m_CommandPool, m_GraphicsQueue );
-		VulkanMemory::createMeshIndexBuffer( m_LogicalDevice, m_PhysicalDevice, m_Meshes[idx], m_IndexBuffers[idx],
-			m_IndexBuffersMemory[idx], m_CommandPool, m_GraphicsQueue );
+			if ( m_ClusterCuller && !_geometry->getClusters().empty() )
+			{
+				gpuGeometry.m_FirstCluster = m_ClusterCuller->addClusters( _geometry->getClusters() );
+				gpuGeometry.m_ClusterCount = static_cast<u32>( _geometry->getClusters().size() );
+			}
+		}
 
-		m_ModelUBOs[idx] = std::make_unique<UniformBuffer>( m_LogicalDevice, m_PhysicalDevice, sizeof( ModelUBO ) );
-		updateModelUBOs( idx, m_Meshes[idx].getModelMat() );
+		// write() has filled staging memory or an identical copy is resident, the CPU data is no longer read. The GPU copy
+		// itself may still be in flight: frames wait on m_UploadValue, nothing here does
+		if ( _geometry->getCpuDataPolicy() == Scene::CpuDataPolicy::RELEASE_AFTER_UPLOAD )
+		{
+			_geometry->releaseCpuData();
+		}
 
-		updateDescriptors();
+		return &gpuGeometry;
 	}
 
 	//----------------------------------------------------------------------------------
-	void Renderer::removeMesh( Scene::Mesh& _mesh )
+	void Renderer::releaseGeometry( u64 _geometryId )
 	{
-		auto it = std::ranges::find( m_Meshes, _mesh );
-		if ( it != m_Meshes.end() )
-		{
-			auto index = (size_t)std::distance( m_Meshes.begin(), it );
+		auto asset = m_AssetGeometries.find( _geometryId );
+		assert( asset != m_AssetGeometries.end() && asset->second->m_RefCount > 0 );
+		if ( asset == m_AssetGeometries.end() )
+			return;
 
-			vkFreeMemory( m_LogicalDevice, m_VertexBuffersMemory[index], nullptr );
-			vkDestroyBuffer( m_LogicalDevice, m_VertexBuffers[index], nullptr );
-			vkFreeMemory( m_LogicalDevice, m_IndexBuffersMemory[index], nullptr );
-			vkDestroyBuffer( m_LogicalDevice, m_IndexBuffers[index], nullptr );
+		// Only this entry leaves its key, others that collided with it stay reachable
+		auto [first, last] = m_Geometries.equal_range( asset->second->m_Hash.m_Key );
+		auto it = std::find_if( first, last, [pGeometry = asset->second]( const auto& _entry ) { return &_entry.second == pGeometry; } );
+		assert( it != last );
 
-			m_Meshes.erase( m_Meshes.begin() + index );
-			m_VertexBuffers.erase( m_VertexBuffers.begin() + index );
-			m_VertexBuffersMemory.erase( m_VertexBuffersMemory.begin() + index );
-			m_IndexBuffers.erase( m_IndexBuffers.begin() + index );
-			m_IndexBuffersMemory.erase( m_IndexBuffersMemory.begin() + index );
+		if ( it == last || --it->second.m_RefCount > 0 )
+			return;
 
-			m_ModelUBOs.erase( m_ModelUBOs.begin() + index );
+		// Frames already submitted may reference the buffers, the next ones won't
+		m_DeletionQueue.push( [device = m_LogicalDevice, gpuGeometry = it->second]()
+			{
+				vkDestroyBuffer( device, gpuGeometry.m_VertexBuffer, nullptr );
+				vkFreeMemory( device, gpuGeometry.m_VertexMemory, nullptr );
+				vkDestroyBuffer( device, gpuGeometry.m_IndexBuffer, nullptr );
+				vkFreeMemory( device, gpuGeometry.m_IndexMemory, nullptr );
+			}, m_GraphicsTimeline->getSubmittedValue() );
+
+		// The culler's per-frame tables are copies, in-flight frames keep the old one
+		if ( it->second.m_ClusterCount > 0 )
+		{
+			const u32 first = it->second.m_FirstCluster;
+			const u32 count = it->second.m_ClusterCount;
+			m_ClusterCuller->removeClusters( first, count );
+
+			for ( auto& [id, gpuGeometry] : m_Geometries )
+			{
+				if ( gpuGeometry.m_ClusterCount > 0 && gpuGeometry.m_FirstCluster > first )
+					gpuGeometry.m_FirstCluster -= count;
+			}
 		}
 
-		updateDescriptors();
+		for ( u64 assetId : it->second.m_AssetIds )
+		{
+			m_AssetGeometries.erase( assetId );
+		}
+		m_Geometries.erase( it );
 	}
 
 	//----------------------------------------------------------------------------------
 	void Renderer::drawFrames()
 	{
-		vkWaitForFences( m_LogicalDevice, 1, &m_inFlightFences[m_CurrentFrame], VK_TRUE, UINT64_MAX );
+		applyTransformEncoding();
+
+		// Bounded so a stalled GPU surfaces here instead of hanging the caller's loop, the frame is simply retried on the next call
+		if ( !m_GraphicsTimeline->wait( m_FrameValues[m_CurrentFrame], FRAME_WAIT_TIMEOUT_NS ) )
+		{
+			std::cerr << "Frame slot " << m_CurrentFrame << " still in flight after " << FRAME_WAIT_TIMEOUT_NS / 1'000'000 << " ms, skipping" << std::endl;
+			return;
+		}
+
+		readGpuFrameTime();
+		flushFrameResources();
 
 		u32 imageIndex;
 
-		VkResult res = vkAcquireNextImageKHR( m_LogicalDevice, m_Swapchain->m_VkSwapChain, UINT64_MAX, m_ImageAvailableSemaphores[m_CurrentFrame], VK_NULL_HANDLE, &imageIndex );
+		VkResult res = vkAcquireNextImageKHR( m_LogicalDevice, m_Swapchain->m_VkSwapChain, FRAME_WAIT_TIMEOUT_NS, m_ImageAvailableSemaphores[m_CurrentFrame], VK_NULL_HANDLE, &imageIndex );
 
-		if ( m_Swapchain->m_BufferResized || res == VK_ERROR_OUT_OF_DATE_KHR )
+		// No image was acquired and the semaphore stays unsignaled
+		if ( res == VK_TIMEOUT || res == VK_NOT_READY )
 		{
-			m_Swapchain->m_BufferResized = false;
-			createSyncObjects();
-			m_Swapchain->recreateSwapChain();
+			std::cerr << "No swapchain image available after " << FRAME_WAIT_TIMEOUT_NS / 1'000'000 << " ms, skipping" << std::endl;
 			return;
 		}
 
-		vkResetFences( m_LogicalDevice, 1, &m_inFlightFences[m_CurrentFrame] );
+		// Nothing acquired either. A pending resize is handled after present instead, so an acquired image
+		// is never abandoned with its semaphore signaled
+		if ( res == VK_ERROR_OUT_OF_DATE_KHR )
+		{
+			m_Swapchain->m_BufferResized = false;
+			recreateSwapChain();
+			return;
+		}
 
 		vkResetCommandBuffer( m_CommandBuffers[m_CurrentFrame], 0 );
 		recordCommandBuffer( imageIndex );
 
-		std::array<VkSemaphore, 1> waitSemaphores{ m_ImageAvailableSemaphores[m_CurrentFrame] };
-		std::array<VkSemaphore, 1> signalSemaphores{ m_RenderFinishedSemaphores[m_CurrentFrame] };
-		std::array<VkPipelineStageFlags, 1> waitStages{ VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT };
+		// Uploads are not waited on by the host, the frame's vertex reads wait on the last one instead
+		std::array<VkSemaphore, 2> waitSemaphores{ m_ImageAvailableSemaphores[m_CurrentFrame], m_GraphicsTimeline->getSemaphore() };
+		std::array<u64, 2> waitValues{ 0, m_UploadValue };
+		std::array<VkPipelineStageFlags, 2> waitStages{ VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_PIPELINE_STAGE_VERTEX_INPUT_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT };
+
+		// The binary semaphore for present, the timeline for everyone else
+		const u64 frameValue = m_GraphicsTimeline->nextSignalValue();
+		std::array<VkSemaphore, 2> signalSemaphores{ m_RenderFinishedSemaphores[m_CurrentFrame], m_GraphicsTimeline->getSemaphore() };
+		std::array<u64, 2> signalValues{ 0, frameValue };
+
+		// Values of binary semaphores are ignored
+		const VkTimelineSemaphoreSubmitInfo timelineInfo{
+			.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO,
+			.pNext = nullptr,
+			.waitSemaphoreValueCount = static_cast<u32>( waitValues.size() ),
+			.pWaitSemaphoreValues = waitValues.data(),
+			.signalSemaphoreValueCount = static_cast<u32>( signalValues.size() ),
+			.pSignalSemaphoreValues = signalValues.data()
+		};
 
 		VkSubmitInfo submitInfo{
 			.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
-			.pNext = nullptr,
-			.waitSemaphoreCount = 1,
+			.pNext = &timelineInfo,
+			.waitSemaphoreCount = static_cast<u32>( waitSemaphores.size() ),
 			.pWaitSemaphores = waitSemaphores.data(),
 			.pWaitDstStageMask = waitStages.data(),
 			.commandBufferCount = 1,
 			.pCommandBuffers = &m_CommandBuffers[m_CurrentFrame],
-			.signalSemaphoreCount = 1,
+			.signalSemaphoreCount = static_cast<u32>( signalSemaphores.size() ),
 			.pSignalSemaphores = signalSemaphores.data()
 		};
 
-		VK_ASSERT( vkQueueSubmit( m_GraphicsQueue, 1, &submitInfo, m_inFlightFences[m_CurrentFrame] ) );
+		VK_ASSERT( vkQueueSubmit( m_GraphicsQueue, 1, &submitInfo, VK_NULL_HANDLE ) );
+		m_FrameValues[m_CurrentFrame] = frameValue;
+		m_LastFrameValue = frameValue;
 
 		std::array<VkSwapchainKHR, 1> swapChains{ m_Swapchain->m_VkSwapChain };
 		VkPresentInfoKHR presentInfo{
@@ -941,9 +1545,25 @@ namespace Engine {
 			.pResults = nullptr
 		};
 
-		vkQueuePresentKHR( m_PresentQueue, &presentInfo );
+		const VkResult presentRes = vkQueuePresentKHR( m_PresentQueue, &presentInfo );
 
 		m_CurrentFrame = ( m_CurrentFrame + 1 ) % MAX_FRAMES_IN_FLIGHT;
+
+		if ( m_Swapchain->m_BufferResized.exchange( false ) || presentRes == VK_ERROR_OUT_OF_DATE_KHR || presentRes == VK_SUBOPTIMAL_KHR )
+		{
+			recreateSwapChain();
+		}
+	}
+
+	//----------------------------------------------------------------------------------
+	void Renderer::recreateSwapChain()
+	{
+		// Frames in flight keep rendering to the old images, they're destroyed once the last submission using them completes
+		if ( !m_Swapchain->recreateSwapChain( m_DeletionQueue, m_GraphicsTimeline->getSubmittedValue() ) )
+		{
+			// Minimized, retried on the next frame
+			m_Swapchain->m_BufferResized = true;
+		}
 	}
 
 	//----------------------------------------------------------------------------------
@@ -961,39 +1581,23 @@ namespace Engine {
 		{
 			m_CameraUBO->update( static_cast<u32>( i ), &camera, sizeof( CameraUBO ) );
 		}
-	}
 
-	//----------------------------------------------------------------------------------
-	void Renderer::updateModelUBOs( size_t _pos, Maths::Matrix4 _model )
-	{
-		ModelUBO model{
-			.m_Model = _model
-		};
-		for ( size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++ )
-		{
-			m_ModelUBOs[_pos]->update( static_cast<u32>( i ), &model, sizeof( ModelUBO ) );
-		}
+		if ( m_ClusterCuller )
+			m_ClusterCuller->setCamera( proj * _view );
 	}
 
 	//----------------------------------------------------------------------------------
 	void Renderer::destroyBuffersFreeMemory()
 	{
-		for ( size_t i = 0; i < m_VertexBuffers.size(); i++ )
-		{
-			vkDestroyBuffer( m_LogicalDevice, m_VertexBuffers[i], nullptr );
-		}
-		for ( size_t i = 0; i < m_VertexBuffersMemory.size(); i++ )
-		{
-			vkFreeMemory( m_LogicalDevice, m_VertexBuffersMemory[i], nullptr );
-		}
-		for ( size_t i = 0; i < m_IndexBuffers.size(); i++ )
-		{
-			vkDestroyBuffer( m_LogicalDevice, m_IndexBuffers[i], nullptr );
-		}
-		for ( size_t i = 0; i < m_IndexBuffersMemory.size(); i++ )
+		for ( auto& [id, gpuGeometry] : m_Geometries )
 		{
-			vkFreeMemory( m_LogicalDevice, m_IndexBuffersMemory[i], nullptr );
+			vkDestroyBuffer( m_LogicalDevice, gpuGeometry.m_VertexBuffer, nullptr );
+			vkFreeMemory( m_LogicalDevice, gpuGeometry.m_VertexMemory, nullptr );
+			vkDestroyBuffer( m_LogicalDevice, gpuGeometry.m_IndexBuffer, nullptr );
+			vkFreeMemory( m_LogicalDevice, gpuGeometry.m_IndexMemory, nullptr );
 		}
+		m_Geometries.clear();
+		m_AssetGeometries.clear();
 	}
 
 	//----------------------------------------------------------------------------------
@@ -2,17 +2,30 @@
 
 #include <optional>
 #include <mutex>
+#include <unordered_map>
 
 #include "../Utils/Common.h"
 #include "../Utils/FileWatcher.h"
-#include "../Scene/Mesh.h"
+#include "../Scene/GeometryAsset.h"
+#include "../Utils/StringInterner.h"
+#include "../Maths/Matrix4.h"
 
 #include "vulkan/vulkan.h"
 #include "SwapChain.h"
 #include "GLFW/glfw3.h"
 #include "Debug.h"
 #include "UniformBuffer.h"
+#include "ModelMatrixBuffer.h"
+#include "TransformEncoding.h"
+#include "DeletionQueue.h"
+#include "TimelineSemaphore.h"
+#include "VulkanMemory.h"
 #include "VulkanConstants.h"
+#include "RuntimeShaderCompiler.h"
+#include "ShaderArchive.h"
+#include "ShaderModule.h"
+#include "ClusterCuller.h"
+#include "DrawRecordBuffer.h"
 
 namespace Engine {
 
@@ -31,6 +44,52 @@ namespace Engine {
 		bool verifyGraphics() { return m_Graphics.has_value() && m_Present.has_value(); }
 	};
 
+	// GPU copy of a geometry asset's content, shared by every mesh drawing it or any byte-identical asset
+	struct GpuGeometry {
+		VkBuffer m_VertexBuffer{ VK_NULL_HANDLE };
+		VkDeviceMemory m_VertexMemory{ VK_NULL_HANDLE };
+		VkBuffer m_IndexBuffer{ VK_NULL_HANDLE };
+		VkDeviceMemory m_IndexMemory{ VK_NULL_HANDLE };
+		u32 m_VertexCount{ 0 };
+		// Every level of detail
+		u32 m_IndexCount{ 0 };
+		// Of the content, m_Check is compared with the counts whenever a key matches
+		Scene::GeometryHash m_Hash;
+		// 16-bit whenever the vertex count allows it
+		VkIndexType m_IndexType{ VK_INDEX_TYPE_UINT32 };
+		// Of the stored positions, passed to the vertex shaders with every draw
+		PositionFrame m_Frame;
+		// Index ranges of the asset's levels of detail, all in m_IndexBuffer
+		std::vector<Scene::GeometryLod> m_Lods;
+		// Range of the asset's clusters in the ClusterCuller table, the levels' cluster ranges are relative to it
+		u32 m_FirstCluster{ 0 };
+		u32 m_ClusterCount{ 0 };
+		// For vertex pulling, zero without device support
+		VkDeviceAddress m_VertexAddress{ 0 };
+		VkDeviceAddress m_IndexAddress{ 0 };
+		// Meshes drawing it, whichever asset they came from
+		u32 m_RefCount{ 0 };
+		// Assets resolved to this content, forgotten along with it
+		std::vector<u64> m_AssetIds;
+	};
+
+	// main.vert's push constants: the frame changes along with the bound geometry, the model index with every draw
+	struct MeshPushConstants {
+		PositionFrame m_Frame;
+		u32 m_ModelIndex;
+	};
+
+	// Per instance the renderer only keeps an id, the geometry it draws and its slot in the model buffer (same index)
+	struct RenderMesh {
+		Utils::NameId m_MeshId;
+		u64 m_GeometryId;
+		// Node addresses in m_Geometries are stable
+		const GpuGeometry* m_pGeometry;
+		bool m_Visible{ true };
+		// Into m_pGeometry->m_Lods
+		u32 m_Lod{ 0 };
+	};
+
 	class Renderer final
 	{
 	public:
@@ -44,14 +103,48 @@ namespace Engine {
 		Renderer& operator=( Renderer&& ) = delete;
 
 		bool checkValidationSupport();
-		void loadMeshes( std::vector<Scene::Mesh> _meshes );
-		void addMesh( Scene::Mesh _mesh );
-		void removeMesh( Scene::Mesh& _mesh );
+
+		// Incremental mesh updates, applied by the scene from its change journal
+		void addMesh( Utils::NameId _meshId, const Scene::GeometryAssetRef& _geometry, const Maths::Matrix4& _model );
+		void removeMesh( Utils::NameId _meshId );
+		void updateMeshTransform( Utils::NameId _meshId, const Maths::Matrix4& _model );
+		void updateMeshGeometry( Utils::NameId _meshId, const Scene::GeometryAssetRef& _geometry );
+		void updateMeshVisibility( Utils::NameId _meshId, bool _visible );
+		void updateMeshLod( Utils::NameId _meshId, u32 _lod );
 
 		void drawFrames();
 
 		void updateCameraUBO( Maths::Matrix4 _view, f32 _fov, f32 _near, f32 _far );
-		void updateModelUBOs( size_t _pos, Maths::Matrix4 _model );
+
+		void setShaderBuildProfile( ShaderBuildProfile _profile );
+		ShaderBuildProfile getShaderBuildProfile() const { return m_ShaderProfile; };
+
+		// Layout of the per-object transforms on the GPU, may be set before init(). Any thread: after init() it
+		// takes effect at the start of the next drawFrames(), the getter returns the encoding frames are drawn with
+		void setTransformEncoding( TransformEncoding _encoding );
+		TransformEncoding getTransformEncoding() const { return m_TransformEncoding; };
+
+		// GPU time of the recorded frames, measured with timestamp queries
+		f64 getAverageGpuFrameTimeMs() const;
+		void resetGpuFrameTimings();
+
+		// Recorded into the last command buffer, follows the levels of detail the scene picked.
+		// Counted before cluster culling, the GPU decides how many of them are drawn
+		u64 getDrawnTriangleCount() const { return m_DrawnTriangles; };
+
+		// Per-cluster frustum and backface culling on the GPU, needs drawIndirectCount. Clustered levels are drawn whole when off
+		void setClusterCulling( bool _enabled ) { m_ClusterCullingEnabled = _enabled; };
+		bool isClusterCullingEnabled() const { return m_ClusterCuller != nullptr && m_ClusterCullingEnabled; };
+
+		// pull.vert fetches indices and vertices through buffer device addresses instead of the input assembler,
+		// so every unclustered mesh goes into one indirect draw without binding buffers. Needs bufferDeviceAddress, may be set before init()
+		void setVertexPulling( bool _enabled );
+		bool isVertexPullingEnabled() const { return m_DrawRecords != nullptr && m_VertexPulling; };
+
+		// Signaled by every graphics queue submission, frames and uploads alike. Other subsystems may poll or wait on it
+		const TimelineSemaphore& getGraphicsTimeline() const { return *m_GraphicsTimeline; };
+		// Reached once the last submitted frame has completed on the GPU
+		u64 getLastFrameValue() const { return m_LastFrameValue; };
 
 		void init( GLFWwindow* _pWindow );
 
@@ -64,17 +157,36 @@ namespace Engine {
 		void createDescriptorPool();
 		void createDescriptorSets();
 		void createGraphicsPipeline( bool _compile );
+		void createCullPipeline( bool _compile );
 		void createCommandPool();
 		void createCommandBuffers();
+		// Once per device, reused across swapchain recreations
 		void createSyncObjects();
-
-		void updateDescriptors();
+		void recreateSwapChain();
+		UploadContext getUploadContext();
+		// Replaces vkDeviceWaitIdle, reports every timeout instead of blocking silently
+		void waitForSubmittedWork();
+		void createTimestampQueryPool();
+
+		void writeModelBufferDescriptor( u32 _frame );
+		void writeDrawRecordDescriptor( u32 _frame );
+		const GpuGeometry* acquireGeometry( const Scene::GeometryAssetRef& _geometry );
+		void releaseGeometry( u64 _geometryId );
+		void rebuildGraphicsPipeline( bool _compile );
+		bool isClusterCullingSupported();
+		bool isVertexPullingSupported();
+		void loadShaderArchive();
+		std::unique_ptr<ShaderModule> loadShaderModule( std::string_view _name );
+		void readGpuFrameTime();
 
 		void recordCommandBuffer( u32 _imageIndex );
 
 		void onShaderModification( const std::filesystem::path& _path );
 
 		void destroyBuffersFreeMemory();
+		// Render thread, between frames, so the model buffer is never flushed with one encoding and drawn with another
+		void applyTransformEncoding();
+		void flushFrameResources();
 
 		QueueFamilyIndices findQueueFamilies();
 
@@ -106,9 +218,16 @@ namespace Engine {
 		VkCommandPool m_CommandPool;
 		std::vector<VkCommandBuffer> m_CommandBuffers;
 
+		// Binary, acquire and present only take those
 		std::vector<VkSemaphore> m_ImageAvailableSemaphores;
 		std::vector<VkSemaphore> m_RenderFinishedSemaphores;
-		std::vector<VkFence> m_inFlightFences;
+
+		std::unique_ptr<TimelineSemaphore> m_GraphicsTimeline;
+		// Value signaled by each frame slot's last submission, reached once its command buffer and per-frame buffers are free again
+		std::array<u64, MAX_FRAMES_IN_FLIGHT> m_FrameValues{};
+		u64 m_LastFrameValue{ 0 };
+		// Of the last upload, frames wait on it before reading vertices
+		u64 m_UploadValue{ 0 };
 
 		u32 m_CurrentFrame{ 0 };
 
@@ -116,15 +235,37 @@ namespace Engine {
 
 		std::mutex m_mutPipelineAccess;
 
-		std::vector<Scene::Mesh> m_Meshes;
+		ShaderBuildProfile m_ShaderProfile{ DEFAULT_SHADER_PROFILE };
+		TransformEncoding m_TransformEncoding{ TransformEncoding::MATRIX_4X4 };
+		// Requested by setTransformEncoding() after init(), guarded by m_mutPipelineAccess
+		std::optional<TransformEncoding> m_PendingTransformEncoding;
+		std::unique_ptr<ShaderArchive> m_ShaderArchive;
+
+		// Two timestamps per frame in flight, top and bottom of the command buffer
+		VkQueryPool m_TimestampQueryPool{ VK_NULL_HANDLE };
+		std::array<bool, MAX_FRAMES_IN_FLIGHT> m_TimestampsWritten{};
+		f32 m_TimestampPeriod{ 0.0f };
+		f64 m_GpuFrameTimeAccumMs{ 0.0 };
+		u64 m_GpuFrameCount{ 0 };
+		u64 m_DrawnTriangles{ 0 };
 
-		std::vector<VkBuffer> m_VertexBuffers;
-		std::vector<VkDeviceMemory> m_VertexBuffersMemory;
+		std::vector<RenderMesh> m_Meshes;
+		std::unordered_map<Utils::NameId, size_t> m_MeshIdToIdx;
 
-		std::vector<VkBuffer> m_IndexBuffers;
-		std::vector<VkDeviceMemory> m_IndexBuffersMemory;
+		// Keyed by GeometryHash::m_Key, colliding contents share the key and are told apart by their check, refcounted by the meshes using them
+		std::unordered_multimap<u64, GpuGeometry> m_Geometries;
+		// GeometryAsset id to its entry in m_Geometries, so each asset is looked up once
+		std::unordered_map<u64, GpuGeometry*> m_AssetGeometries;
 
 		std::unique_ptr<UniformBuffer> m_CameraUBO;
-		std::vector<std::unique_ptr<UniformBuffer>> m_ModelUBOs;
+		std::unique_ptr<ModelMatrixBuffer> m_ModelBuffer;
+		// Only created when the device supports it
+		std::unique_ptr<ClusterCuller> m_ClusterCuller;
+		bool m_ClusterCullingEnabled{ true };
+		// Only created when the device supports vertex pulling
+		std::unique_ptr<DrawRecordBuffer> m_DrawRecords;
+		bool m_VertexPulling{ false };
+
+		DeletionQueue m_DeletionQueue;
 	};
 } // End Namespace Engine
\ No newline at end of file
@@ -3,25 +3,30 @@
 #include <iostream>
 #include <sstream>
 #include <cassert>
+#include <cstring>
+#include <array>
+#include <algorithm>
 
 #include <vulkan/vulkan.h>
 
 #include <shaderc/shaderc.h>
+#include <spirv-tools/optimizer.hpp>
 #include "glslang/Include/glslang_c_interface.h"
 #include "glslang/Public/resource_limits_c.h"
 
 namespace Engine {
 	//--------------------------------------------------------------------
-	bool RuntimeShaderCompiler::compile( std::filesystem::path _source, std::filesystem::path _dest )
+	bool RuntimeShaderCompiler::compile( std::filesystem::path _source, std::filesystem::path _dest, ShaderBuildProfile _profile /*= DEFAULT_SHADER_PROFILE*/ )
 	{
-		std::string source = _source.string();
 		std::string dest = _dest.string();
-
-		std::string sourceShader = readShaderFile( source );
 		std::vector<uint8_t> spirv;
 
-		if ( _compile( vkShaderStageFromFile( source ), sourceShader.c_str(), &spirv, glslang_default_resource() ) )
+		if ( compileToMemory( _source, _profile, &spirv ) )
 		{
+			// The output directory is not part of the repository
+			std::error_code error;
+			std::filesystem::create_directories( _dest.parent_path(), error );
+
 			saveSPRIVBin( dest, spirv.data(), spirv.size() );
 			return true;
 		}
@@ -29,6 +34,40 @@ namespace Engine {
 		return false;
 	}
 
+	//--------------------------------------------------------------------
+	bool RuntimeShaderCompiler::compileToMemory( std::filesystem::path _source, ShaderBuildProfile _profile, std::vector<uint8_t>* _outSPIRV )
+	{
+		std::string source = _source.string();
+		std::string sourceShader = readShaderFile( source );
+
+		return _compile( vkShaderStageFromFile( source ), sourceShader.c_str(), _outSPIRV, glslang_default_resource(), _profile );
+	}
+
+	//--------------------------------------------------------------------
+	bool RuntimeShaderCompiler::isShaderSource( const std::filesystem::path& _path )
+	{
+		constexpr std::array<std::string_view, 6> extensions{ ".vert", ".frag", ".geom", ".comp", ".tesc", ".tese" };
+
+		const std::string ext = _path.extension().string();
+		return std::ranges::find( extensions, ext ) != extensions.end();
+	}
+
+	//--------------------------------------------------------------------
+	const char* RuntimeShaderCompiler::profileName( ShaderBuildProfile _profile )
+	{
+		switch ( _profile )
+		{
+		case ShaderBuildProfile::DEBUG:
+			return "Debug";
+		case ShaderBuildProfile::RELEASE:
+			return "Release";
+		default:
+			break;
+		}
+
+		return "Unknown";
+	}
+
 	//--------------------------------------------------------------------
 	std::string RuntimeShaderCompiler::readShaderFile( std::string_view _filename )
 	{
@@ -149,7 +188,7 @@ namespace Engine {
 	}
 
 	//--------------------------------------------------------------------
-	bool RuntimeShaderCompiler::_compile( VkShaderStageFlagBits _stage, const char* _code, std::vector<uint8_t>* _outSPIRV, const glslang_resource_t* _glslLangResource )
+	bool RuntimeShaderCompiler::_compile( VkShaderStageFlagBits _stage, const char* _code, std::vector<uint8_t>* _outSPIRV, const glslang_resource_t* _glslLangResource, ShaderBuildProfile _profile )
 	{
 		if ( !glslang_initialize_process() ) {
 			std::cerr << "Failed to initialize glslang process" << std::endl;
@@ -200,11 +239,14 @@ namespace Engine {
 			return false;
 		}
 
+		const bool release = _profile == ShaderBuildProfile::RELEASE;
+
+		// glslang's built-in optimizer is always skipped, release builds go through the full spirv-opt pipeline below
 		glslang_spv_options_t options = {
-			.generate_debug_info = true,
-			.strip_debug_info = false,
-			.disable_optimizer = false,
-			.optimize_size = true,
+			.generate_debug_info = !release,
+			.strip_debug_info = release,
+			.disable_optimizer = true,
+			.optimize_size = false,
 			.disassemble = false,
 			.validate = true,
 			.emit_nonsemantic_shader_debug_info = false,
@@ -232,6 +274,44 @@ namespace Engine {
 
 		glslang_finalize_process();
 
+		if ( release )
+		{
+			return optimizeSPIRV( _outSPIRV );
+		}
+
+		return true;
+	}
+
+	//--------------------------------------------------------------------
+	bool RuntimeShaderCompiler::optimizeSPIRV( std::vector<uint8_t>* _spirv )
+	{
+		assert( _spirv->size() % sizeof( uint32_t ) == 0 );
+
+		std::vector<uint32_t> words( _spirv->size() / sizeof( uint32_t ) );
+		memcpy( words.data(), _spirv->data(), _spirv->size() );
+
+		spvtools::Optimizer optimizer( SPV_ENV_VULKAN_1_3 );
+		optimizer.SetMessageConsumer( []( spv_message_level_t _level, const char*, const spv_position_t& _pos, const char* _msg )
+			{
+				if ( _level <= SPV_MSG_ERROR )
+				{
+					std::cerr << "spirv-opt error at word " << _pos.index << ": " << _msg << std::endl;
+				}
+			} );
+
+		optimizer.RegisterPass( spvtools::CreateStripDebugInfoPass() );
+		optimizer.RegisterPerformancePasses();
+
+		std::vector<uint32_t> optimized;
+		if ( !optimizer.Run( words.data(), words.size(), &optimized ) )
+		{
+			std::cerr << "SPIRV optimization failed" << std::endl;
+			return false;
+		}
+
+		const uint8_t* bytes = reinterpret_cast<const uint8_t*>( optimized.data() );
+		*_spirv = std::vector<uint8_t>( bytes, bytes + optimized.size() * sizeof( uint32_t ) );
+
 		return true;
 	}
 } // end namespace Engine
@@ -5,18 +5,37 @@
 #include "vulkan/vulkan_core.h"
 
 namespace Engine {
+	// Debug keeps debug info and skips the optimizer for fast iteration,
+	// Release strips debug info and runs the spirv-opt performance passes
+	enum class ShaderBuildProfile {
+		DEBUG,
+		RELEASE
+	};
+
+#ifdef NDEBUG
+	constexpr ShaderBuildProfile DEFAULT_SHADER_PROFILE = ShaderBuildProfile::RELEASE;
+#else
+	constexpr ShaderBuildProfile DEFAULT_SHADER_PROFILE = ShaderBuildProfile::DEBUG;
+#endif
+
 	class RuntimeShaderCompiler
 	{
 	public:
-		static bool compile( std::filesystem::path _source, std::filesystem::path _dest );
+		static bool compile( std::filesystem::path _source, std::filesystem::path _dest, ShaderBuildProfile _profile = DEFAULT_SHADER_PROFILE );
+
+		static bool compileToMemory( std::filesystem::path _source, ShaderBuildProfile _profile, std::vector<uint8_t>* _outSPIRV );
+
+		static const char* profileName( ShaderBuildProfile _profile );
+
+		static bool isShaderSource( const std::filesystem::path& _path );
+		static VkShaderStageFlagBits vkShaderStageFromFile( std::string_view _filename );
 
 	private:
 		static std::string readShaderFile( std::string_view _filename );
 		static void saveSPRIVBin( std::string_view _filename, const uint8_t* _code, size_t size );
-
-		static VkShaderStageFlagBits vkShaderStageFromFile( std::string_view _filename );
 		static glslang_stage_t getGlslLangStage( VkShaderStageFlagBits _stage );
 
-		static bool _compile( VkShaderStageFlagBits stage, const char* code, std::vector<uint8_t>* outSPIRV, const glslang_resource_t* glslLangResource );
+		static bool _compile( VkShaderStageFlagBits stage, const char* code, std::vector<uint8_t>* outSPIRV, const glslang_resource_t* glslLangResource, ShaderBuildProfile profile );
+		static bool optimizeSPIRV( std::vector<uint8_t>* _spirv );
 	};
 } // end namespace Engine
\ No newline at end of file
@@ -0,0 +1,176 @@
+#include "ShaderArchive.h"
+
+#include <fstream>
+#include <cstring>
+
+namespace Engine {
+	using namespace ShaderArchiveFormat;
+
+	//--------------------------------------------------------------------
+	bool ShaderArchive::open( const std::filesystem::path& _path )
+	{
+		if ( !m_File.open( _path ) )
+		{
+			return false;
+		}
+
+		const auto bytes = m_File.bytes();
+		if ( bytes.size() < sizeof( ArchiveHeader ) )
+		{
+			std::cerr << "Shader archive " << _path << " is truncated" << std::endl;
+			m_File.close();
+			return false;
+		}
+
+		const auto* pHeader = reinterpret_cast<const ArchiveHeader*>( bytes.data() );
+		const size_t tableEnd = sizeof( ArchiveHeader ) + sizeof( ArchiveEntry ) * pHeader->m_EntryCount;
+
+		if ( pHeader->m_Magic != MAGIC || pHeader->m_Version != VERSION || tableEnd > bytes.size() )
+		{
+			std::cerr << "Shader archive " << _path << " is invalid or out of date, rebake it" << std::endl;
+			m_File.close();
+			return false;
+		}
+
+		m_Entries = std::span<const ArchiveEntry>( reinterpret_cast<const ArchiveEntry*>( bytes.data() + sizeof( ArchiveHeader ) ), pHeader->m_EntryCount );
+
+		for ( const auto& entry : m_Entries )
+		{
+			// Names are read as C strings below
+			if ( std::memchr( entry.m_Name, '\0', MAX_NAME_LENGTH ) == nullptr )
+			{
+				std::cerr << "Shader archive " << _path << " has an unterminated entry name" << std::endl;
+				m_Entries = {};
+				m_File.close();
+				return false;
+			}
+
+			// Subtract form, a corrupt offset near the u64 limit would wrap the sum. SPIR-V is whole words
+			if ( entry.m_Offset > bytes.size() || entry.m_Size > bytes.size() - entry.m_Offset
+				|| entry.m_Offset % sizeof( u32 ) != 0 || entry.m_Size % sizeof( u32 ) != 0 )
+			{
+				std::cerr << "Shader archive " << _path << " has an out of range entry: " << entry.m_Name << std::endl;
+				m_Entries = {};
+				m_File.close();
+				return false;
+			}
+
+			// The stage recorded at bake time must still be the one the name implies, or the code would go into the wrong pipeline stage
+			if ( !RuntimeShaderCompiler::isShaderSource( entry.m_Name )
+				|| entry.m_Stage != static_cast<u32>( RuntimeShaderCompiler::vkShaderStageFromFile( entry.m_Name ) ) )
+			{
+				std::cerr << "Shader archive " << _path << " has a mismatched stage for " << entry.m_Name << ", rebake it" << std::endl;
+				m_Entries = {};
+				m_File.close();
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	//--------------------------------------------------------------------
+	std::span<const u32> ShaderArchive::find( std::string_view _name, ShaderBuildProfile _profile ) const
+	{
+		for ( const auto& entry : m_Entries )
+		{
+			if ( entry.m_Profile == static_cast<u32>( _profile ) && _name == std::string_view( entry.m_Name ) )
+			{
+				const auto* pCode = reinterpret_cast<const u32*>( m_File.data() + entry.m_Offset );
+				return std::span<const u32>( pCode, entry.m_Size / sizeof( u32 ) );
+			}
+		}
+
+		return {};
+	}
+
+	//--------------------------------------------------------------------
+	bool ShaderArchive::bake( const std::filesystem::path& _sourceDir, const std::filesystem::path& _dest )
+	{
+		constexpr std::array<ShaderBuildProfile, 2> profiles{ ShaderBuildProfile::DEBUG, ShaderBuildProfile::RELEASE };
+
+		std::vector<std::filesystem::path> sources;
+		for ( const auto& dirEntry : std::filesystem::directory_iterator( _sourceDir ) )
+		{
+			if ( dirEntry.is_regular_file() && RuntimeShaderCompiler::isShaderSource( dirEntry.path() ) )
+			{
+				sources.push_back( dirEntry.path() );
+			}
+		}
+		std::ranges::sort( sources );
+
+		std::vector<ArchiveEntry> entries;
+		std::vector<std::vector<uint8_t>> blobs;
+
+		for ( const auto& source : sources )
+		{
+			const std::string name = source.filename().string();
+			if ( name.size() >= MAX_NAME_LENGTH )
+			{
+				std::cerr << "Shader name too long for archive: " << name << std::endl;
+				return false;
+			}
+
+			for ( const auto profile : profiles )
+			{
+				std::vector<uint8_t> spirv;
+				if ( !RuntimeShaderCompiler::compileToMemory( source, profile, &spirv ) )
+				{
+					std::cerr << "Failed to bake " << name << " (" << RuntimeShaderCompiler::profileName( profile ) << ")" << std::endl;
+					return false;
+				}
+
+				ArchiveEntry entry{};
+				memcpy( entry.m_Name, name.c_str(), name.size() );
+				entry.m_Profile = static_cast<u32>( profile );
+				entry.m_Stage = static_cast<u32>( RuntimeShaderCompiler::vkShaderStageFromFile( source.string() ) );
+				entry.m_Size = spirv.size();
+
+				entries.push_back( entry );
+				blobs.push_back( std::move( spirv ) );
+			}
+		}
+
+		auto align = []( u64 _offset ) { return ( _offset + ARCHIVE_ALIGNMENT - 1 ) & ~( ARCHIVE_ALIGNMENT - 1 ); };
+
+		u64 offset = align( sizeof( ArchiveHeader ) + sizeof( ArchiveEntry ) * entries.size() );
+		for ( auto& entry : entries )
+		{
+			entry.m_Offset = offset;
+			offset = align( offset + entry.m_Size );
+		}
+
+		std::error_code error;
+		std::filesystem::create_directories( _dest.parent_path(), error );
+
+		std::ofstream out( _dest, std::ios::binary | std::ios::trunc );
+		if ( !out )
+		{
+			std::cerr << "Error writing to " << _dest << " Verify directory exists" << std::endl;
+			return false;
+		}
+
+		const ArchiveHeader header{
+			.m_Magic = MAGIC,
+			.m_Version = VERSION,
+			.m_EntryCount = static_cast<u32>( entries.size() ),
+			.m_Reserved = 0
+		};
+
+		out.write( reinterpret_cast<const char*>( &header ), sizeof( header ) );
+		out.write( reinterpret_cast<const char*>( entries.data() ), sizeof( ArchiveEntry ) * entries.size() );
+
+		for ( size_t i = 0; i < entries.size(); i++ )
+		{
+			const std::array<char, ARCHIVE_ALIGNMENT> padding{};
+			const u64 pos = static_cast<u64>( out.tellp() );
+			out.write( padding.data(), entries[i].m_Offset - pos );
+			out.write( reinterpret_cast<const char*>( blobs[i].data() ), blobs[i].size() );
+		}
+
+		std::cout << "Baked " << entries.size() << " shader variants from " << sources.size() << " sources into " << _dest << std::endl;
+
+		return static_cast<bool>( out );
+	}
+
+} // end namespace Engine
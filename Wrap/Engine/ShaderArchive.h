@@ -0,0 +1,64 @@
+#pragma once
+
+#include <filesystem>
+#include <span>
+
+#include "../Utils/Common.h"
+#include "../Utils/MappedFile.h"
+#include "RuntimeShaderCompiler.h"
+
+namespace Engine {
+
+	// Packed SPIR-V archive layout:
+	//   ArchiveHeader | ArchiveEntry[entryCount] | SPIR-V blobs (each aligned to ARCHIVE_ALIGNMENT)
+	// Blobs are addressed by offsets from the start of the file so a mapped view can be handed to Vulkan as is
+	namespace ShaderArchiveFormat {
+		constexpr u32 MAGIC = 0x41505357; // "WSPA"
+		constexpr u32 VERSION = 1;
+		constexpr u32 MAX_NAME_LENGTH = 64;
+		constexpr u64 ARCHIVE_ALIGNMENT = 16;
+		constexpr const char* DEFAULT_ARCHIVE_PATH = "./Shaders/Compiled/shaders.wsa";
+
+		struct ArchiveHeader
+		{
+			u32 m_Magic;
+			u32 m_Version;
+			u32 m_EntryCount;
+			u32 m_Reserved;
+		};
+
+		struct ArchiveEntry
+		{
+			char m_Name[MAX_NAME_LENGTH];
+			u32 m_Profile;
+			u32 m_Stage;
+			u64 m_Offset;
+			u64 m_Size;
+		};
+	} // end namespace ShaderArchiveFormat
+
+	class ShaderArchive
+	{
+	public:
+		ShaderArchive() = default;
+
+		ShaderArchive( const ShaderArchive& _other ) = delete;
+		ShaderArchive& operator=( const ShaderArchive& ) = delete;
+
+		ShaderArchive( ShaderArchive&& _other ) = delete;
+		ShaderArchive& operator=( ShaderArchive&& ) = delete;
+
+		bool open( const std::filesystem::path& _path );
+
+		// Empty span if the shader / profile pair was not baked
+		std::span<const u32> find( std::string_view _name, ShaderBuildProfile _profile ) const;
+
+		// Compiles every shader source in _sourceDir for every build profile into a single archive
+		static bool bake( const std::filesystem::path& _sourceDir, const std::filesystem::path& _dest );
+
+	private:
+		MappedFile m_File;
+		std::span<const ShaderArchiveFormat::ArchiveEntry> m_Entries;
+	};
+
+} // end namespace Engine
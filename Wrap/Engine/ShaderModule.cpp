@@ -6,7 +6,15 @@ namespace Engine {
 		: m_Device( _device )
 	{
 		auto code = readSPIRVShaderFile( _filename );
-		createShaderModule( code );
+		createShaderModule( reinterpret_cast<const u32*>( code.data() ), code.size() );
+	}
+
+	//----------------------------------------------------------------------------------
+	ShaderModule::ShaderModule( std::span<const u32> _code, VkDevice _device )
+		: m_Device( _device )
+	{
+		assert( !_code.empty() );
+		createShaderModule( _code.data(), _code.size_bytes() );
 	}
 
 	//----------------------------------------------------------------------------------
@@ -36,14 +44,14 @@ namespace Engine {
 	}
 
 	//----------------------------------------------------------------------------------
-	void ShaderModule::createShaderModule( std::vector<char> _code )
+	void ShaderModule::createShaderModule( const u32* _code, size_t _codeSize )
 	{
 		VkShaderModuleCreateInfo createInfo{
 			.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO,
 			.pNext = nullptr,
 			.flags = 0,
-			.codeSize = _code.size(),
-			.pCode = reinterpret_cast<const uint32_t*>( _code.data() )
+			.codeSize = _codeSize,
+			.pCode = _code
 		};
 
 		VK_ASSERT( vkCreateShaderModule( m_Device, &createInfo, nullptr, &m_ShaderModule ) );
@@ -2,6 +2,7 @@
 
 #include <fstream>
 #include <filesystem>
+#include <span>
 #include "../Utils/Common.h"
 
 #include "vulkan/vulkan.h"
@@ -13,6 +14,8 @@ namespace Engine {
 
 	public:
 		ShaderModule( const Path& _filename, VkDevice _device );
+		// Code is consumed in place, e.g. straight from a mapped shader archive
+		ShaderModule( std::span<const u32> _code, VkDevice _device );
 
 		ShaderModule( const ShaderModule& _other ) = delete;
 		ShaderModule& operator=( const ShaderModule& ) = delete;
@@ -27,7 +30,7 @@ namespace Engine {
 	private:
 		// Temp -> Later pre-compile here
 		std::vector<char> readSPIRVShaderFile( const Path& _filename );
-		void createShaderModule( std::vector<char> _code );
+		void createShaderModule( const u32* _code, size_t _codeSize );
 
 		VkShaderModule m_ShaderModule;
 		VkDevice m_Device;
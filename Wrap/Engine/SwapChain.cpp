@@ -115,7 +115,7 @@ namespace Engine {
 	}
 
 	//------------------------------------------------------------------------------------
-	void Engine::SwapChain::createSwapChain()
+	void Engine::SwapChain::createSwapChain( VkSwapchainKHR _oldSwapChain /*= VK_NULL_HANDLE*/ )
 	{
 		m_SelectedFormat = chooseSwapSurfaceFormat();
 		m_SelectedPresentMode = choosePresentMode();
@@ -145,7 +145,7 @@ namespace Engine {
 			.compositeAlpha = VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR,
 			.presentMode = m_SelectedPresentMode,
 			.clipped = VK_TRUE,
-			.oldSwapchain = VK_NULL_HANDLE
+			.oldSwapchain = _oldSwapChain
 		};
 
 		VK_ASSERT( vkCreateSwapchainKHR( m_Device, &createInfo, nullptr, &m_VkSwapChain ) );
@@ -219,16 +219,39 @@ namespace Engine {
 	}
 
 	//------------------------------------------------------------------------------------
-	void Engine::SwapChain::recreateSwapChain()
+	bool Engine::SwapChain::recreateSwapChain( DeletionQueue& _deletionQueue, u64 _retireValue )
 	{
-		vkDeviceWaitIdle( m_Device );
+		querySwapChainDetails();
 
-		cleanUpSwapChain();
+		// A zero sized swapchain is invalid, wait for the window to come back
+		const VkExtent2D surfaceExtent = m_SupportDetails.m_Capabilities.currentExtent;
+		if ( surfaceExtent.width == 0 || surfaceExtent.height == 0 )
+			return false;
+
+		// Handles are moved out before the new chain is created, no device idle: submitted frames may still reference them
+		_deletionQueue.push( [device = m_Device, swapChain = m_VkSwapChain, imageViews = std::move( m_ImageViews ), frameBuffers = std::move( m_FrameBuffers )]()
+			{
+				for ( VkFramebuffer frameBuffer : frameBuffers )
+				{
+					vkDestroyFramebuffer( device, frameBuffer, nullptr );
+				}
+
+				for ( VkImageView imageView : imageViews )
+				{
+					vkDestroyImageView( device, imageView, nullptr );
+				}
+
+				vkDestroySwapchainKHR( device, swapChain, nullptr );
+			}, _retireValue );
+		m_ImageViews.clear();
+		m_FrameBuffers.clear();
 
-		querySwapChainDetails();
-		createSwapChain();
+		// The old chain is retired by this call, its images can't be acquired anymore but pending presents complete
+		createSwapChain( m_VkSwapChain );
 		createImageViews();
 		createFrameBuffers();
+
+		return true;
 	}
 
 	//------------------------------------------------------------------------------------
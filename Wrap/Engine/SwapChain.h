@@ -1,8 +1,10 @@
 #pragma once
 
 #include "../Utils/Common.h"
+#include <atomic>
 
 #include "vulkan/vulkan.h"
+#include "DeletionQueue.h"
 
 namespace Engine {
 
@@ -33,10 +35,13 @@ namespace Engine {
 		VkFramebuffer getFrameBuffer( u32 _index );
 
 		bool isAdequate();
-		void recreateSwapChain();
+		// Built from the current chain (oldSwapchain) while frames in flight keep using it. The old chain, image views and framebuffers
+		// are retired through _deletionQueue at _retireValue, the last submission that may reference them.
+		// Returns false and keeps the current chain while the surface has no area, e.g. a minimized window
+		bool recreateSwapChain( DeletionQueue& _deletionQueue, u64 _retireValue );
 
-		// Use this to recreate swapChain
-		inline static bool m_BufferResized;
+		// Use this to recreate swapChain, set by the window thread and consumed by the render thread
+		inline static std::atomic<bool> m_BufferResized{ false };
 
 	private:
 		void querySwapChainDetails();
@@ -45,7 +50,7 @@ namespace Engine {
 		VkPresentModeKHR choosePresentMode();
 		VkExtent2D chooseSwapExtent();
 
-		void createSwapChain();
+		void createSwapChain( VkSwapchainKHR _oldSwapChain = VK_NULL_HANDLE );
 		void createImageViews();
 		void createFrameBuffers();
 
@@ -0,0 +1,63 @@
+#include "TimelineSemaphore.h"
+#include "Debug.h"
+
+namespace Engine
+{
+	//------------------------------------------------------------------------------------
+	TimelineSemaphore::TimelineSemaphore( VkDevice _device )
+		: m_Device( _device )
+	{
+		const VkSemaphoreTypeCreateInfo typeInfo{
+			.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO,
+			.pNext = nullptr,
+			.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE,
+			.initialValue = 0
+		};
+
+		const VkSemaphoreCreateInfo semaphoreInfo{
+			.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO,
+			.pNext = &typeInfo,
+			.flags = 0
+		};
+
+		VK_ASSERT( vkCreateSemaphore( m_Device, &semaphoreInfo, nullptr, &m_Semaphore ) );
+	}
+
+	//------------------------------------------------------------------------------------
+	TimelineSemaphore::~TimelineSemaphore()
+	{
+		vkDestroySemaphore( m_Device, m_Semaphore, nullptr );
+	}
+
+	//------------------------------------------------------------------------------------
+	u64 TimelineSemaphore::getCompletedValue() const
+	{
+		u64 value = 0;
+		VK_ASSERT( vkGetSemaphoreCounterValue( m_Device, m_Semaphore, &value ) );
+		return value;
+	}
+
+	//------------------------------------------------------------------------------------
+	bool TimelineSemaphore::wait( u64 _value, u64 _timeoutNs ) const
+	{
+		// Never signaled, waiting would only ever time out
+		assert( _value <= getSubmittedValue() );
+
+		const VkSemaphoreWaitInfo waitInfo{
+			.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO,
+			.pNext = nullptr,
+			.flags = 0,
+			.semaphoreCount = 1,
+			.pSemaphores = &m_Semaphore,
+			.pValues = &_value
+		};
+
+		const VkResult result = vkWaitSemaphores( m_Device, &waitInfo, _timeoutNs );
+		if ( result == VK_TIMEOUT )
+			return false;
+
+		VK_ASSERT( result );
+		return true;
+	}
+
+} // end namespace Engine
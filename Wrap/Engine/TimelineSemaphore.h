@@ -0,0 +1,45 @@
+#pragma once
+
+#include <atomic>
+
+#include "../Utils/Common.h"
+#include "vulkan/vulkan_core.h"
+
+namespace Engine
+{
+	// VK_SEMAPHORE_TYPE_TIMELINE semaphore of one queue. Every submission to the queue signals the next value, so
+	// "submission N complete" is a single comparison and anyone holding a value can wait on or poll it without a fence
+	class TimelineSemaphore
+	{
+	public:
+		explicit TimelineSemaphore( VkDevice _device );
+		~TimelineSemaphore();
+
+		TimelineSemaphore( const TimelineSemaphore& _other ) = delete;
+		TimelineSemaphore& operator=( const TimelineSemaphore& ) = delete;
+
+		TimelineSemaphore( TimelineSemaphore&& _other ) = delete;
+		TimelineSemaphore& operator=( TimelineSemaphore&& ) = delete;
+
+		VkSemaphore getSemaphore() const { return m_Semaphore; };
+
+		// For the submission about to be made, values must be signaled in the order they were handed out.
+		// Submissions come from the render thread only, other threads may read the values
+		u64 nextSignalValue() { return m_SubmittedValue.fetch_add( 1, std::memory_order_relaxed ) + 1; };
+		// Of the last submission, reached once everything submitted so far has completed
+		u64 getSubmittedValue() const { return m_SubmittedValue.load( std::memory_order_relaxed ); };
+
+		u64 getCompletedValue() const;
+		bool isComplete( u64 _value ) const { return _value <= getSubmittedValue() && _value <= getCompletedValue(); };
+
+		// False if _value was not reached within _timeoutNs, any other failure (a lost device) is fatal
+		bool wait( u64 _value, u64 _timeoutNs ) const;
+
+	private:
+		VkSemaphore m_Semaphore{ VK_NULL_HANDLE };
+		std::atomic<u64> m_SubmittedValue{ 0 };
+
+		VkDevice m_Device;
+	};
+
+} // end namespace Engine
@@ -0,0 +1,103 @@
+#include "TransformEncoding.h"
+#include "UniformBuffer.h"
+
+#include "../Maths/Quaternion.h"
+
+#include <cmath>
+#include <cstring>
+
+namespace Engine
+{
+	static_assert( sizeof( ModelUBO ) == 64 );
+	static_assert( sizeof( AffineTransformGpu ) == 48 );
+	static_assert( sizeof( QuantizedTransformGpu ) == 24 );
+
+	namespace {
+		u32 packSnorm2x16( f32 _low, f32 _high )
+		{
+			auto quantize = []( f32 _v ) {
+				return static_cast<u32>( static_cast<u16>( static_cast<int16_t>( std::lround( std::clamp( _v, -1.0f, 1.0f ) * 32767.0f ) ) ) );
+			};
+			return quantize( _low ) | ( quantize( _high ) << 16 );
+		}
+
+		f32 columnLength( const Maths::Vector4& _c )
+		{
+			return std::sqrt( _c.x * _c.x + _c.y * _c.y + _c.z * _c.z );
+		}
+	} // end anonymous namespace
+
+	//------------------------------------------------------------------------------------
+	u32 TransformEncoder::stride( TransformEncoding _encoding )
+	{
+		switch ( _encoding )
+		{
+		case TransformEncoding::AFFINE_3X4:
+			return sizeof( AffineTransformGpu );
+		case TransformEncoding::QUANTIZED:
+			return sizeof( QuantizedTransformGpu );
+		case TransformEncoding::MATRIX_4X4:
+		default:
+			return sizeof( ModelUBO );
+		}
+	}
+
+	//------------------------------------------------------------------------------------
+	const char* TransformEncoder::name( TransformEncoding _encoding )
+	{
+		switch ( _encoding )
+		{
+		case TransformEncoding::AFFINE_3X4:
+			return "affine 3x4";
+		case TransformEncoding::QUANTIZED:
+			return "quantized";
+		case TransformEncoding::MATRIX_4X4:
+		default:
+			return "matrix 4x4";
+		}
+	}
+
+	//------------------------------------------------------------------------------------
+	void TransformEncoder::encode( TransformEncoding _encoding, const Maths::Matrix4& _model, void* _pDest )
+	{
+		switch ( _encoding )
+		{
+		case TransformEncoding::AFFINE_3X4:
+		{
+			// Rows, so the shader gets each output component from one dot product
+			const Maths::Matrix4 rows = _model.Transpose();
+			const AffineTransformGpu affine{ .m_Rows = { rows.c1, rows.c2, rows.c3 } };
+			memcpy( _pDest, &affine, sizeof( affine ) );
+			break;
+		}
+		case TransformEncoding::QUANTIZED:
+		{
+			const f32 scaleX = columnLength( _model.c1 );
+			const f32 scaleY = columnLength( _model.c2 );
+			const f32 scaleZ = columnLength( _model.c3 );
+			const f32 scale = ( scaleX + scaleY + scaleZ ) / 3.0f;
+			assert( std::abs( scaleX - scale ) <= 1e-3f * scale && std::abs( scaleY - scale ) <= 1e-3f * scale );
+
+			Maths::Quaternion rotation{};
+			if ( scale > 0.0f )
+			{
+				const Maths::Matrix4 unscaled{ .c1 = _model.c1 * ( 1.0f / scaleX ), .c2 = _model.c2 * ( 1.0f / scaleY ), .c3 = _model.c3 * ( 1.0f / scaleZ ) };
+				rotation = Maths::Quaternion::FromRotationMatrix( unscaled );
+			}
+
+			const QuantizedTransformGpu quantized{
+				.m_Position = { _model.c4.x, _model.c4.y, _model.c4.z },
+				.m_Scale = scale,
+				.m_Rotation = { packSnorm2x16( rotation.x, rotation.y ), packSnorm2x16( rotation.z, rotation.w ) }
+			};
+			memcpy( _pDest, &quantized, sizeof( quantized ) );
+			break;
+		}
+		case TransformEncoding::MATRIX_4X4:
+		default:
+			memcpy( _pDest, &_model, sizeof( ModelUBO ) );
+			break;
+		}
+	}
+
+} // end namespace Engine
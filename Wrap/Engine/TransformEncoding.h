@@ -0,0 +1,43 @@
+#pragma once
+
+#include "../Utils/Common.h"
+
+#include "../Maths/Matrix4.h"
+
+namespace Engine {
+
+	// Layout of the per-object transforms in the model storage buffer.
+	// The value is the shaders' TRANSFORM_ENCODING specialization constant, keep main.vert, pull.vert and cull.comp in sync.
+	enum class TransformEncoding : u32 {
+		// Full mat4, 64 bytes
+		MATRIX_4X4,
+		// First three rows of the matrix, the last one is always ( 0 0 0 1 ). 48 bytes, exact for any affine transform
+		AFFINE_3X4,
+		// Float position and uniform scale, rotation as four snorm16. 24 bytes, loses shear and non-uniform scale
+		QUANTIZED
+	};
+
+	struct AffineTransformGpu
+	{
+		Maths::Vector4 m_Rows[3];
+	};
+
+	struct QuantizedTransformGpu
+	{
+		f32 m_Position[3];
+		f32 m_Scale;
+		// Quaternion xy and zw, each a pair of snorm16 as read by unpackSnorm2x16
+		u32 m_Rotation[2];
+	};
+
+	class TransformEncoder
+	{
+	public:
+		static u32 stride( TransformEncoding _encoding );
+		static const char* name( TransformEncoding _encoding );
+
+		// Writes stride( _encoding ) bytes, _pDest may be unaligned mapped memory
+		static void encode( TransformEncoding _encoding, const Maths::Matrix4& _model, void* _pDest );
+	};
+
+} // end namespace Engine
@@ -1,5 +1,8 @@
 #include "UniformBuffer.h"
 #include "VulkanMemory.h"
+#include "Debug.h"
+
+#include <cstring>
 
 //------------------------------------------------------------------------------------
 Engine::UniformBuffer::UniformBuffer( VkDevice _device, VkPhysicalDevice _physDevice, VkDeviceSize _size )
@@ -0,0 +1,165 @@
+#include "VertexFormat.h"
+
+#include <bit>
+#include <cmath>
+#include <limits>
+
+namespace Engine {
+
+	namespace {
+		// Largest finite half float
+		constexpr f32 HALF_MAX = 65504.0f;
+
+		//--------------------------------------------------------------------
+		// Rounds to nearest, values below the smallest normal half flush to zero
+		u16 FloatToHalf( f32 _value )
+		{
+			const u32 bits = std::bit_cast<u32>( _value );
+			const u32 sign = ( bits >> 16 ) & 0x8000;
+			const u32 magnitude = bits & 0x7FFFFFFF;
+
+			// Exponent bias 127 becomes 15
+			u32 half = ( magnitude - ( 112u << 23 ) + ( 1u << 12 ) ) >> 13;
+			half = magnitude < ( 113u << 23 ) ? 0 : half;
+			half = magnitude >= ( 143u << 23 ) ? 0x7C00 : half;
+			half = magnitude > ( 255u << 23 ) ? 0x7E00 : half;
+
+			return static_cast<u16>( sign | half );
+		}
+
+		//--------------------------------------------------------------------
+		f32 HalfToFloat( u16 _half )
+		{
+			const u32 sign = u32( _half & 0x8000 ) << 16;
+			const u32 magnitude = _half & 0x7FFF;
+
+			u32 bits = ( magnitude + ( 112u << 10 ) ) << 13;
+			bits = magnitude < ( 1u << 10 ) ? 0 : bits;
+			// Infinity and NaN keep the maximum exponent
+			bits += magnitude >= ( 31u << 10 ) ? ( 112u << 23 ) : 0;
+
+			return std::bit_cast<f32>( sign | bits );
+		}
+
+		//--------------------------------------------------------------------
+		template<typename T>
+		T FloatToUnorm( f32 _value )
+		{
+			constexpr f32 MAX_VALUE = static_cast<f32>( std::numeric_limits<T>::max() );
+			return static_cast<T>( std::lround( std::clamp( _value, 0.0f, 1.0f ) * MAX_VALUE ) );
+		}
+
+		//--------------------------------------------------------------------
+		i16 FloatToSnorm16( f32 _value )
+		{
+			return static_cast<i16>( std::lround( std::clamp( _value, -1.0f, 1.0f ) * 32767.0f ) );
+		}
+
+		//--------------------------------------------------------------------
+		f32 SignNotZero( f32 _value )
+		{
+			return _value >= 0.0f ? 1.0f : -1.0f;
+		}
+	} // end anonymous namespace
+
+	//--------------------------------------------------------------------
+	HalfPosition HalfPosition::Encode( const Maths::Vector3& _position )
+	{
+		// Out of range positions saturate instead of becoming infinite
+		auto encode = []( f32 _value ) { return FloatToHalf( std::clamp( _value, -HALF_MAX, HALF_MAX ) ); };
+
+		return HalfPosition{ .m_X = encode( _position.x ), .m_Y = encode( _position.y ), .m_Z = encode( _position.z ), .m_W = FloatToHalf( 1.0f ) };
+	}
+
+	//--------------------------------------------------------------------
+	Maths::Vector3 HalfPosition::decode() const
+	{
+		return Maths::Vector3{ .x = HalfToFloat( m_X ), .y = HalfToFloat( m_Y ), .z = HalfToFloat( m_Z ) };
+	}
+
+	//--------------------------------------------------------------------
+	PositionFrame PositionFrame::FromBox( const Maths::Vector3& _min, const Maths::Vector3& _max )
+	{
+		const Maths::Vector3 center{ .x = ( _min.x + _max.x ) * 0.5f, .y = ( _min.y + _max.y ) * 0.5f, .z = ( _min.z + _max.z ) * 0.5f };
+		const f32 halfExtent = std::max( { _max.x - _min.x, _max.y - _min.y, _max.z - _min.z } ) * 0.5f;
+
+		// Also false for NaN and infinity
+		if ( !( halfExtent > 0.0f && halfExtent <= std::numeric_limits<f32>::max() ) || !std::isfinite( center.x + center.y + center.z ) )
+			return PositionFrame{};
+
+		return PositionFrame{ .m_Offset = center, .m_Scale = halfExtent };
+	}
+
+	//--------------------------------------------------------------------
+	Maths::Vector3 PositionFrame::toStored( const Maths::Vector3& _position ) const
+	{
+		const f32 invScale = 1.0f / m_Scale;
+		return Maths::Vector3{ .x = ( _position.x - m_Offset.x ) * invScale, .y = ( _position.y - m_Offset.y ) * invScale, .z = ( _position.z - m_Offset.z ) * invScale };
+	}
+
+	//--------------------------------------------------------------------
+	Maths::Vector3 PositionFrame::toObject( const Maths::Vector3& _stored ) const
+	{
+		return Maths::Vector3{ .x = _stored.x * m_Scale + m_Offset.x, .y = _stored.y * m_Scale + m_Offset.y, .z = _stored.z * m_Scale + m_Offset.z };
+	}
+
+	//--------------------------------------------------------------------
+	OctNormal OctNormal::Encode( const Maths::Vector3& _normal )
+	{
+		const f32 l1Norm = std::abs( _normal.x ) + std::abs( _normal.y ) + std::abs( _normal.z );
+		if ( l1Norm == 0.0f )
+			return OctNormal{ .m_X = 0, .m_Y = 0 };
+
+		f32 x = _normal.x / l1Norm;
+		f32 y = _normal.y / l1Norm;
+
+		// The lower hemisphere folds over the diagonals
+		if ( _normal.z < 0.0f )
+		{
+			const f32 foldedX = ( 1.0f - std::abs( y ) ) * SignNotZero( x );
+			const f32 foldedY = ( 1.0f - std::abs( x ) ) * SignNotZero( y );
+			x = foldedX;
+			y = foldedY;
+		}
+
+		return OctNormal{ .m_X = FloatToSnorm16( x ), .m_Y = FloatToSnorm16( y ) };
+	}
+
+	//--------------------------------------------------------------------
+	Maths::Vector3 OctNormal::decode() const
+	{
+		Maths::Vector3 normal{ .x = std::max( m_X / 32767.0f, -1.0f ), .y = std::max( m_Y / 32767.0f, -1.0f ), .z = 0.0f };
+		normal.z = 1.0f - std::abs( normal.x ) - std::abs( normal.y );
+
+		const f32 fold = std::max( -normal.z, 0.0f );
+		normal.x += normal.x >= 0.0f ? -fold : fold;
+		normal.y += normal.y >= 0.0f ? -fold : fold;
+
+		return normal.Normalize();
+	}
+
+	//--------------------------------------------------------------------
+	ColorUnorm8 ColorUnorm8::Encode( const Maths::Vector3& _color )
+	{
+		return ColorUnorm8{ .m_R = FloatToUnorm<u8>( _color.x ), .m_G = FloatToUnorm<u8>( _color.y ), .m_B = FloatToUnorm<u8>( _color.z ), .m_A = 255 };
+	}
+
+	//--------------------------------------------------------------------
+	Maths::Vector3 ColorUnorm8::decode() const
+	{
+		return Maths::Vector3{ .x = m_R / 255.0f, .y = m_G / 255.0f, .z = m_B / 255.0f };
+	}
+
+	//--------------------------------------------------------------------
+	UvUnorm16 UvUnorm16::Encode( const Maths::Vector2& _uv )
+	{
+		return UvUnorm16{ .m_U = FloatToUnorm<u16>( _uv.x ), .m_V = FloatToUnorm<u16>( _uv.y ) };
+	}
+
+	//--------------------------------------------------------------------
+	Maths::Vector2 UvUnorm16::decode() const
+	{
+		return Maths::Vector2{ .x = m_U / 65535.0f, .y = m_V / 65535.0f };
+	}
+
+} // end namespace Engine
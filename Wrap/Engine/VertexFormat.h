@@ -0,0 +1,132 @@
+#pragma once
+
+#include "../Utils/Common.h"
+#include <cstddef>
+
+#include "vulkan/vulkan_core.h"
+#include "../Maths/Vector2.h"
+#include "../Maths/Vector3.h"
+
+namespace Engine {
+
+	// Quantized attribute storage, the input assembler expands each back to floats through its VkFormat
+
+	// Three half floats, the fourth pads to RGBA16F: RGB16F vertex input is optional in Vulkan
+	struct HalfPosition
+	{
+		u16 m_X{ 0 };
+		u16 m_Y{ 0 };
+		u16 m_Z{ 0 };
+		u16 m_W{ 0 };
+
+		static HalfPosition Encode( const Maths::Vector3& _position );
+		Maths::Vector3 decode() const;
+	};
+
+	// Where a geometry's stored positions sit in object space: object = stored * m_Scale + m_Offset, applied by the vertex shaders.
+	// Half floats only keep 11 bits of mantissa, centering on the bounds and scaling them to unit size gives every mesh
+	// the same precision relative to its size, however far from the origin it was modeled
+	struct PositionFrame
+	{
+		Maths::Vector3 m_Offset;
+		f32 m_Scale{ 1.0f };
+
+		// The box's longest axis maps to -1..1, an empty or degenerate box keeps the identity
+		static PositionFrame FromBox( const Maths::Vector3& _min, const Maths::Vector3& _max );
+
+		Maths::Vector3 toStored( const Maths::Vector3& _position ) const;
+		Maths::Vector3 toObject( const Maths::Vector3& _stored ) const;
+	};
+
+	// Unit vector folded onto an octahedron as two snorm16, the shader unfolds it
+	struct OctNormal
+	{
+		i16 m_X{ 0 };
+		i16 m_Y{ 0 };
+
+		static OctNormal Encode( const Maths::Vector3& _normal );
+		Maths::Vector3 decode() const;
+	};
+
+	// 0..1 color with opaque alpha
+	struct ColorUnorm8
+	{
+		u8 m_R{ 0 };
+		u8 m_G{ 0 };
+		u8 m_B{ 0 };
+		u8 m_A{ 0 };
+
+		static ColorUnorm8 Encode( const Maths::Vector3& _color );
+		Maths::Vector3 decode() const;
+	};
+
+	// Texture coordinates clamped to 0..1
+	struct UvUnorm16
+	{
+		u16 m_U{ 0 };
+		u16 m_V{ 0 };
+
+		static UvUnorm16 Encode( const Maths::Vector2& _uv );
+		Maths::Vector2 decode() const;
+	};
+
+	template<typename T> inline constexpr VkFormat VERTEX_FORMAT_OF = VK_FORMAT_UNDEFINED;
+	template<> inline constexpr VkFormat VERTEX_FORMAT_OF<f32> = VK_FORMAT_R32_SFLOAT;
+	template<> inline constexpr VkFormat VERTEX_FORMAT_OF<Maths::Vector2> = VK_FORMAT_R32G32_SFLOAT;
+	template<> inline constexpr VkFormat VERTEX_FORMAT_OF<Maths::Vector3> = VK_FORMAT_R32G32B32_SFLOAT;
+	template<> inline constexpr VkFormat VERTEX_FORMAT_OF<HalfPosition> = VK_FORMAT_R16G16B16A16_SFLOAT;
+	template<> inline constexpr VkFormat VERTEX_FORMAT_OF<OctNormal> = VK_FORMAT_R16G16_SNORM;
+	template<> inline constexpr VkFormat VERTEX_FORMAT_OF<ColorUnorm8> = VK_FORMAT_R8G8B8A8_UNORM;
+	template<> inline constexpr VkFormat VERTEX_FORMAT_OF<UvUnorm16> = VK_FORMAT_R16G16_UNORM;
+
+	struct VertexAttribute
+	{
+		u32 m_Location;
+		VkFormat m_Format;
+		u32 m_Offset;
+
+		template<typename T>
+		static constexpr VertexAttribute Of( u32 _location, size_t _offset )
+		{
+			static_assert( VERTEX_FORMAT_OF<T> != VK_FORMAT_UNDEFINED, "No vertex format for this attribute type" );
+			return VertexAttribute{ .m_Location = _location, .m_Format = VERTEX_FORMAT_OF<T>, .m_Offset = static_cast<u32>( _offset ) };
+		}
+	};
+
+	// Vulkan descriptions of a vertex type, generated from its static constexpr attributes().
+	// attributes() is a function because offsetof needs the complete type, which a member initializer does not have.
+	template<typename TVertex>
+	struct VertexLayout
+	{
+		static constexpr auto ATTRIBUTES = TVertex::attributes();
+		static constexpr u32 ATTRIBUTE_COUNT = static_cast<u32>( ATTRIBUTES.size() );
+
+		//--------------------------------------------------------------------
+		static constexpr VkVertexInputBindingDescription binding( u32 _binding = 0 )
+		{
+			return VkVertexInputBindingDescription{
+				.binding = _binding,
+				.stride = sizeof( TVertex ),
+				.inputRate = VK_VERTEX_INPUT_RATE_VERTEX
+			};
+		}
+
+		//--------------------------------------------------------------------
+		static constexpr std::array<VkVertexInputAttributeDescription, ATTRIBUTE_COUNT> attributeDescriptions( u32 _binding = 0 )
+		{
+			std::array<VkVertexInputAttributeDescription, ATTRIBUTE_COUNT> descriptions{};
+			for ( u32 i = 0; i < ATTRIBUTE_COUNT; i++ )
+			{
+				descriptions[i] = VkVertexInputAttributeDescription{
+					.location = ATTRIBUTES[i].m_Location,
+					.binding = _binding,
+					.format = ATTRIBUTES[i].m_Format,
+					.offset = ATTRIBUTES[i].m_Offset
+				};
+			}
+
+			return descriptions;
+		}
+	};
+
+} // end namespace Engine
@@ -4,4 +4,6 @@
 
 namespace Engine {
 	constexpr u32 MAX_FRAMES_IN_FLIGHT = 2;
+	// Host waits on the GPU or the swapchain give up after this, far longer than any frame should take
+	constexpr u64 FRAME_WAIT_TIMEOUT_NS = 1'000'000'000;
 }
\ No newline at end of file
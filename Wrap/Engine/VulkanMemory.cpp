@@ -1,4 +1,7 @@
 #include "VulkanMemory.h"
+#include "Debug.h"
+
+#include <cstring>
 
 namespace Engine {
 
@@ -21,9 +24,17 @@ namespace Engine {
 		VkMemoryRequirements memReqs;
 		vkGetBufferMemoryRequirements( _device, _buffer, &memReqs );
 
+		// bufferDeviceAddress must be enabled on the device for such buffers
+		const VkMemoryAllocateFlagsInfo allocFlags{
+			.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_FLAGS_INFO,
+			.pNext = nullptr,
+			.flags = VK_MEMORY_ALLOCATE_DEVICE_ADDRESS_BIT,
+			.deviceMask = 0
+		};
+
 		VkMemoryAllocateInfo allocInfo{
 			.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
-			.pNext = nullptr,
+			.pNext = ( _usage & VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT ) ? &allocFlags : nullptr,
 			.allocationSize = memReqs.size,
 			.memoryTypeIndex = VulkanMemory::findMemoryType( _physDevice, memReqs.memoryTypeBits, _properties )
 		};
@@ -34,51 +45,76 @@ namespace Engine {
 	}
 
 	//------------------------------------------------------------------------------------
-	void VulkanMemory::createMeshVertexBuffer( VkDevice _device, VkPhysicalDevice _physDevice, const Scene::Mesh& _mesh, VkBuffer& _buffer, VkDeviceMemory& _memory, VkCommandPool _pool, VkQueue _queue )
+	VkDeviceAddress VulkanMemory::getBufferAddress( VkDevice _device, VkBuffer _buffer )
 	{
-		VkDeviceSize size = sizeof( Vertex ) * _mesh.getVertices().size();
-
-		VkBuffer stagingBuffer;
-		VkDeviceMemory stagingMemory;
-		createBuffer( _device, _physDevice, size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-			VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, stagingBuffer, stagingMemory );
-
-		void* data;
-		VK_ASSERT( vkMapMemory( _device, stagingMemory, 0, size, 0, &data ) );
-		memcpy( data, _mesh.getVertices().data(), (size_t)size );
-		vkUnmapMemory( _device, stagingMemory );
-
-		createBuffer( _device, _physDevice, size, VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
-			VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, _buffer, _memory );
-
-		copyBuffer( _device, stagingBuffer, _buffer, size, _pool, _queue );
+		const VkBufferDeviceAddressInfo addressInfo{
+			.sType = VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO,
+			.pNext = nullptr,
+			.buffer = _buffer
+		};
 
-		vkDestroyBuffer( _device, stagingBuffer, nullptr );
-		vkFreeMemory( _device, stagingMemory, nullptr );
+		return vkGetBufferDeviceAddress( _device, &addressInfo );
 	}
 
 	//------------------------------------------------------------------------------------
-	void VulkanMemory::createMeshIndexBuffer( VkDevice _device, VkPhysicalDevice _physDevice, const Scene::Mesh& _mesh, VkBuffer& _buffer, VkDeviceMemory& _memory, VkCommandPool _pool, VkQueue _queue )
+	u64 VulkanMemory::createMeshBuffers( VkDevice _device, VkPhysicalDevice _physDevice, u32 _vertexCount, u32 _indexCount, VkIndexType _indexType, const MeshWriter& _writer,
+		VkBuffer& _vertexBuffer, VkDeviceMemory& _vertexMemory, VkBuffer& _indexBuffer, VkDeviceMemory& _indexMemory, const UploadContext& _upload, bool _deviceAddress /*= false*/ )
 	{
-		VkDeviceSize size = sizeof( u16 ) * _mesh.getIndices().size();
+		assert( _indexType == VK_INDEX_TYPE_UINT16 || _indexType == VK_INDEX_TYPE_UINT32 );
 
+		const VkDeviceSize vertexSize = VkDeviceSize( _vertexCount ) * sizeof( Vertex );
+		// Whole words, shaders pulling 16-bit indices read them in pairs
+		const VkDeviceSize indexSize = ( VkDeviceSize( _indexCount ) * VulkanMemory::indexSize( _indexType ) + 3 ) & ~VkDeviceSize( 3 );
+
+		// Vertices first, their size keeps the indices 4-byte aligned
 		VkBuffer stagingBuffer;
 		VkDeviceMemory stagingMemory;
-		createBuffer( _device, _physDevice, size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+		createBuffer( _device, _physDevice, vertexSize + indexSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
 			VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, stagingBuffer, stagingMemory );
 
 		void* data;
-		VK_ASSERT( vkMapMemory( _device, stagingMemory, 0, size, 0, &data ) );
-		memcpy( data, _mesh.getIndices().data(), (size_t)size );
+		VK_ASSERT( vkMapMemory( _device, stagingMemory, 0, vertexSize + indexSize, 0, &data ) );
+		const std::span<Vertex> vertices( static_cast<Vertex*>( data ), _vertexCount );
+		std::byte* pIndices = static_cast<std::byte*>( data ) + vertexSize;
+
+		if ( _indexType == VK_INDEX_TYPE_UINT32 )
+		{
+			_writer( vertices, std::span<u32>( reinterpret_cast<u32*>( pIndices ), _indexCount ) );
+		}
+		else
+		{
+			// Narrowed on the way in, staging memory may be write-combined and is never read back
+			std::vector<u32> wideIndices( _indexCount );
+			_writer( vertices, wideIndices );
+
+			u16* pNarrow = reinterpret_cast<u16*>( pIndices );
+			for ( u32 i = 0; i < _indexCount; i++ )
+			{
+				assert( wideIndices[i] < _vertexCount );
+				pNarrow[i] = static_cast<u16>( wideIndices[i] );
+			}
+		}
 		vkUnmapMemory( _device, stagingMemory );
 
-		createBuffer( _device, _physDevice, size, VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
-			VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, _buffer, _memory );
+		// Storage buffers as well when shaders pull from them
+		const VkBufferUsageFlags pullUsage = _deviceAddress ? VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT : 0;
 
-		copyBuffer( _device, stagingBuffer, _buffer, size, _pool, _queue );
+		createBuffer( _device, _physDevice, vertexSize, VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | pullUsage,
+			VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, _vertexBuffer, _vertexMemory );
+		createBuffer( _device, _physDevice, indexSize, VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT | pullUsage,
+			VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, _indexBuffer, _indexMemory );
 
-		vkDestroyBuffer( _device, stagingBuffer, nullptr );
-		vkFreeMemory( _device, stagingMemory, nullptr );
+		copyBuffer( _device, stagingBuffer, _vertexBuffer, vertexSize, _upload );
+		const u64 uploadValue = copyBuffer( _device, stagingBuffer, _indexBuffer, indexSize, _upload, vertexSize );
+
+		// Read by both copies, the second one completes last
+		_upload.m_DeletionQueue.push( [_device, stagingBuffer, stagingMemory]()
+			{
+				vkDestroyBuffer( _device, stagingBuffer, nullptr );
+				vkFreeMemory( _device, stagingMemory, nullptr );
+			}, uploadValue );
+
+		return uploadValue;
 	}
 
 	//------------------------------------------------------------------------------------
@@ -101,12 +137,12 @@ namespace Engine {
 	}
 
 	//------------------------------------------------------------------------------------
-	void VulkanMemory::copyBuffer( VkDevice _device, VkBuffer _source, VkBuffer _dest, VkDeviceSize _size, VkCommandPool _pool, VkQueue _queue )
+	u64 VulkanMemory::copyBuffer( VkDevice _device, VkBuffer _source, VkBuffer _dest, VkDeviceSize _size, const UploadContext& _upload, VkDeviceSize _sourceOffset /*= 0*/ )
 	{
 		VkCommandBufferAllocateInfo allocInfo{
 			.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
 			.pNext = nullptr,
-			.commandPool = _pool,
+			.commandPool = _upload.m_Pool,
 			.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
 			.commandBufferCount = 1
 		};
@@ -124,7 +160,7 @@ namespace Engine {
 		VK_ASSERT( vkBeginCommandBuffer( commandBuffer, &beginInfo ) );
 
 		VkBufferCopy copyRegion{
-			.srcOffset = 0,
+			.srcOffset = _sourceOffset,
 			.dstOffset = 0,
 			.size = _size
 		};
@@ -132,22 +168,38 @@ namespace Engine {
 		vkCmdCopyBuffer( commandBuffer, _source, _dest, 1, &copyRegion );
 		vkEndCommandBuffer( commandBuffer );
 
+		const u64 signalValue = _upload.m_Timeline.nextSignalValue();
+		const VkSemaphore timeline = _upload.m_Timeline.getSemaphore();
+
+		const VkTimelineSemaphoreSubmitInfo timelineInfo{
+			.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO,
+			.pNext = nullptr,
+			.waitSemaphoreValueCount = 0,
+			.pWaitSemaphoreValues = nullptr,
+			.signalSemaphoreValueCount = 1,
+			.pSignalSemaphoreValues = &signalValue
+		};
+
 		VkSubmitInfo submitInfo{
 			.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
-			.pNext = nullptr,
+			.pNext = &timelineInfo,
 			.waitSemaphoreCount = 0,
 			.pWaitSemaphores = nullptr,
 			.pWaitDstStageMask = nullptr,
 			.commandBufferCount = 1,
 			.pCommandBuffers = &commandBuffer,
-			.signalSemaphoreCount = 0,
-			.pSignalSemaphores = nullptr
+			.signalSemaphoreCount = 1,
+			.pSignalSemaphores = &timeline
 		};
 
-		VK_ASSERT( vkQueueSubmit( _queue, 1, &submitInfo, VK_NULL_HANDLE ) );
-		vkQueueWaitIdle( _queue );
+		VK_ASSERT( vkQueueSubmit( _upload.m_Queue, 1, &submitInfo, VK_NULL_HANDLE ) );
+
+		_upload.m_DeletionQueue.push( [_device, pool = _upload.m_Pool, commandBuffer]()
+			{
+				vkFreeCommandBuffers( _device, pool, 1, &commandBuffer );
+			}, signalValue );
 
-		vkFreeCommandBuffers( _device, _pool, 1, &commandBuffer );
+		return signalValue;
 	}
 
 }
@@ -1,21 +1,49 @@
 #pragma once
 
 #include "vulkan/vulkan_core.h"
-#include "../Scene/BaseScene.h"
+#include "../Utils/Common.h"
+#include "VulkanTypes.h"
+#include "TimelineSemaphore.h"
+#include "DeletionQueue.h"
+
+#include <span>
 
 namespace Engine {
 
+	// Where transfers are submitted. Nothing waits for them: each submission signals the next value of m_Timeline,
+	// command buffers and staging memory are retired through m_DeletionQueue at that value
+	struct UploadContext
+	{
+		VkCommandPool m_Pool;
+		VkQueue m_Queue;
+		TimelineSemaphore& m_Timeline;
+		DeletionQueue& m_DeletionQueue;
+	};
+
 	class VulkanMemory
 	{
 	public:
-		// Specific to Vertex Buffers
-		static void createMeshVertexBuffer( VkDevice _device, VkPhysicalDevice _physDevice, const Scene::Mesh& _mesh, VkBuffer& _buffer, VkDeviceMemory& _memory, VkCommandPool _pool, VkQueue _queue );
-		static void createMeshIndexBuffer( VkDevice _device, VkPhysicalDevice _physDevice, const Scene::Mesh& _mesh, VkBuffer& _buffer, VkDeviceMemory& _memory, VkCommandPool _pool, VkQueue _queue );
+		// Writes a mesh's vertices and indices straight into mapped staging memory
+		using MeshWriter = std::function<void( std::span<Vertex> _vertices, std::span<u32> _indices )>;
+
+		// Specific to Mesh Buffers: device local vertex and index buffers uploaded through one staging buffer.
+		// Indices are always written as u32, the upload narrows them when _indexType is VK_INDEX_TYPE_UINT16.
+		// With _deviceAddress both buffers can also be read by shaders through their getBufferAddress().
+		// Returns the timeline value of the upload, submissions using the buffers must wait on it
+		static u64 createMeshBuffers( VkDevice _device, VkPhysicalDevice _physDevice, u32 _vertexCount, u32 _indexCount, VkIndexType _indexType, const MeshWriter& _writer,
+			VkBuffer& _vertexBuffer, VkDeviceMemory& _vertexMemory, VkBuffer& _indexBuffer, VkDeviceMemory& _indexMemory, const UploadContext& _upload, bool _deviceAddress = false );
+
+		// Smallest index type able to address _vertexCount vertices, 0xFFFF stays free for primitive restart
+		static VkIndexType selectIndexType( u32 _vertexCount ) { return _vertexCount <= 0xFFFF ? VK_INDEX_TYPE_UINT16 : VK_INDEX_TYPE_UINT32; };
+		static VkDeviceSize indexSize( VkIndexType _indexType ) { return _indexType == VK_INDEX_TYPE_UINT16 ? sizeof( u16 ) : sizeof( u32 ); };
 
 		// Generic
 		static void createBuffer( VkDevice _device, VkPhysicalDevice _physDevice, VkDeviceSize _size, VkBufferUsageFlags _usage, VkMemoryPropertyFlags _properties, VkBuffer& _buffer, VkDeviceMemory& _memory );
+		// The buffer needs VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT, which createBuffer() backs with device address capable memory
+		static VkDeviceAddress getBufferAddress( VkDevice _device, VkBuffer _buffer );
 		static u32 findMemoryType( VkPhysicalDevice _physicalDevice, u32 _typeFilter, VkMemoryPropertyFlags _props );
-		static void copyBuffer( VkDevice _device, VkBuffer _source, VkBuffer _dest, VkDeviceSize _size, VkCommandPool _pool, VkQueue _queue );
+		// Returns the timeline value reached once the copy has completed
+		static u64 copyBuffer( VkDevice _device, VkBuffer _source, VkBuffer _dest, VkDeviceSize _size, const UploadContext& _upload, VkDeviceSize _sourceOffset = 0 );
 	};
 
 } // end namespace Engine
@@ -4,41 +4,34 @@
 #include "../Maths/Vector3.h"
 
 #include "vulkan/vulkan_core.h"
+#include "VertexFormat.h"
 
 
 namespace Engine {
-	// TODO create proper interface for different vertices and their description
+	// What the GPU reads per vertex: 12 bytes, against 24 for a float position and color.
+	// Further layouts only need their own attributes(), VertexLayout generates the Vulkan descriptions
 	struct Vertex final
 	{
-		Maths::Vector2 m_Pos;
-		Maths::Vector3 m_Color;
+		HalfPosition m_Pos;
+		ColorUnorm8 m_Color;
 
-		static VkVertexInputBindingDescription getBindingDescrition()
+		Vertex() = default;
+		Vertex( const Maths::Vector3& _position, const Maths::Vector3& _color )
+			: m_Pos( HalfPosition::Encode( _position ) )
+			, m_Color( ColorUnorm8::Encode( _color ) )
 		{
-			VkVertexInputBindingDescription bindingDesc{
-				.binding = 0,
-				.stride = sizeof( Vertex ),
-				.inputRate = VK_VERTEX_INPUT_RATE_VERTEX
-			};
-
-			return bindingDesc;
 		}
 
-		static std::array<VkVertexInputAttributeDescription, 2> getAttributesDescription()
-		{
-			std::array<VkVertexInputAttributeDescription, 2> attributesdesc;
-
-			attributesdesc[0].binding = 0;
-			attributesdesc[0].format = VK_FORMAT_R32G32_SFLOAT;
-			attributesdesc[0].location = 0;
-			attributesdesc[0].offset = offsetof( Vertex, m_Pos );
+		// As the shader sees them after the input assembler expands the formats, the position before its geometry's PositionFrame
+		Maths::Vector3 getPosition() const { return m_Pos.decode(); };
+		Maths::Vector3 getColor() const { return m_Color.decode(); };
 
-			attributesdesc[1].binding = 0;
-			attributesdesc[1].format = VK_FORMAT_R32G32B32_SFLOAT;
-			attributesdesc[1].location = 1;
-			attributesdesc[1].offset = offsetof( Vertex, m_Color );
-
-			return attributesdesc;
+		static constexpr std::array<VertexAttribute, 2> attributes()
+		{
+			return {
+				VertexAttribute::Of<HalfPosition>( 0, offsetof( Vertex, m_Pos ) ),
+				VertexAttribute::Of<ColorUnorm8>( 1, offsetof( Vertex, m_Color ) )
+			};
 		}
 	};
 } // end namespace Engine
\ No newline at end of file
@@ -0,0 +1,28 @@
+#include "FastTrig.h"
+
+namespace Maths {
+
+	//--------------------------------------------------------------------
+	void FastTrig::SinCos( std::span<const f32> _angles, std::span<f32> _sin, std::span<f32> _cos )
+	{
+		assert( _sin.size() >= _angles.size() && _cos.size() >= _angles.size() );
+
+		const size_t count = _angles.size();
+		size_t i = 0;
+
+#if WRAP_SIMD_SSE
+		for ( ; i + 4 <= count; i += 4 )
+		{
+			__m128 s, c;
+			SinCos( _mm_loadu_ps( &_angles[i] ), s, c );
+			_mm_storeu_ps( &_sin[i], s );
+			_mm_storeu_ps( &_cos[i], c );
+		}
+#endif
+		for ( ; i < count; i++ )
+		{
+			SinCos( _angles[i], _sin[i], _cos[i] );
+		}
+	}
+
+} // end namespace Maths
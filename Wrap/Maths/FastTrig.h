@@ -0,0 +1,96 @@
+#pragma once
+
+#include "../Utils/Common.h"
+#include <cmath>
+#include <span>
+
+#include "Simd.h"
+
+namespace Maths {
+
+	// Polynomial sine and cosine computed together, about 1e-7 absolute error within a few thousand radians (1e-6 up to 1e5).
+	// Cheaper than libm and branch-free, so four angles cost about as much as one.
+	class FastTrig
+	{
+	public:
+		// Radians
+		static void SinCos( f32 _angle, f32& _sin, f32& _cos );
+
+#if WRAP_SIMD_SSE
+		static void SinCos( __m128 _angles, __m128& _sin, __m128& _cos );
+#endif
+
+		// Radians, output spans must hold as many elements as _angles
+		static void SinCos( std::span<const f32> _angles, std::span<f32> _sin, std::span<f32> _cos );
+	};
+
+	namespace FastTrigDetail {
+		// Cody-Waite split of pi/2, the first parts are exact in float so the reduction stays accurate
+		constexpr f32 TWO_OVER_PI = 0.636619772367581343f;
+		constexpr f32 HALF_PI_1 = 1.5703125f;
+		constexpr f32 HALF_PI_2 = 4.837512969970703125e-4f;
+		constexpr f32 HALF_PI_3 = 7.54978995489188216e-8f;
+
+		// Minimax fits on [-pi/4, pi/4]
+		constexpr f32 SIN_1 = -1.6666654611e-1f;
+		constexpr f32 SIN_2 = 8.3321608736e-3f;
+		constexpr f32 SIN_3 = -1.9515295891e-4f;
+		constexpr f32 COS_1 = 4.166664568298827e-2f;
+		constexpr f32 COS_2 = -1.388731625493765e-3f;
+		constexpr f32 COS_3 = 2.443315711809948e-5f;
+	} // end namespace FastTrigDetail
+
+	inline void FastTrig::SinCos( f32 _angle, f32& _sin, f32& _cos )
+	{
+		using namespace FastTrigDetail;
+
+		// Quadrant, then the remainder in [-pi/4, pi/4]
+		const f32 quadrant = std::nearbyint( _angle * TWO_OVER_PI );
+		const f32 r = ( ( _angle - quadrant * HALF_PI_1 ) - quadrant * HALF_PI_2 ) - quadrant * HALF_PI_3;
+		const f32 r2 = r * r;
+
+		const f32 s = r + r * r2 * ( SIN_1 + r2 * ( SIN_2 + r2 * SIN_3 ) );
+		const f32 c = 1.0f - 0.5f * r2 + r2 * r2 * ( COS_1 + r2 * ( COS_2 + r2 * COS_3 ) );
+
+		switch ( static_cast<int>( quadrant ) & 3 )
+		{
+		case 0: _sin = s; _cos = c; break;
+		case 1: _sin = c; _cos = -s; break;
+		case 2: _sin = -s; _cos = -c; break;
+		default: _sin = -c; _cos = s; break;
+		}
+	}
+
+#if WRAP_SIMD_SSE
+	inline void FastTrig::SinCos( __m128 _angles, __m128& _sin, __m128& _cos )
+	{
+		using namespace FastTrigDetail;
+
+		// Round to nearest, the default MXCSR mode
+		const __m128i quadrant = _mm_cvtps_epi32( _mm_mul_ps( _angles, _mm_set1_ps( TWO_OVER_PI ) ) );
+		const __m128 q = _mm_cvtepi32_ps( quadrant );
+
+		__m128 r = _mm_sub_ps( _angles, _mm_mul_ps( q, _mm_set1_ps( HALF_PI_1 ) ) );
+		r = _mm_sub_ps( r, _mm_mul_ps( q, _mm_set1_ps( HALF_PI_2 ) ) );
+		r = _mm_sub_ps( r, _mm_mul_ps( q, _mm_set1_ps( HALF_PI_3 ) ) );
+		const __m128 r2 = _mm_mul_ps( r, r );
+
+		__m128 s = _mm_add_ps( _mm_set1_ps( SIN_2 ), _mm_mul_ps( r2, _mm_set1_ps( SIN_3 ) ) );
+		s = _mm_add_ps( _mm_set1_ps( SIN_1 ), _mm_mul_ps( r2, s ) );
+		s = _mm_add_ps( r, _mm_mul_ps( _mm_mul_ps( r, r2 ), s ) );
+
+		__m128 c = _mm_add_ps( _mm_set1_ps( COS_2 ), _mm_mul_ps( r2, _mm_set1_ps( COS_3 ) ) );
+		c = _mm_add_ps( _mm_set1_ps( COS_1 ), _mm_mul_ps( r2, c ) );
+		c = _mm_add_ps( _mm_sub_ps( _mm_set1_ps( 1.0f ), _mm_mul_ps( _mm_set1_ps( 0.5f ), r2 ) ), _mm_mul_ps( _mm_mul_ps( r2, r2 ), c ) );
+
+		// Odd quadrants swap sine and cosine, the sign bits come straight from the quadrant bits
+		const __m128 swap = _mm_castsi128_ps( _mm_cmpeq_epi32( _mm_and_si128( quadrant, _mm_set1_epi32( 1 ) ), _mm_set1_epi32( 1 ) ) );
+		const __m128 sinSign = _mm_castsi128_ps( _mm_slli_epi32( _mm_and_si128( quadrant, _mm_set1_epi32( 2 ) ), 30 ) );
+		const __m128 cosSign = _mm_castsi128_ps( _mm_slli_epi32( _mm_and_si128( _mm_add_epi32( quadrant, _mm_set1_epi32( 1 ) ), _mm_set1_epi32( 2 ) ), 30 ) );
+
+		_sin = _mm_xor_ps( _mm_or_ps( _mm_and_ps( swap, c ), _mm_andnot_ps( swap, s ) ), sinSign );
+		_cos = _mm_xor_ps( _mm_or_ps( _mm_and_ps( swap, s ), _mm_andnot_ps( swap, c ) ), cosSign );
+	}
+#endif
+
+} // end namespace Maths
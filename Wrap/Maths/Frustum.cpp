@@ -0,0 +1,103 @@
+#include "Frustum.h"
+
+namespace Maths {
+
+	namespace {
+		Vector4 NormalizePlane( const Vector4& _plane )
+		{
+			const f32 length = std::sqrt( _plane.x * _plane.x + _plane.y * _plane.y + _plane.z * _plane.z );
+			return length > 0.0f ? _plane * ( 1.0f / length ) : _plane;
+		}
+	} // end anonymous namespace
+
+	//--------------------------------------------------------------------
+	Frustum Scalar::ExtractFrustum( const Matrix4& _viewProjection )
+	{
+		// Gribb-Hartmann on the rows, clip space is -w <= x, y <= w and 0 <= z <= w
+		const Matrix4 rows = Scalar::Transpose( _viewProjection );
+
+		Frustum frustum;
+		frustum.m_Planes[Frustum::PLANE_LEFT] = NormalizePlane( Vector4{ rows.c4.x + rows.c1.x, rows.c4.y + rows.c1.y, rows.c4.z + rows.c1.z, rows.c4.w + rows.c1.w } );
+		frustum.m_Planes[Frustum::PLANE_RIGHT] = NormalizePlane( Vector4{ rows.c4.x - rows.c1.x, rows.c4.y - rows.c1.y, rows.c4.z - rows.c1.z, rows.c4.w - rows.c1.w } );
+		frustum.m_Planes[Frustum::PLANE_BOTTOM] = NormalizePlane( Vector4{ rows.c4.x + rows.c2.x, rows.c4.y + rows.c2.y, rows.c4.z + rows.c2.z, rows.c4.w + rows.c2.w } );
+		frustum.m_Planes[Frustum::PLANE_TOP] = NormalizePlane( Vector4{ rows.c4.x - rows.c2.x, rows.c4.y - rows.c2.y, rows.c4.z - rows.c2.z, rows.c4.w - rows.c2.w } );
+		frustum.m_Planes[Frustum::PLANE_NEAR] = NormalizePlane( rows.c3 );
+		frustum.m_Planes[Frustum::PLANE_FAR] = NormalizePlane( Vector4{ rows.c4.x - rows.c3.x, rows.c4.y - rows.c3.y, rows.c4.z - rows.c3.z, rows.c4.w - rows.c3.w } );
+		return frustum;
+	}
+
+	//--------------------------------------------------------------------
+	Frustum Frustum::FromMatrix( const Matrix4& _viewProjection )
+	{
+#if WRAP_SIMD_SSE
+		const Matrix4 rows = _viewProjection.Transpose();
+		const __m128 r1 = Load( rows.c1 );
+		const __m128 r2 = Load( rows.c2 );
+		const __m128 r3 = Load( rows.c3 );
+		const __m128 r4 = Load( rows.c4 );
+
+		// Padded to two batches of four, the zero planes are skipped by the length check
+		__m128 planes[8] = {
+			_mm_add_ps( r4, r1 ),
+			_mm_sub_ps( r4, r1 ),
+			_mm_add_ps( r4, r2 ),
+			_mm_sub_ps( r4, r2 ),
+			r3,
+			_mm_sub_ps( r4, r3 ),
+			_mm_setzero_ps(),
+			_mm_setzero_ps()
+		};
+
+		// Normal lengths of four planes at once, transposed so each lane holds one plane
+		const __m128 xyzMask = _mm_castsi128_ps( _mm_set_epi32( 0, -1, -1, -1 ) );
+		auto normalizeFour = [xyzMask]( __m128* _pPlanes ) {
+			__m128 sq0 = _mm_mul_ps( _pPlanes[0], _pPlanes[0] );
+			__m128 sq1 = _mm_mul_ps( _pPlanes[1], _pPlanes[1] );
+			__m128 sq2 = _mm_mul_ps( _pPlanes[2], _pPlanes[2] );
+			__m128 sq3 = _mm_mul_ps( _pPlanes[3], _pPlanes[3] );
+			sq0 = _mm_and_ps( sq0, xyzMask );
+			sq1 = _mm_and_ps( sq1, xyzMask );
+			sq2 = _mm_and_ps( sq2, xyzMask );
+			sq3 = _mm_and_ps( sq3, xyzMask );
+			_MM_TRANSPOSE4_PS( sq0, sq1, sq2, sq3 );
+
+			const __m128 lengths = _mm_sqrt_ps( _mm_add_ps( _mm_add_ps( sq0, sq1 ), sq2 ) );
+			// Degenerate planes are left as they are
+			const __m128 valid = _mm_cmpgt_ps( lengths, _mm_setzero_ps() );
+			const __m128 scales = _mm_or_ps( _mm_and_ps( valid, _mm_div_ps( _mm_set1_ps( 1.0f ), lengths ) ), _mm_andnot_ps( valid, _mm_set1_ps( 1.0f ) ) );
+
+			_pPlanes[0] = _mm_mul_ps( _pPlanes[0], _mm_shuffle_ps( scales, scales, _MM_SHUFFLE( 0, 0, 0, 0 ) ) );
+			_pPlanes[1] = _mm_mul_ps( _pPlanes[1], _mm_shuffle_ps( scales, scales, _MM_SHUFFLE( 1, 1, 1, 1 ) ) );
+			_pPlanes[2] = _mm_mul_ps( _pPlanes[2], _mm_shuffle_ps( scales, scales, _MM_SHUFFLE( 2, 2, 2, 2 ) ) );
+			_pPlanes[3] = _mm_mul_ps( _pPlanes[3], _mm_shuffle_ps( scales, scales, _MM_SHUFFLE( 3, 3, 3, 3 ) ) );
+		};
+
+		normalizeFour( &planes[0] );
+		normalizeFour( &planes[4] );
+
+		Frustum frustum;
+		for ( u32 p = 0; p < PLANE_COUNT; p++ )
+		{
+			Store( frustum.m_Planes[p], planes[p] );
+		}
+		return frustum;
+#else
+		return Scalar::ExtractFrustum( _viewProjection );
+#endif
+	}
+
+	//--------------------------------------------------------------------
+	bool Frustum::intersectsSphere( const Vector3& _center, f32 _radius ) const
+	{
+		const Vector4 center{ _center.x, _center.y, _center.z, 1.0f };
+
+		for ( const Vector4& plane : m_Planes )
+		{
+			if ( Vector4::Dot( plane, center ) < -_radius )
+				return false;
+		}
+
+		return true;
+	}
+
+} // end namespace Maths
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "../Utils/Common.h"
+#include <array>
+
+#include "Matrix4.h"
+#include "Vector3.h"
+#include "Vector4.h"
+
+namespace Maths {
+
+	// Six clip planes as ( normal, distance ), normals point inside and are unit length.
+	// Plane names avoid NEAR/FAR, windows.h defines them as macros.
+	struct Frustum final
+	{
+		enum Plane : u32 {
+			PLANE_LEFT,
+			PLANE_RIGHT,
+			PLANE_BOTTOM,
+			PLANE_TOP,
+			PLANE_NEAR,
+			PLANE_FAR,
+			PLANE_COUNT
+		};
+
+		std::array<Vector4, PLANE_COUNT> m_Planes{};
+
+		// Planes of projection * view (world space) or of a projection alone (view space), Vulkan 0..1 depth
+		static Frustum FromMatrix( const Matrix4& _viewProjection );
+
+		bool intersectsSphere( const Vector3& _center, f32 _radius ) const;
+	};
+
+	namespace Scalar {
+		Frustum ExtractFrustum( const Matrix4& _viewProjection );
+	} // end namespace Scalar
+
+} // end namespace Maths
@@ -1,6 +1,258 @@
 #include "Matrix4.h"
 
+#include <cassert>
+
 namespace Maths {
 
+	namespace {
+#if WRAP_SIMD_SSE
+		// ( y, z, x ) ordering used by cross products, w stays in place
+		inline __m128 ShuffleYZX( __m128 _v ) { return _mm_shuffle_ps( _v, _v, _MM_SHUFFLE( 3, 0, 2, 1 ) ); };
+
+		inline __m128 Cross( __m128 _a, __m128 _b )
+		{
+			// a x b = ( a * b.yzx - a.yzx * b ).yzx, w is 0 when both inputs have w = 0
+			const __m128 result = _mm_sub_ps( _mm_mul_ps( _a, ShuffleYZX( _b ) ), _mm_mul_ps( ShuffleYZX( _a ), _b ) );
+			return ShuffleYZX( result );
+		}
+
+		// Four interleaved xyz triplets to one register per component
+		inline void DeinterleaveXYZ( const f32* _pSrc, __m128& _x, __m128& _y, __m128& _z )
+		{
+			const __m128 a = _mm_loadu_ps( _pSrc );     // x0 y0 z0 x1
+			const __m128 b = _mm_loadu_ps( _pSrc + 4 ); // y1 z1 x2 y2
+			const __m128 c = _mm_loadu_ps( _pSrc + 8 ); // z2 x3 y3 z3
+
+			_x = _mm_shuffle_ps( a, _mm_shuffle_ps( b, c, _MM_SHUFFLE( 1, 1, 2, 2 ) ), _MM_SHUFFLE( 2, 0, 3, 0 ) );
+			_y = _mm_shuffle_ps( _mm_shuffle_ps( a, b, _MM_SHUFFLE( 0, 0, 1, 1 ) ), _mm_shuffle_ps( b, c, _MM_SHUFFLE( 2, 2, 3, 3 ) ), _MM_SHUFFLE( 2, 0, 2, 0 ) );
+			_z = _mm_shuffle_ps( _mm_shuffle_ps( a, b, _MM_SHUFFLE( 1, 1, 2, 2 ) ), c, _MM_SHUFFLE( 3, 0, 2, 0 ) );
+		}
+
+		inline void InterleaveXYZ( f32* _pDest, __m128 _x, __m128 _y, __m128 _z )
+		{
+			const __m128 a = _mm_shuffle_ps( _mm_shuffle_ps( _x, _y, _MM_SHUFFLE( 0, 0, 0, 0 ) ), _mm_shuffle_ps( _z, _x, _MM_SHUFFLE( 1, 1, 0, 0 ) ), _MM_SHUFFLE( 2, 0, 2, 0 ) );
+			const __m128 b = _mm_shuffle_ps( _mm_shuffle_ps( _y, _z, _MM_SHUFFLE( 1, 1, 1, 1 ) ), _mm_shuffle_ps( _x, _y, _MM_SHUFFLE( 2, 2, 2, 2 ) ), _MM_SHUFFLE( 2, 0, 2, 0 ) );
+			const __m128 c = _mm_shuffle_ps( _mm_shuffle_ps( _z, _x, _MM_SHUFFLE( 3, 3, 2, 2 ) ), _mm_shuffle_ps( _y, _z, _MM_SHUFFLE( 3, 3, 3, 3 ) ), _MM_SHUFFLE( 2, 0, 2, 0 ) );
+
+			_mm_storeu_ps( _pDest, a );
+			_mm_storeu_ps( _pDest + 4, b );
+			_mm_storeu_ps( _pDest + 8, c );
+		}
+
+		// Four inputs per iteration in SoA form, every matrix element is broadcast once outside the loop
+		template<bool Translate>
+		void TransformBatch( const Matrix4& _m, std::span<const Vector3> _in, std::span<Vector3> _out )
+		{
+			static_assert( sizeof( Vector3 ) == 3 * sizeof( f32 ) );
+
+			const __m128 m00 = _mm_set1_ps( _m.c1.x ), m01 = _mm_set1_ps( _m.c1.y ), m02 = _mm_set1_ps( _m.c1.z );
+			const __m128 m10 = _mm_set1_ps( _m.c2.x ), m11 = _mm_set1_ps( _m.c2.y ), m12 = _mm_set1_ps( _m.c2.z );
+			const __m128 m20 = _mm_set1_ps( _m.c3.x ), m21 = _mm_set1_ps( _m.c3.y ), m22 = _mm_set1_ps( _m.c3.z );
+			const __m128 tx = _mm_set1_ps( Translate ? _m.c4.x : 0.0f );
+			const __m128 ty = _mm_set1_ps( Translate ? _m.c4.y : 0.0f );
+			const __m128 tz = _mm_set1_ps( Translate ? _m.c4.z : 0.0f );
+
+			const size_t count = _in.size();
+			const size_t batchEnd = count & ~size_t( 3 );
+
+			for ( size_t i = 0; i < batchEnd; i += 4 )
+			{
+				__m128 x, y, z;
+				DeinterleaveXYZ( &_in[i].x, x, y, z );
+
+				const __m128 ox = _mm_add_ps( _mm_add_ps( _mm_mul_ps( m00, x ), _mm_mul_ps( m10, y ) ), _mm_add_ps( _mm_mul_ps( m20, z ), tx ) );
+				const __m128 oy = _mm_add_ps( _mm_add_ps( _mm_mul_ps( m01, x ), _mm_mul_ps( m11, y ) ), _mm_add_ps( _mm_mul_ps( m21, z ), ty ) );
+				const __m128 oz = _mm_add_ps( _mm_add_ps( _mm_mul_ps( m02, x ), _mm_mul_ps( m12, y ) ), _mm_add_ps( _mm_mul_ps( m22, z ), tz ) );
+
+				InterleaveXYZ( &_out[i].x, ox, oy, oz );
+			}
+
+			for ( size_t i = batchEnd; i < count; i++ )
+			{
+				_out[i] = Translate ? _m.TransformPoint( _in[i] ) : _m.TransformVector( _in[i] );
+			}
+		}
+#endif
+
+		template<bool Translate>
+		Vector3 TransformScalar( const Matrix4& _m, const Vector3& _v )
+		{
+			const f32 w = Translate ? 1.0f : 0.0f;
+			return Vector3{
+				.x = _m.c1.x * _v.x + _m.c2.x * _v.y + _m.c3.x * _v.z + _m.c4.x * w,
+				.y = _m.c1.y * _v.x + _m.c2.y * _v.y + _m.c3.y * _v.z + _m.c4.y * w,
+				.z = _m.c1.z * _v.x + _m.c2.z * _v.y + _m.c3.z * _v.z + _m.c4.z * w
+			};
+		}
+	} // end anonymous namespace
+
+	//--------------------------------------------------------------------
+	Matrix4 Scalar::Transpose( const Matrix4& _m )
+	{
+		return Matrix4{
+			.c1 = Vector4{ _m.c1.x, _m.c2.x, _m.c3.x, _m.c4.x },
+			.c2 = Vector4{ _m.c1.y, _m.c2.y, _m.c3.y, _m.c4.y },
+			.c3 = Vector4{ _m.c1.z, _m.c2.z, _m.c3.z, _m.c4.z },
+			.c4 = Vector4{ _m.c1.w, _m.c2.w, _m.c3.w, _m.c4.w }
+		};
+	}
+
+	//--------------------------------------------------------------------
+	Matrix4 Scalar::AffineInverse( const Matrix4& _m )
+	{
+		const Vector3 a{ _m.c1.x, _m.c1.y, _m.c1.z };
+		const Vector3 b{ _m.c2.x, _m.c2.y, _m.c2.z };
+		const Vector3 c{ _m.c3.x, _m.c3.y, _m.c3.z };
+		const Vector3 t{ _m.c4.x, _m.c4.y, _m.c4.z };
+
+		// Rows of the inverse 3x3 are the cross products of the columns over the determinant
+		const Vector3 r0 = LinAlg::Cross( b, c );
+		const Vector3 r1 = LinAlg::Cross( c, a );
+		const Vector3 r2 = LinAlg::Cross( a, b );
+		const f32 det = LinAlg::Dot( a, r0 );
+		assert( det != 0.0f );
+		const f32 invDet = 1.0f / det;
+
+		const Vector3 i0{ r0.x * invDet, r0.y * invDet, r0.z * invDet };
+		const Vector3 i1{ r1.x * invDet, r1.y * invDet, r1.z * invDet };
+		const Vector3 i2{ r2.x * invDet, r2.y * invDet, r2.z * invDet };
+
+		return Matrix4{
+			.c1 = Vector4{ i0.x, i1.x, i2.x, 0.0f },
+			.c2 = Vector4{ i0.y, i1.y, i2.y, 0.0f },
+			.c3 = Vector4{ i0.z, i1.z, i2.z, 0.0f },
+			.c4 = Vector4{ -LinAlg::Dot( i0, t ), -LinAlg::Dot( i1, t ), -LinAlg::Dot( i2, t ), 1.0f }
+		};
+	}
+
+	//--------------------------------------------------------------------
+	void Scalar::TransformPoints( const Matrix4& _m, std::span<const Vector3> _points, std::span<Vector3> _out )
+	{
+		assert( _out.size() >= _points.size() );
+		for ( size_t i = 0; i < _points.size(); i++ )
+		{
+			_out[i] = TransformScalar<true>( _m, _points[i] );
+		}
+	}
+
+	//--------------------------------------------------------------------
+	void Scalar::TransformVectors( const Matrix4& _m, std::span<const Vector3> _vectors, std::span<Vector3> _out )
+	{
+		assert( _out.size() >= _vectors.size() );
+		for ( size_t i = 0; i < _vectors.size(); i++ )
+		{
+			_out[i] = TransformScalar<false>( _m, _vectors[i] );
+		}
+	}
+
+	//--------------------------------------------------------------------
+	Vector4 Matrix4::operator*( const Vector4& _rhs ) const
+	{
+#if WRAP_SIMD_SSE
+		return ToVector4( MultiplyColumns( *this, Load( _rhs ) ) );
+#else
+		return Vector4{
+			.x = c1.x * _rhs.x + c2.x * _rhs.y + c3.x * _rhs.z + c4.x * _rhs.w,
+			.y = c1.y * _rhs.x + c2.y * _rhs.y + c3.y * _rhs.z + c4.y * _rhs.w,
+			.z = c1.z * _rhs.x + c2.z * _rhs.y + c3.z * _rhs.z + c4.z * _rhs.w,
+			.w = c1.w * _rhs.x + c2.w * _rhs.y + c3.w * _rhs.z + c4.w * _rhs.w
+		};
+#endif
+	}
+
+	//--------------------------------------------------------------------
+	Matrix4 Matrix4::Transpose() const
+	{
+#if WRAP_SIMD_SSE
+		__m128 r1 = Load( c1 ), r2 = Load( c2 ), r3 = Load( c3 ), r4 = Load( c4 );
+		_MM_TRANSPOSE4_PS( r1, r2, r3, r4 );
+
+		Matrix4 result;
+		Store( result.c1, r1 );
+		Store( result.c2, r2 );
+		Store( result.c3, r3 );
+		Store( result.c4, r4 );
+		return result;
+#else
+		return Scalar::Transpose( *this );
+#endif
+	}
+
+	//--------------------------------------------------------------------
+	Matrix4 Matrix4::AffineInverse() const
+	{
+#if WRAP_SIMD_SSE
+		// w of the first three columns is 0 for affine matrices, the cross products and dot keep it that way
+		const __m128 a = Load( c1 ), b = Load( c2 ), c = Load( c3 );
+
+		__m128 r0 = Cross( b, c );
+		__m128 r1 = Cross( c, a );
+		__m128 r2 = Cross( a, b );
+
+		__m128 det = _mm_mul_ps( a, r0 );
+		det = _mm_add_ps( det, _mm_shuffle_ps( det, det, _MM_SHUFFLE( 2, 3, 0, 1 ) ) );
+		det = _mm_add_ps( det, _mm_shuffle_ps( det, det, _MM_SHUFFLE( 1, 0, 3, 2 ) ) );
+		assert( _mm_cvtss_f32( det ) != 0.0f );
+
+		const __m128 invDet = _mm_div_ps( _mm_set1_ps( 1.0f ), det );
+		r0 = _mm_mul_ps( r0, invDet );
+		r1 = _mm_mul_ps( r1, invDet );
+		r2 = _mm_mul_ps( r2, invDet );
+
+		// Inverse rows to columns, the fourth row becomes ( 0 0 0 0 ) and w of every column 0
+		__m128 r3 = _mm_setzero_ps();
+		_MM_TRANSPOSE4_PS( r0, r1, r2, r3 );
+
+		Matrix4 result;
+		Store( result.c1, r0 );
+		Store( result.c2, r1 );
+		Store( result.c3, r2 );
+
+		// -inverse3x3 * t, then w = 1
+		const __m128 t = Load( c4 );
+		__m128 translation = _mm_mul_ps( r0, _mm_shuffle_ps( t, t, _MM_SHUFFLE( 0, 0, 0, 0 ) ) );
+		translation = _mm_add_ps( translation, _mm_mul_ps( r1, _mm_shuffle_ps( t, t, _MM_SHUFFLE( 1, 1, 1, 1 ) ) ) );
+		translation = _mm_add_ps( translation, _mm_mul_ps( r2, _mm_shuffle_ps( t, t, _MM_SHUFFLE( 2, 2, 2, 2 ) ) ) );
+		translation = _mm_sub_ps( _mm_set_ps( 1.0f, 0.0f, 0.0f, 0.0f ), translation );
+		Store( result.c4, translation );
+		return result;
+#else
+		return Scalar::AffineInverse( *this );
+#endif
+	}
+
+	//--------------------------------------------------------------------
+	Vector3 Matrix4::TransformPoint( const Vector3& _point ) const
+	{
+		return TransformScalar<true>( *this, _point );
+	}
+
+	//--------------------------------------------------------------------
+	Vector3 Matrix4::TransformVector( const Vector3& _vector ) const
+	{
+		return TransformScalar<false>( *this, _vector );
+	}
+
+	//--------------------------------------------------------------------
+	void Matrix4::TransformPoints( std::span<const Vector3> _points, std::span<Vector3> _out ) const
+	{
+		assert( _out.size() >= _points.size() );
+#if WRAP_SIMD_SSE
+		TransformBatch<true>( *this, _points, _out );
+#else
+		Scalar::TransformPoints( *this, _points, _out );
+#endif
+	}
+
+	//--------------------------------------------------------------------
+	void Matrix4::TransformVectors( std::span<const Vector3> _vectors, std::span<Vector3> _out ) const
+	{
+		assert( _out.size() >= _vectors.size() );
+#if WRAP_SIMD_SSE
+		TransformBatch<false>( *this, _vectors, _out );
+#else
+		Scalar::TransformVectors( *this, _vectors, _out );
+#endif
+	}
 
-} // end namespace Maths
\ No newline at end of file
+} // end namespace Maths
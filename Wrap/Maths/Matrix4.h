@@ -1,5 +1,10 @@
 #pragma once
 
+#include "../Utils/Common.h"
+#include <span>
+#include <type_traits>
+
+#include "Simd.h"
 #include "Vector4.h"
 #include "Vector3.h"
 #include "../Utils/UnitConvert.h"
@@ -12,10 +17,38 @@ namespace Maths {
 		RADIANS
 	};
 
+	struct Matrix4;
+
+	// Reference implementations, used when SIMD is unavailable and as the baseline of the maths benchmarks
+	namespace Scalar {
+		constexpr Matrix4 Multiply( const Matrix4& _lhs, const Matrix4& _rhs );
+		Matrix4 Transpose( const Matrix4& _m );
+		Matrix4 AffineInverse( const Matrix4& _m );
+		void TransformPoints( const Matrix4& _m, std::span<const Vector3> _points, std::span<Vector3> _out );
+		void TransformVectors( const Matrix4& _m, std::span<const Vector3> _vectors, std::span<Vector3> _out );
+	} // end namespace Scalar
+
+	// Column-major, columns are 16-byte aligned SIMD registers
 	struct Matrix4 final
 	{
 		Vector4 c1{}, c2{}, c3{}, c4{};
 
+		constexpr Matrix4 operator*( const Matrix4& _rhs ) const;
+		Vector4 operator*( const Vector4& _rhs ) const;
+
+		Matrix4 Transpose() const;
+		// Only valid for affine matrices (last row 0 0 0 1), scale and shear included
+		Matrix4 AffineInverse() const;
+
+		// w = 1, translation applies
+		Vector3 TransformPoint( const Vector3& _point ) const;
+		// w = 0, translation ignored
+		Vector3 TransformVector( const Vector3& _vector ) const;
+
+		// Batch versions, _out must hold as many elements as the input and may alias it
+		void TransformPoints( std::span<const Vector3> _points, std::span<Vector3> _out ) const;
+		void TransformVectors( std::span<const Vector3> _vectors, std::span<Vector3> _out ) const;
+
 		constexpr static Matrix4 Identity();
 		inline static Matrix4 DefaultModelMatrix();
 		inline static Matrix4 Model( const Vector3& _pos, const Vector3& _rot, const Vector3& _scale, AngleUnit _angleUnit = AngleUnit::DEGREES );
@@ -33,6 +66,48 @@ namespace Maths {
 		};
 	}
 
+	constexpr Maths::Matrix4 Scalar::Multiply( const Matrix4& _lhs, const Matrix4& _rhs )
+	{
+		// Columns are stored, so each result column is _lhs applied to a column of _rhs
+		auto column = [&_lhs]( const Vector4& _c ) {
+			return Vector4{
+				.x = _lhs.c1.x * _c.x + _lhs.c2.x * _c.y + _lhs.c3.x * _c.z + _lhs.c4.x * _c.w,
+				.y = _lhs.c1.y * _c.x + _lhs.c2.y * _c.y + _lhs.c3.y * _c.z + _lhs.c4.y * _c.w,
+				.z = _lhs.c1.z * _c.x + _lhs.c2.z * _c.y + _lhs.c3.z * _c.z + _lhs.c4.z * _c.w,
+				.w = _lhs.c1.w * _c.x + _lhs.c2.w * _c.y + _lhs.c3.w * _c.z + _lhs.c4.w * _c.w
+			};
+		};
+
+		return Matrix4{ .c1 = column( _rhs.c1 ), .c2 = column( _rhs.c2 ), .c3 = column( _rhs.c3 ), .c4 = column( _rhs.c4 ) };
+	}
+
+#if WRAP_SIMD_SSE
+	// Linear combination of the columns, the building block of every product
+	inline __m128 MultiplyColumns( const Matrix4& _m, __m128 _v )
+	{
+		__m128 result = _mm_mul_ps( Load( _m.c1 ), _mm_shuffle_ps( _v, _v, _MM_SHUFFLE( 0, 0, 0, 0 ) ) );
+		result = _mm_add_ps( result, _mm_mul_ps( Load( _m.c2 ), _mm_shuffle_ps( _v, _v, _MM_SHUFFLE( 1, 1, 1, 1 ) ) ) );
+		result = _mm_add_ps( result, _mm_mul_ps( Load( _m.c3 ), _mm_shuffle_ps( _v, _v, _MM_SHUFFLE( 2, 2, 2, 2 ) ) ) );
+		return _mm_add_ps( result, _mm_mul_ps( Load( _m.c4 ), _mm_shuffle_ps( _v, _v, _MM_SHUFFLE( 3, 3, 3, 3 ) ) ) );
+	}
+#endif
+
+	constexpr Maths::Matrix4 Matrix4::operator*( const Matrix4& _rhs ) const
+	{
+#if WRAP_SIMD_SSE
+		if ( !std::is_constant_evaluated() )
+		{
+			Matrix4 result;
+			Store( result.c1, MultiplyColumns( *this, Load( _rhs.c1 ) ) );
+			Store( result.c2, MultiplyColumns( *this, Load( _rhs.c2 ) ) );
+			Store( result.c3, MultiplyColumns( *this, Load( _rhs.c3 ) ) );
+			Store( result.c4, MultiplyColumns( *this, Load( _rhs.c4 ) ) );
+			return result;
+		}
+#endif
+		return Scalar::Multiply( *this, _rhs );
+	}
+
 	Maths::Matrix4 Matrix4::DefaultModelMatrix()
 	{
 		return Matrix4::Model( Maths::Vector3{ 0.0f, 0.0f, 0.f }, Maths::Vector3{ 0.0f, 0.0f, 0.0f }, Maths::Vector3{ 1.0f, 1.0f, 1.0f } );
@@ -62,9 +137,9 @@ namespace Maths {
 		const f32 m10 = cz * sx * sy + cx * sz;
 		const f32 m11 = cx * cz - sx * sy * sz;
 		const f32 m12 = -sx * cy;
-		const f32 m20 = -sy * cz;
-		const f32 m21 = sy * sz;
-		const f32 m22 = cy;
+		const f32 m20 = sx * sz - cx * sy * cz;
+		const f32 m21 = cx * sy * sz + sx * cz;
+		const f32 m22 = cx * cy;
 
 		return Matrix4{
 			.c1 = Vector4{ m00 * _scale.x, m01 * _scale.x, m02 * _scale.x, 0.0f },
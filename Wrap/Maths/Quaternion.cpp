@@ -0,0 +1,173 @@
+#include "Quaternion.h"
+
+#include "FastTrig.h"
+
+namespace Maths {
+
+	namespace {
+		// Below this angle between the inputs slerp and nlerp differ by less than float precision
+		constexpr f32 SLERP_DOT_THRESHOLD = 0.9995f;
+	} // end anonymous namespace
+
+	//--------------------------------------------------------------------
+	Vector3 Quaternion::Rotate( const Vector3& _v ) const
+	{
+		// v + 2w (u x v) + 2 u x (u x v), cheaper than q v q*
+		const Vector3 u{ x, y, z };
+		const Vector3 t = LinAlg::Cross( u, _v );
+		const Vector3 t2{ t.x * 2.0f, t.y * 2.0f, t.z * 2.0f };
+		const Vector3 ut = LinAlg::Cross( u, t2 );
+
+		return Vector3{ .x = _v.x + w * t2.x + ut.x, .y = _v.y + w * t2.y + ut.y, .z = _v.z + w * t2.z + ut.z };
+	}
+
+	//--------------------------------------------------------------------
+	Matrix4 Quaternion::ToMatrix() const
+	{
+		return ToModelMatrix( Vector3{}, Vector3{ 1.0f, 1.0f, 1.0f } );
+	}
+
+	//--------------------------------------------------------------------
+	Matrix4 Quaternion::ToModelMatrix( const Vector3& _position, const Vector3& _scale ) const
+	{
+		const f32 xx = x * x, yy = y * y, zz = z * z;
+		const f32 xy = x * y, xz = x * z, yz = y * z;
+		const f32 wx = w * x, wy = w * y, wz = w * z;
+
+		return Matrix4{
+			.c1 = Vector4{ ( 1.0f - 2.0f * ( yy + zz ) ) * _scale.x, 2.0f * ( xy + wz ) * _scale.x, 2.0f * ( xz - wy ) * _scale.x, 0.0f },
+			.c2 = Vector4{ 2.0f * ( xy - wz ) * _scale.y, ( 1.0f - 2.0f * ( xx + zz ) ) * _scale.y, 2.0f * ( yz + wx ) * _scale.y, 0.0f },
+			.c3 = Vector4{ 2.0f * ( xz + wy ) * _scale.z, 2.0f * ( yz - wx ) * _scale.z, ( 1.0f - 2.0f * ( xx + yy ) ) * _scale.z, 0.0f },
+			.c4 = Vector4{ _position.x, _position.y, _position.z, 1.0f }
+		};
+	}
+
+	//--------------------------------------------------------------------
+	Quaternion Quaternion::FromAxisAngle( const Vector3& _axis, f32 _angle, AngleUnit _angleUnit /*= AngleUnit::DEGREES*/ )
+	{
+		if ( _angleUnit != AngleUnit::RADIANS )
+		{
+			_angle = Utils::UnitConvert::DegreesToRadians( _angle );
+		}
+
+		Vector3 axis = _axis;
+		axis.Normalize();
+
+		f32 s, c;
+		FastTrig::SinCos( _angle * 0.5f, s, c );
+		return Quaternion{ .x = axis.x * s, .y = axis.y * s, .z = axis.z * s, .w = c };
+	}
+
+	//--------------------------------------------------------------------
+	Quaternion Quaternion::FromEuler( const Vector3& _angles, AngleUnit _angleUnit /*= AngleUnit::DEGREES*/ )
+	{
+		// Matrix4::Model is the transpose of Rx * Ry * Rz, the same rotation with every angle negated in reverse order
+		const f32 toHalfRadians = _angleUnit != AngleUnit::RADIANS ? -0.5f * Utils::UnitConvert::DegreesToRadians( 1.0f ) : -0.5f;
+
+		f32 sx, cx, sy, cy, sz, cz;
+#if WRAP_SIMD_SSE
+		// All three half angles in one call
+		__m128 sines, cosines;
+		FastTrig::SinCos( _mm_mul_ps( _mm_setr_ps( _angles.x, _angles.y, _angles.z, 0.0f ), _mm_set1_ps( toHalfRadians ) ), sines, cosines );
+
+		alignas( 16 ) f32 s[4], c[4];
+		_mm_store_ps( s, sines );
+		_mm_store_ps( c, cosines );
+		sx = s[0]; sy = s[1]; sz = s[2];
+		cx = c[0]; cy = c[1]; cz = c[2];
+#else
+		FastTrig::SinCos( _angles.x * toHalfRadians, sx, cx );
+		FastTrig::SinCos( _angles.y * toHalfRadians, sy, cy );
+		FastTrig::SinCos( _angles.z * toHalfRadians, sz, cz );
+#endif
+
+		const Quaternion qx{ .x = sx, .y = 0.0f, .z = 0.0f, .w = cx };
+		const Quaternion qy{ .x = 0.0f, .y = sy, .z = 0.0f, .w = cy };
+		const Quaternion qz{ .x = 0.0f, .y = 0.0f, .z = sz, .w = cz };
+
+		return qz * qy * qx;
+	}
+
+	//--------------------------------------------------------------------
+	Quaternion Quaternion::FromRotationMatrix( const Matrix4& _rotation )
+	{
+		// Rows and columns named as in the usual row-major notation
+		const f32 m00 = _rotation.c1.x, m10 = _rotation.c1.y, m20 = _rotation.c1.z;
+		const f32 m01 = _rotation.c2.x, m11 = _rotation.c2.y, m21 = _rotation.c2.z;
+		const f32 m02 = _rotation.c3.x, m12 = _rotation.c3.y, m22 = _rotation.c3.z;
+
+		// Divide by the largest component so the square root never runs on a tiny, imprecise value
+		const f32 trace = m00 + m11 + m22;
+		Quaternion q;
+
+		if ( trace > 0.0f )
+		{
+			const f32 s = std::sqrt( trace + 1.0f ) * 2.0f;
+			q = Quaternion{ .x = ( m21 - m12 ) / s, .y = ( m02 - m20 ) / s, .z = ( m10 - m01 ) / s, .w = 0.25f * s };
+		}
+		else if ( m00 > m11 && m00 > m22 )
+		{
+			const f32 s = std::sqrt( 1.0f + m00 - m11 - m22 ) * 2.0f;
+			q = Quaternion{ .x = 0.25f * s, .y = ( m01 + m10 ) / s, .z = ( m02 + m20 ) / s, .w = ( m21 - m12 ) / s };
+		}
+		else if ( m11 > m22 )
+		{
+			const f32 s = std::sqrt( 1.0f + m11 - m00 - m22 ) * 2.0f;
+			q = Quaternion{ .x = ( m01 + m10 ) / s, .y = 0.25f * s, .z = ( m12 + m21 ) / s, .w = ( m02 - m20 ) / s };
+		}
+		else
+		{
+			const f32 s = std::sqrt( 1.0f + m22 - m00 - m11 ) * 2.0f;
+			q = Quaternion{ .x = ( m02 + m20 ) / s, .y = ( m12 + m21 ) / s, .z = 0.25f * s, .w = ( m10 - m01 ) / s };
+		}
+
+		return q.Normalized();
+	}
+
+	//--------------------------------------------------------------------
+	Quaternion Quaternion::Nlerp( const Quaternion& _from, const Quaternion& _to, f32 _t )
+	{
+		// q and -q are the same rotation, pick the one on the short arc
+		const f32 sign = Dot( _from, _to ) < 0.0f ? -1.0f : 1.0f;
+		const f32 a = 1.0f - _t;
+		const f32 b = _t * sign;
+
+		return Quaternion{
+			.x = _from.x * a + _to.x * b,
+			.y = _from.y * a + _to.y * b,
+			.z = _from.z * a + _to.z * b,
+			.w = _from.w * a + _to.w * b
+		}.Normalized();
+	}
+
+	//--------------------------------------------------------------------
+	Quaternion Quaternion::Slerp( const Quaternion& _from, const Quaternion& _to, f32 _t )
+	{
+		f32 cosTheta = Dot( _from, _to );
+		const f32 sign = cosTheta < 0.0f ? -1.0f : 1.0f;
+		cosTheta *= sign;
+
+		if ( cosTheta > SLERP_DOT_THRESHOLD )
+		{
+			return Nlerp( _from, _to, _t );
+		}
+
+		const f32 theta = std::acos( cosTheta );
+		const f32 invSinTheta = 1.0f / std::sqrt( 1.0f - cosTheta * cosTheta );
+
+		f32 sinFrom, sinTo, unused;
+		FastTrig::SinCos( ( 1.0f - _t ) * theta, sinFrom, unused );
+		FastTrig::SinCos( _t * theta, sinTo, unused );
+
+		const f32 a = sinFrom * invSinTheta;
+		const f32 b = sinTo * invSinTheta * sign;
+
+		return Quaternion{
+			.x = _from.x * a + _to.x * b,
+			.y = _from.y * a + _to.y * b,
+			.z = _from.z * a + _to.z * b,
+			.w = _from.w * a + _to.w * b
+		};
+	}
+
+} // end namespace Maths
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "../Utils/Common.h"
+
+#include "Matrix4.h"
+#include "Vector3.h"
+
+namespace Maths {
+
+	// Rotation as a unit quaternion, ( x, y, z ) is the vector part.
+	// Composes and interpolates without trig, and turns into a matrix with a handful of multiplies.
+	struct alignas( 16 ) Quaternion final
+	{
+		f32 x{}, y{}, z{}, w{ 1.0f };
+
+		// Applies _rhs first, then this rotation
+		constexpr Quaternion operator*( const Quaternion& _rhs ) const;
+
+		constexpr Quaternion Conjugate() const { return Quaternion{ .x = -x, .y = -y, .z = -z, .w = w }; };
+		inline Quaternion Normalized() const;
+
+		Vector3 Rotate( const Vector3& _v ) const;
+
+		// Rotation only
+		Matrix4 ToMatrix() const;
+		// Scale, then rotation, then translation, the layout of Matrix4::Model
+		Matrix4 ToModelMatrix( const Vector3& _position, const Vector3& _scale ) const;
+
+		constexpr static Quaternion Identity() { return Quaternion{}; };
+		static Quaternion FromAxisAngle( const Vector3& _axis, f32 _angle, AngleUnit _angleUnit = AngleUnit::DEGREES );
+		// Same convention as Matrix4::Model, so Euler-authored content keeps its orientation
+		static Quaternion FromEuler( const Vector3& _angles, AngleUnit _angleUnit = AngleUnit::DEGREES );
+		// Upper 3x3 must be a pure rotation, divide scale out of the columns first
+		static Quaternion FromRotationMatrix( const Matrix4& _rotation );
+
+		constexpr static f32 Dot( const Quaternion& _a, const Quaternion& _b );
+		// Normalized lerp along the shortest arc, the default for animation blending
+		static Quaternion Nlerp( const Quaternion& _from, const Quaternion& _to, f32 _t );
+		// Constant angular velocity, only worth its extra cost for wide arcs
+		static Quaternion Slerp( const Quaternion& _from, const Quaternion& _to, f32 _t );
+	};
+
+	constexpr Maths::Quaternion Maths::Quaternion::operator*( const Quaternion& _rhs ) const
+	{
+		return Quaternion{
+			.x = w * _rhs.x + x * _rhs.w + y * _rhs.z - z * _rhs.y,
+			.y = w * _rhs.y - x * _rhs.z + y * _rhs.w + z * _rhs.x,
+			.z = w * _rhs.z + x * _rhs.y - y * _rhs.x + z * _rhs.w,
+			.w = w * _rhs.w - x * _rhs.x - y * _rhs.y - z * _rhs.z
+		};
+	}
+
+	constexpr f32 Maths::Quaternion::Dot( const Quaternion& _a, const Quaternion& _b )
+	{
+		return _a.x * _b.x + _a.y * _b.y + _a.z * _b.z + _a.w * _b.w;
+	}
+
+	inline Maths::Quaternion Maths::Quaternion::Normalized() const
+	{
+		const f32 lengthSq = Dot( *this, *this );
+		if ( lengthSq == 0.0f )
+			return Identity();
+
+		const f32 invLength = 1.0f / std::sqrt( lengthSq );
+		return Quaternion{ .x = x * invLength, .y = y * invLength, .z = z * invLength, .w = w * invLength };
+	}
+
+} // end namespace Maths
@@ -0,0 +1,10 @@
+#pragma once
+
+// 128-bit SIMD selection. x64 always has SSE2, anything else takes the scalar paths.
+// Define WRAP_FORCE_SCALAR_MATHS to compare against the scalar code on x64.
+#if !defined( WRAP_FORCE_SCALAR_MATHS ) && ( defined( _M_X64 ) || defined( _M_IX86 ) || defined( __SSE2__ ) )
+	#define WRAP_SIMD_SSE 1
+	#include <emmintrin.h>
+#else
+	#define WRAP_SIMD_SSE 0
+#endif
@@ -1,10 +1,64 @@
 #pragma once
 
 #include "../Utils/Common.h"
+#include <type_traits>
+
+#include "Simd.h"
 
 namespace Maths {
-	struct Vector4 final
+	// 16-byte aligned so a whole vector is one aligned SSE load/store
+	struct alignas( 16 ) Vector4 final
 	{
 		f32 x{}, y{}, z{}, w{};
+
+		constexpr Vector4 operator+( const Vector4& _rhs ) const;
+		constexpr Vector4 operator-( const Vector4& _rhs ) const;
+		constexpr Vector4 operator*( f32 _scalar ) const;
+
+		constexpr static f32 Dot( const Vector4& _a, const Vector4& _b );
 	};
+
+#if WRAP_SIMD_SSE
+	inline __m128 Load( const Vector4& _v ) { return _mm_load_ps( &_v.x ); };
+	inline void Store( Vector4& _dest, __m128 _v ) { _mm_store_ps( &_dest.x, _v ); };
+
+	inline Vector4 ToVector4( __m128 _v )
+	{
+		Vector4 result;
+		Store( result, _v );
+		return result;
+	}
+#endif
+
+	constexpr Maths::Vector4 Maths::Vector4::operator+( const Vector4& _rhs ) const
+	{
+#if WRAP_SIMD_SSE
+		if ( !std::is_constant_evaluated() )
+			return ToVector4( _mm_add_ps( Load( *this ), Load( _rhs ) ) );
+#endif
+		return Vector4{ .x = x + _rhs.x, .y = y + _rhs.y, .z = z + _rhs.z, .w = w + _rhs.w };
+	}
+
+	constexpr Maths::Vector4 Maths::Vector4::operator-( const Vector4& _rhs ) const
+	{
+#if WRAP_SIMD_SSE
+		if ( !std::is_constant_evaluated() )
+			return ToVector4( _mm_sub_ps( Load( *this ), Load( _rhs ) ) );
+#endif
+		return Vector4{ .x = x - _rhs.x, .y = y - _rhs.y, .z = z - _rhs.z, .w = w - _rhs.w };
+	}
+
+	constexpr Maths::Vector4 Maths::Vector4::operator*( f32 _scalar ) const
+	{
+#if WRAP_SIMD_SSE
+		if ( !std::is_constant_evaluated() )
+			return ToVector4( _mm_mul_ps( Load( *this ), _mm_set1_ps( _scalar ) ) );
+#endif
+		return Vector4{ .x = x * _scalar, .y = y * _scalar, .z = z * _scalar, .w = w * _scalar };
+	}
+
+	constexpr f32 Maths::Vector4::Dot( const Vector4& _a, const Vector4& _b )
+	{
+		return _a.x * _b.x + _a.y * _b.y + _a.z * _b.z + _a.w * _b.w;
+	}
 } // end namespace Maths
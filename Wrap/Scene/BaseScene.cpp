@@ -1,153 +1,548 @@
 #include "BaseScene.h"
 
 #include <algorithm>
+#include <cmath>
+#include <type_traits>
 
 
 namespace Scene {
+	namespace {
+		// Largest deviation from the full mesh allowed on screen, as a fraction of the screen height: about a pixel at 1080p
+		constexpr f32 LOD_ERROR_THRESHOLD = 1.0f / 1080.0f;
+		// A level is kept until its error exceeds the threshold by this fraction, a coarser one is taken once below it by as much
+		constexpr f32 LOD_HYSTERESIS = 0.25f;
+
+		//--------------------------------------------------------------------
+		// Coarsest level within the threshold, moving from _current only past the hysteresis band so a camera resting on a boundary does not pop
+		u32 SelectLod( std::span<const GeometryLod> _lods, f32 _projection, u32 _current )
+		{
+			u32 lod = std::min( _current, static_cast<u32>( _lods.size() - 1 ) );
+			while ( lod > 0 && _lods[lod].m_Error * _projection > LOD_ERROR_THRESHOLD * ( 1.0f + LOD_HYSTERESIS ) )
+			{
+				lod--;
+			}
+			while ( lod + 1 < _lods.size() && _lods[lod + 1].m_Error * _projection <= LOD_ERROR_THRESHOLD * ( 1.0f - LOD_HYSTERESIS ) )
+			{
+				lod++;
+			}
+
+			return lod;
+		}
+	} // end anonymous namespace
+
 	//--------------------------------------------------------------------
 	MeshHandle BaseScene::addMesh( const Mesh& _mesh )
 	{
-		std::unique_lock<std::shared_mutex> lock( m_Mutex );
+		// Names are the lookup key, they must be unique within a scene
+		const bool uniqueName = !m_NameToHandle.contains( _mesh.getName() );
+		assert( uniqueName && _mesh.getGeometry() );
+		if ( !uniqueName || !_mesh.getGeometry() )
+		{
+			return MeshHandle{};
+		}
 
-		m_MeshData.emplace_back( _mesh );
+		auto handle = m_Meshes.insert( _mesh );
+		const Utils::NameId meshId = m_MeshNames.intern( _mesh.getName() );
+		m_Meshes.get( handle )->setNameId( meshId );
+		m_NameToHandle.emplace( _mesh.getName(), handle );
 
-		auto handle{ MeshHandle{ m_NextMeshHandleId } };
-		m_MeshHandles.emplace_back( handle );
-		updateHandleToMeshIdx();
+		[[maybe_unused]] const u32 transformIdx = m_Transforms.push( _mesh.getTransform() );
+		[[maybe_unused]] const u32 graphIdx = m_Graph.addObject( m_Transforms.getMatrices()[transformIdx] );
+		assert( transformIdx == m_Meshes.findDenseIndex( handle ) && graphIdx == transformIdx );
 
-		m_NextMeshHandleId++;
+		journalChange( MeshChange{
+			.m_Type = MeshChangeType::ADDED,
+			.m_MeshId = meshId,
+			.m_Geometry = _mesh.getGeometry(),
+			.m_Transform = m_Graph.getWorldMatrices()[transformIdx],
+			.m_Visible = _mesh.isVisible()
+		} );
 
 		return handle;
 	}
 
 	//--------------------------------------------------------------------
-	void BaseScene::updateHandleToMeshIdx()
+	void BaseScene::journalChange( MeshChange&& _change )
 	{
-		m_HandleToMeshIdxMap.clear();
+		m_StateVersion++;
+
+		// Goes out with the next published snapshot
+		_change.m_Version = m_NextVersion;
+		const Utils::NameId meshId = _change.m_MeshId;
 
-		size_t meshIdx = 0;
-		for ( auto handle : m_MeshHandles )
+		PendingEntries& pending = m_PendingMeshes[meshId];
+		// Not published yet, so no reader can have applied it: later changes fold into it
+		MeshChange* pAdded = pending.m_Added != NO_ENTRY && m_PendingChanges[pending.m_Added].m_Version == m_NextVersion ? &m_PendingChanges[pending.m_Added] : nullptr;
+
+		// Overwritten entries keep their place, every change to the mesh between them and the end commutes with them
+		auto write = [this, &_change]( u32& _entry ) {
+			if ( _entry != NO_ENTRY )
+			{
+				m_PendingChanges[_entry] = std::move( _change );
+			}
+			else
+			{
+				_entry = static_cast<u32>( m_PendingChanges.size() );
+				m_PendingChanges.push_back( std::move( _change ) );
+			}
+		};
+		// Version 0 is acknowledged by definition, publishSnapshot() trims the entry
+		auto drop = [this]( u32& _entry ) {
+			if ( _entry != NO_ENTRY )
+			{
+				m_PendingChanges[_entry].m_Version = 0;
+				m_PendingChanges[_entry].m_Geometry.reset();
+				_entry = NO_ENTRY;
+			}
+		};
+
+		switch ( _change.m_Type )
 		{
-			if ( handle.isValid() )
+		case MeshChangeType::ADDED:
+			pending = PendingEntries{};
+			write( pending.m_Added );
+			break;
+		case MeshChangeType::REMOVED:
+			drop( pending.m_Transform );
+			drop( pending.m_Geometry );
+			drop( pending.m_Visibility );
+			drop( pending.m_Lod );
+			// A mesh the reader never heard of needs no removal either
+			if ( pAdded )
+			{
+				drop( pending.m_Added );
+			}
+			else
 			{
-				m_HandleToMeshIdxMap.emplace_back( std::pair{ handle, meshIdx } );
-				meshIdx++;
+				m_PendingChanges.push_back( std::move( _change ) );
 			}
+			m_PendingMeshes.erase( meshId );
+			break;
+		case MeshChangeType::TRANSFORM_CHANGED:
+			if ( pAdded )
+				pAdded->m_Transform = _change.m_Transform;
+			else
+				write( pending.m_Transform );
+			break;
+		case MeshChangeType::GEOMETRY_CHANGED:
+			// The renderer resets the level on a geometry change, levels of the previous geometry no longer apply
+			drop( pending.m_Lod );
+			if ( pAdded )
+				pAdded->m_Geometry = std::move( _change.m_Geometry );
+			else
+				write( pending.m_Geometry );
+			break;
+		case MeshChangeType::VISIBILITY_CHANGED:
+			if ( pAdded )
+				pAdded->m_Visible = _change.m_Visible;
+			else
+				write( pending.m_Visibility );
+			break;
+		case MeshChangeType::LOD_CHANGED:
+			write( pending.m_Lod );
+			break;
+		default:
+			break;
 		}
 	}
 
 	//--------------------------------------------------------------------
-	void BaseScene::setProjection( f32 _fov, f32 _aspect, f32 _near, f32 _far, Maths::AngleUnit _angleUnit /*= Maths::AngleUnit::DEGREES*/ )
+	void BaseScene::indexPendingChanges()
 	{
+		m_PendingMeshes.clear();
 
+		for ( u32 i = 0; i < m_PendingChanges.size(); i++ )
+		{
+			const MeshChange& change = m_PendingChanges[i];
+			switch ( change.m_Type )
+			{
+			case MeshChangeType::ADDED:
+				m_PendingMeshes[change.m_MeshId] = PendingEntries{ .m_Added = i };
+				break;
+			case MeshChangeType::REMOVED:
+				m_PendingMeshes.erase( change.m_MeshId );
+				break;
+			case MeshChangeType::TRANSFORM_CHANGED:
+				m_PendingMeshes[change.m_MeshId].m_Transform = i;
+				break;
+			case MeshChangeType::GEOMETRY_CHANGED:
+				m_PendingMeshes[change.m_MeshId].m_Geometry = i;
+				break;
+			case MeshChangeType::VISIBILITY_CHANGED:
+				m_PendingMeshes[change.m_MeshId].m_Visibility = i;
+				break;
+			case MeshChangeType::LOD_CHANGED:
+				m_PendingMeshes[change.m_MeshId].m_Lod = i;
+				break;
+			default:
+				break;
+			}
+		}
 	}
 
 	//--------------------------------------------------------------------
-	void BaseScene::updateCamera( Engine::Renderer& _renderer, const Camera& _cam, const ProjectionSettings& _settings )
+	void BaseScene::setMeshTransform( MeshHandle _handle, const Transform& _transform )
 	{
-		Maths::Matrix4 viewMat = Maths::Matrix4::View( _cam.m_EyePos, _cam.m_LookAt, _cam.m_WorldUp );
+		const u32 index = m_Meshes.findDenseIndex( _handle );
+		assert( index != Utils::SlotHandle::INVALID_INDEX );
 
-		_renderer.updateCameraUBO( viewMat, _settings.m_Fov, _settings.m_Near, _settings.m_Far );
+		if ( index != Utils::SlotHandle::INVALID_INDEX )
+		{
+			m_Transforms.set( index, _transform );
+		}
+	}
+
+	//--------------------------------------------------------------------
+	void BaseScene::setMeshGeometry( MeshHandle _handle, GeometryAssetRef _geometry )
+	{
+		Mesh* pMesh = m_Meshes.get( _handle );
+		assert( pMesh && _geometry );
+
+		if ( pMesh && _geometry )
+		{
+			pMesh->setGeometry( _geometry );
+			journalChange( MeshChange{ .m_Type = MeshChangeType::GEOMETRY_CHANGED, .m_MeshId = pMesh->getNameId(), .m_Geometry = std::move( _geometry ) } );
+		}
+	}
+
+	//--------------------------------------------------------------------
+	void BaseScene::setMeshVisible( MeshHandle _handle, bool _visible )
+	{
+		Mesh* pMesh = m_Meshes.get( _handle );
+		assert( pMesh );
+
+		if ( pMesh && pMesh->isVisible() != _visible )
+		{
+			pMesh->setVisible( _visible );
+			journalChange( MeshChange{ .m_Type = MeshChangeType::VISIBILITY_CHANGED, .m_MeshId = pMesh->getNameId(), .m_Visible = _visible } );
+		}
+	}
+
+	//--------------------------------------------------------------------
+	bool BaseScene::setMeshParent( MeshHandle _handle, MeshHandle _parent )
+	{
+		const u32 index = m_Meshes.findDenseIndex( _handle );
+		const u32 parentIndex = _parent.isNull() ? SceneGraph::NO_PARENT : m_Meshes.findDenseIndex( _parent );
+		assert( index != Utils::SlotHandle::INVALID_INDEX && ( _parent.isNull() || parentIndex != Utils::SlotHandle::INVALID_INDEX ) );
+
+		if ( index == Utils::SlotHandle::INVALID_INDEX || ( !_parent.isNull() && parentIndex == Utils::SlotHandle::INVALID_INDEX ) )
+			return false;
+
+		// World matrices of the subtree are rebuilt and journaled by the next updateTransforms()
+		return m_Graph.setParent( index, parentIndex );
+	}
+
+	//--------------------------------------------------------------------
+	void BaseScene::setProjection( f32 _fov, f32 _aspect, f32 _near, f32 _far, Maths::AngleUnit _angleUnit /*= Maths::AngleUnit::DEGREES*/ )
+	{
+
+	}
+
+	//--------------------------------------------------------------------
+	void BaseScene::updateCamera( const Camera& _cam, const ProjectionSettings& _settings )
+	{
+		// Reaches the renderer through the next snapshot
+		m_View = Maths::Matrix4::View( _cam.m_EyePos, _cam.m_LookAt, _cam.m_WorldUp );
+		m_Projection = _settings;
+		m_CameraVersion++;
+
+		// Projected size of an object: world size * m_LodScale / distance, in screen heights
+		m_EyePos = _cam.m_EyePos;
+		m_LodScale = 0.5f / std::tan( Utils::UnitConvert::DegreesToRadians( _settings.m_Fov ) * 0.5f );
 	}
 
 	//--------------------------------------------------------------------
 	void BaseScene::updateMeshPosition( MeshHandle _handle, Maths::Vector3 _position )
 	{
+		const u32 index = m_Meshes.findDenseIndex( _handle );
+		assert( index != Utils::SlotHandle::INVALID_INDEX );
 
+		if ( index != Utils::SlotHandle::INVALID_INDEX )
+		{
+			m_Transforms.setPosition( index, _position );
+		}
 	}
 
 	//--------------------------------------------------------------------
 	void BaseScene::updateMeshScale( MeshHandle _handle, Maths::Vector3 _scale )
 	{
+		const u32 index = m_Meshes.findDenseIndex( _handle );
+		assert( index != Utils::SlotHandle::INVALID_INDEX );
 
+		if ( index != Utils::SlotHandle::INVALID_INDEX )
+		{
+			m_Transforms.setScale( index, _scale );
+		}
 	}
 
 	//--------------------------------------------------------------------
-	void BaseScene::updateMeshRotation( MeshHandle _handle, Maths::Vector3 _rotation )
+	void BaseScene::updateMeshRotation( MeshHandle _handle, const Maths::Quaternion& _rotation )
 	{
+		const u32 index = m_Meshes.findDenseIndex( _handle );
+		assert( index != Utils::SlotHandle::INVALID_INDEX );
 
+		if ( index != Utils::SlotHandle::INVALID_INDEX )
+		{
+			m_Transforms.setRotation( index, _rotation );
+		}
 	}
 
 	//--------------------------------------------------------------------
-	void BaseScene::removeMesh( MeshHandle _handle, Engine::Renderer& _renderer )
+	void BaseScene::updateTransforms()
 	{
-		std::unique_lock<std::shared_mutex> lock( m_Mutex );
+		for ( const u32 index : m_Transforms.updateMatrices() )
+		{
+			m_Graph.markDirty( index );
+		}
+
+		// Descendants of a moved mesh move too, they are part of the returned set
+		const auto meshes = m_Meshes.values();
+		const auto matrices = m_Graph.getWorldMatrices();
 
+		for ( const u32 index : m_Graph.updateWorld( m_Transforms.getMatrices() ) )
+		{
+			journalChange( MeshChange{ .m_Type = MeshChangeType::TRANSFORM_CHANGED, .m_MeshId = meshes[index].getNameId(), .m_Transform = matrices[index] } );
+		}
+	}
 
-		auto handleIt = std::ranges::find( m_MeshHandles, _handle );
-		auto it = std::ranges::find_if( m_HandleToMeshIdxMap, [&]( const auto& _pairing ) { return _pairing.first == _handle; } );
+	//--------------------------------------------------------------------
+	void BaseScene::updateLods()
+	{
+		// Without a camera there is nothing to project, everything stays at full detail
+		if ( m_CameraVersion == 0 || ( m_CameraVersion == m_LodCameraVersion && m_StateVersion == m_LodStateVersion ) )
+			return;
 
-		bool process = it != m_HandleToMeshIdxMap.end() && handleIt != m_MeshHandles.end();
-		assert( process );
+		const auto meshes = m_Meshes.values();
+		const auto matrices = m_Graph.getWorldMatrices();
 
-		if ( it != m_HandleToMeshIdxMap.end() )
+		for ( size_t i = 0; i < meshes.size(); i++ )
 		{
-			auto idx = it->second;
-			process = process && idx < m_MeshData.size();
-			assert( process );
-			if ( process )
+			Mesh& mesh = meshes[i];
+			const GeometryAsset& geometry = *mesh.getGeometry();
+			if ( geometry.getLodCount() < 2 )
+				continue;
+
+			// Largest axis scale, the bounds and the LOD errors grow with it
+			const Maths::Matrix4& world = matrices[i];
+			const f32 scale = std::max( { world.TransformVector( Maths::Vector3{ .x = 1.0f } ).Length(), world.TransformVector( Maths::Vector3{ .y = 1.0f } ).Length(),
+				world.TransformVector( Maths::Vector3{ .z = 1.0f } ).Length() } );
+
+			// From the nearest point of the bounds, a camera inside them sees the mesh at full size
+			const GeometryBounds& bounds = geometry.getBounds();
+			const f32 distance = std::max( ( world.TransformPoint( bounds.m_Center ) - m_EyePos ).Length() - bounds.m_Radius * scale, m_Projection.m_Near );
+
+			const u32 lod = SelectLod( geometry.getLods(), scale * m_LodScale / distance, mesh.getLod() );
+			if ( lod != mesh.getLod() )
 			{
-				_renderer.removeMesh( m_MeshData[idx] );
+				mesh.setLod( lod );
+				journalChange( MeshChange{ .m_Type = MeshChangeType::LOD_CHANGED, .m_MeshId = mesh.getNameId(), .m_Lod = lod } );
+			}
+		}
 
-				if ( idx < ( m_MeshData.size() - 1 ) )
-				{
-					std::swap( m_MeshData.at( idx ), m_MeshData.back() );
-				}
+		m_LodCameraVersion = m_CameraVersion;
+		m_LodStateVersion = m_StateVersion;
+	}
 
-				m_MeshData.pop_back();
-				m_HandleToMeshIdxMap.back().second = idx;
-				handleIt->invalidate();
-				updateHandleToMeshIdx();
+	//--------------------------------------------------------------------
+	void BaseScene::removeMesh( MeshHandle _handle )
+	{
+		Mesh* pMesh = m_Meshes.get( _handle );
+		assert( pMesh );
+
+		if ( pMesh )
+		{
+			journalChange( MeshChange{ .m_Type = MeshChangeType::REMOVED, .m_MeshId = pMesh->getNameId() } );
 
+			if ( auto it = m_NameToHandle.find( pMesh->getName() ); it != m_NameToHandle.end() )
+			{
+				m_NameToHandle.erase( it );
 			}
+
+			// Children are reattached to the removed mesh's parent, their new world matrices go out as transform changes
+			const u32 index = m_Meshes.findDenseIndex( _handle );
+			m_Graph.removeObject( index );
+			m_Transforms.remove( index );
+			m_Meshes.erase( _handle );
 		}
 	}
 
 	//--------------------------------------------------------------------
-	Mesh* BaseScene::getMesh( std::string_view _name )
+	std::optional<Mesh> BaseScene::getMesh( std::string_view _name ) const
 	{
-		std::shared_lock<std::shared_mutex> lock( m_Mutex );
-		auto pos = std::ranges::find_if( m_MeshData, [&]( const auto& _mesh ) { return _mesh.getName() == _name; } );
+		auto it = m_NameToHandle.find( _name );
 
-		if ( pos != m_MeshData.end() )
+		if ( it != m_NameToHandle.end() )
 		{
-			return &*pos;
+			return getMesh( it->second );
 		}
 		else
 		{
 			assert( false );
-			return nullptr;
+			return std::nullopt;
+		}
+	}
+
+	//--------------------------------------------------------------------
+	MeshHandle BaseScene::findMesh( std::string_view _name ) const
+	{
+		auto it = m_NameToHandle.find( _name );
+		return it != m_NameToHandle.end() ? it->second : MeshHandle{};
+	}
+
+	//--------------------------------------------------------------------
+	std::optional<Mesh> BaseScene::getMesh( MeshHandle _handle ) const
+	{
+		const Mesh* pMesh = m_Meshes.get( _handle );
+		assert( pMesh );
+
+		if ( !pMesh )
+			return std::nullopt;
+
+		Mesh mesh = *pMesh;
+		mesh.setTransform( m_Transforms.get( m_Meshes.findDenseIndex( _handle ) ) );
+		return mesh;
+	}
+
+	//--------------------------------------------------------------------
+	void BaseScene::queueCommand( SceneCommand&& _command )
+	{
+		m_Commands.push( std::move( _command ) );
+	}
+
+	//--------------------------------------------------------------------
+	void BaseScene::applyQueuedCommands()
+	{
+		while ( std::optional<SceneCommand> command = m_Commands.pop() )
+		{
+			std::visit( [this]( auto&& _cmd ) {
+				using Command = std::decay_t<decltype( _cmd )>;
+
+				// Commands may target meshes removed since they were queued, skip those instead of asserting
+				if constexpr ( std::is_same_v<Command, AddMeshCommand> )
+				{
+					addMesh( _cmd.m_Mesh );
+				}
+				else if ( m_Meshes.contains( _cmd.m_Handle ) )
+				{
+					if constexpr ( std::is_same_v<Command, RemoveMeshCommand> )
+						removeMesh( _cmd.m_Handle );
+					else if constexpr ( std::is_same_v<Command, SetMeshTransformCommand> )
+						setMeshTransform( _cmd.m_Handle, _cmd.m_Transform );
+					else if constexpr ( std::is_same_v<Command, SetMeshGeometryCommand> )
+						setMeshGeometry( _cmd.m_Handle, std::move( _cmd.m_Geometry ) );
+					else if constexpr ( std::is_same_v<Command, SetMeshVisibleCommand> )
+						setMeshVisible( _cmd.m_Handle, _cmd.m_Visible );
+					else if constexpr ( std::is_same_v<Command, SetMeshParentCommand> )
+					{
+						if ( _cmd.m_Parent.isNull() || m_Meshes.contains( _cmd.m_Parent ) )
+							setMeshParent( _cmd.m_Handle, _cmd.m_Parent );
+					}
+				}
+			}, *command );
 		}
 	}
 
 	//--------------------------------------------------------------------
-	Mesh* BaseScene::getMesh( MeshHandle _handle )
+	void BaseScene::publishSnapshot()
 	{
-		std::shared_lock<std::shared_mutex> lock( m_Mutex );
-		auto pos = std::ranges::find_if( m_HandleToMeshIdxMap, [&]( const auto& _pairing ) { return _pairing.first == _handle; } );
-		assert( pos != m_HandleToMeshIdxMap.end() );
+		applyQueuedCommands();
+		updateTransforms();
+		updateLods();
+
+		// Changes the reader has applied never need to be sent again, nor do dropped ones. Overwritten entries
+		// carry newer versions than the ones after them, so acknowledged entries are not only a prefix
+		const u64 acknowledged = m_AcknowledgedVersion.load( std::memory_order_acquire );
+		if ( std::erase_if( m_PendingChanges, [acknowledged]( const MeshChange& _change ) { return _change.m_Version <= acknowledged; } ) > 0 )
+		{
+			indexPendingChanges();
+		}
+
+		SceneSnapshot& snapshot = m_Snapshots.back();
+		snapshot.m_Version = m_NextVersion++;
 
-		if ( pos != m_HandleToMeshIdxMap.end() )
+		// Buffers are recycled, a static scene costs no copy at all
+		if ( snapshot.m_StateVersion != m_StateVersion )
 		{
-			auto idx = pos->second;
-			auto process = idx < m_MeshData.size();
-			assert( process );
+			const auto meshes = m_Meshes.values();
+			const auto matrices = m_Graph.getWorldMatrices();
 
-			if ( process )
+			snapshot.m_MeshIds.resize( meshes.size() );
+			snapshot.m_Visible.resize( meshes.size() );
+			snapshot.m_Transforms.assign( matrices.begin(), matrices.end() );
+
+			for ( size_t i = 0; i < meshes.size(); i++ )
 			{
-				return &m_MeshData.at( idx );
+				snapshot.m_MeshIds[i] = meshes[i].getNameId();
+				snapshot.m_Visible[i] = meshes[i].isVisible() ? 1 : 0;
 			}
+
+			snapshot.m_StateVersion = m_StateVersion;
 		}
 
-		assert( false );
-		return nullptr;
+		snapshot.m_Changes.assign( m_PendingChanges.begin(), m_PendingChanges.end() );
+
+		snapshot.m_View = m_View;
+		snapshot.m_Projection = m_Projection;
+		snapshot.m_CameraVersion = m_CameraVersion;
+
+		m_Snapshots.publish();
+	}
+
+	//--------------------------------------------------------------------
+	const SceneSnapshot& BaseScene::acquireSnapshot()
+	{
+		m_Snapshots.acquire();
+		return m_Snapshots.front();
 	}
 
 	//--------------------------------------------------------------------
-	void BaseScene::rendererUpdateMeshes( Engine::Renderer& _renderer )
+	void BaseScene::syncRenderer( Engine::Renderer& _renderer )
 	{
-		std::shared_lock<std::shared_mutex> lock( m_Mutex );
-		_renderer.loadMeshes( m_MeshData );
+		const SceneSnapshot& snapshot = acquireSnapshot();
+		if ( snapshot.m_Version <= m_AppliedVersion )
+			return;
+
+		if ( snapshot.m_CameraVersion != m_AppliedCameraVersion )
+		{
+			_renderer.updateCameraUBO( snapshot.m_View, snapshot.m_Projection.m_Fov, snapshot.m_Projection.m_Near, snapshot.m_Projection.m_Far );
+			m_AppliedCameraVersion = snapshot.m_CameraVersion;
+		}
+
+		for ( const auto& change : snapshot.m_Changes )
+		{
+			// Repeated from a snapshot that was already applied
+			if ( change.m_Version <= m_AppliedVersion )
+				continue;
+
+			switch ( change.m_Type )
+			{
+			case MeshChangeType::ADDED:
+				_renderer.addMesh( change.m_MeshId, change.m_Geometry, change.m_Transform );
+				if ( !change.m_Visible )
+					_renderer.updateMeshVisibility( change.m_MeshId, false );
+				break;
+			case MeshChangeType::REMOVED:
+				_renderer.removeMesh( change.m_MeshId );
+				break;
+			case MeshChangeType::TRANSFORM_CHANGED:
+				_renderer.updateMeshTransform( change.m_MeshId, change.m_Transform );
+				break;
+			case MeshChangeType::GEOMETRY_CHANGED:
+				_renderer.updateMeshGeometry( change.m_MeshId, change.m_Geometry );
+				break;
+			case MeshChangeType::VISIBILITY_CHANGED:
+				_renderer.updateMeshVisibility( change.m_MeshId, change.m_Visible );
+				break;
+			case MeshChangeType::LOD_CHANGED:
+				_renderer.updateMeshLod( change.m_MeshId, change.m_Lod );
+				break;
+			default:
+				break;
+			}
+		}
+
+		m_AppliedVersion = snapshot.m_Version;
+		m_AcknowledgedVersion.store( m_AppliedVersion, std::memory_order_release );
 	}
 
-} // end namespace Scene
\ No newline at end of file
+} // end namespace Scene
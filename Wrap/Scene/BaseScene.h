@@ -2,68 +2,121 @@
 
 #include "../Utils/Common.h"
 #include <unordered_map>
-#include <shared_mutex>
+#include <optional>
+#include <atomic>
 
 #include "Mesh.h"
+#include "SceneSnapshot.h"
+#include "SceneCommand.h"
+#include "TransformStorage.h"
+#include "SceneGraph.h"
 #include "../Engine/Renderer.h"
+#include "../Utils/SlotMap.h"
+#include "../Utils/StringInterner.h"
+#include "../Utils/TripleBuffer.h"
+#include "../Utils/MpscQueue.h"
 #include "../Maths/Vector3.h"
 
 namespace Scene {
 
-	struct MeshHandle
+	// Live state is owned by a single simulation thread and is never locked.
+	// Other threads queue commands, or read the snapshots published by publishSnapshot().
+	class BaseScene
 	{
-		u32 m_Id;
-		bool m_Valid = { true };
-
-		bool isValid() { return m_Valid; };
-		void invalidate() { m_Valid = false; };
-
-		constexpr bool operator==( const MeshHandle& _other ) const
-		{
-			return m_Id == _other.m_Id && m_Valid == _other.m_Valid;
-		}
-	};
+	public:
+		// Simulation thread only, returns a copy so nothing dangles once the mesh is removed
+		std::optional<Mesh> getMesh( MeshHandle _handle ) const;
+		std::optional<Mesh> getMesh( std::string_view _name ) const;
+		MeshHandle findMesh( std::string_view _name ) const;
 
-	struct Camera {
-		Maths::Vector3 m_EyePos;
-		Maths::Vector3 m_LookAt;
-		Maths::Vector3 m_WorldUp;
-	};
+		// Any thread, applied in submission order (per thread) at the next publishSnapshot()
+		void queueCommand( SceneCommand&& _command );
 
-	struct ProjectionSettings {
-		f32 m_Fov;
-		f32 m_Near;
-		f32 m_Far;
-	};
+		// Render thread only, latest published snapshot
+		const SceneSnapshot& acquireSnapshot();
 
-	class BaseScene
-	{
-	public:
-		Mesh* getMesh( MeshHandle _handle );
-		Mesh* getMesh( std::string_view _name );
+		// Render thread: applies the changes of the latest snapshot not applied yet, cost scales with the number of changes
+		void syncRenderer( Engine::Renderer& _renderer );
 
 	protected:
 		void setProjection( f32 _fov, f32 _aspect, f32 _near, f32 _far, Maths::AngleUnit _angleUnit = Maths::AngleUnit::DEGREES );
 
 		void updateMeshPosition( MeshHandle _handle, Maths::Vector3 _position );
 		void updateMeshScale( MeshHandle _handle, Maths::Vector3 _scale );
-		void updateMeshRotation( MeshHandle _handle, Maths::Vector3 _rotation );
+		void updateMeshRotation( MeshHandle _handle, const Maths::Quaternion& _rotation );
 
 		MeshHandle addMesh( const Mesh& _mesh );
-		void removeMesh( MeshHandle _handle, Engine::Renderer& _renderer );
+		void removeMesh( MeshHandle _handle );
 
-		void updateCamera( Engine::Renderer& _renderer, const Camera& _cam, const ProjectionSettings& _settings );
-		void rendererUpdateMeshes( Engine::Renderer& _renderer );
+		// Transform edits only flag the mesh, matrices are rebuilt in one batch when the snapshot is published
+		void setMeshTransform( MeshHandle _handle, const Transform& _transform );
+		// Assets are immutable, changing geometry swaps the mesh onto another (possibly shared) asset
+		void setMeshGeometry( MeshHandle _handle, GeometryAssetRef _geometry );
+		void setMeshVisible( MeshHandle _handle, bool _visible );
+		// The mesh transform becomes relative to its parent, a null parent makes it a root. Returns false on cycles.
+		bool setMeshParent( MeshHandle _handle, MeshHandle _parent );
 
-	private:
-		void updateHandleToMeshIdx();
+		void updateCamera( const Camera& _cam, const ProjectionSettings& _settings );
 
-		u32 m_NextMeshHandleId{ 0 };
-		std::vector<std::pair<MeshHandle, size_t>> m_HandleToMeshIdxMap;
-		std::vector<MeshHandle> m_MeshHandles;
-		std::vector<Mesh> m_MeshData;
+		// Simulation thread, end of frame: applies queued commands and makes this frame's state visible to readers
+		void publishSnapshot();
 
-		mutable std::shared_mutex m_Mutex;
+	private:
+		static constexpr u32 NO_ENTRY = ~0u;
+
+		// Positions in m_PendingChanges of a mesh's entries since its last ADDED, later changes of the same kind overwrite them
+		struct PendingEntries {
+			u32 m_Added{ NO_ENTRY };
+			u32 m_Transform{ NO_ENTRY };
+			u32 m_Geometry{ NO_ENTRY };
+			u32 m_Visibility{ NO_ENTRY };
+			u32 m_Lod{ NO_ENTRY };
+		};
+
+		void journalChange( MeshChange&& _change );
+		// After entries were trimmed from m_PendingChanges
+		void indexPendingChanges();
+		void applyQueuedCommands();
+		void updateTransforms();
+		// Journals every mesh whose projected size moved it to another level of detail
+		void updateLods();
+
+		// Simulation thread state
+		Utils::SlotMap<Mesh> m_Meshes;
+		// Indexed like m_Meshes.values(), both swap-and-pop on removal
+		TransformStorage m_Transforms;
+		// Same indices, turns the local matrices of m_Transforms into the world matrices sent to the renderer
+		SceneGraph m_Graph;
+
+		Utils::StringInterner m_MeshNames;
+		Utils::StringMap<MeshHandle> m_NameToHandle;
+
+		// Changes not yet acknowledged by the reader, in the order they apply. At most one entry per mesh and kind of change,
+		// so the journal stays bounded by the scene size even while no reader acknowledges it
+		std::vector<MeshChange> m_PendingChanges;
+		std::unordered_map<Utils::NameId, PendingEntries> m_PendingMeshes;
+		u64 m_NextVersion{ 1 };
+		u64 m_StateVersion{ 0 };
+
+		Maths::Matrix4 m_View;
+		ProjectionSettings m_Projection{};
+		u64 m_CameraVersion{ 0 };
+
+		// Derived from the camera for LOD selection: eye position and screen heights covered by one world unit at distance 1
+		Maths::Vector3 m_EyePos;
+		f32 m_LodScale{ 0.0f };
+		// Inputs of the last updateLods(), nothing to do while neither changes
+		u64 m_LodCameraVersion{ 0 };
+		u64 m_LodStateVersion{ 0 };
+
+		// Shared state
+		Utils::MpscQueue<SceneCommand> m_Commands;
+		Utils::TripleBuffer<SceneSnapshot> m_Snapshots;
+		std::atomic<u64> m_AcknowledgedVersion{ 0 };
+
+		// Render thread state
+		u64 m_AppliedVersion{ 0 };
+		u64 m_AppliedCameraVersion{ 0 };
 	};
 
 } // end namespace Scene
@@ -0,0 +1,194 @@
+#include "GeometryAsset.h"
+
+#include <atomic>
+#include <cstring>
+
+#include "../Utils/Hash.h"
+
+
+namespace Scene {
+	namespace {
+		u64 NextGeometryId()
+		{
+			static std::atomic<u64> s_NextId{ 1 };
+			return s_NextId.fetch_add( 1, std::memory_order_relaxed );
+		}
+
+		//--------------------------------------------------------------------
+		GeometryBounds ComputeBounds( std::span<const Engine::Vertex> _vertices )
+		{
+			if ( _vertices.empty() )
+				return GeometryBounds{};
+
+			Maths::Vector3 min = _vertices[0].getPosition();
+			Maths::Vector3 max = min;
+			for ( const Engine::Vertex& vertex : _vertices )
+			{
+				const Maths::Vector3 position = vertex.getPosition();
+				min = Maths::Vector3{ .x = std::min( min.x, position.x ), .y = std::min( min.y, position.y ), .z = std::min( min.z, position.z ) };
+				max = Maths::Vector3{ .x = std::max( max.x, position.x ), .y = std::max( max.y, position.y ), .z = std::max( max.z, position.z ) };
+			}
+
+			return GeometryBounds::FromBox( min, max );
+		}
+	} // end anonymous namespace
+
+	//--------------------------------------------------------------------
+	GeometryBounds GeometryBounds::FromBox( const Maths::Vector3& _min, const Maths::Vector3& _max )
+	{
+		const Maths::Vector3 halfExtent{ .x = ( _max.x - _min.x ) * 0.5f, .y = ( _max.y - _min.y ) * 0.5f, .z = ( _max.z - _min.z ) * 0.5f };
+		return GeometryBounds{ .m_Center = _min + halfExtent, .m_Radius = halfExtent.Length() };
+	}
+
+	//--------------------------------------------------------------------
+	GeometryHasher::GeometryHasher()
+		// Two unrelated seeds, any two bit patterns would do
+		: m_Hash{ .m_Key = 0, .m_Check = 0x6A09E667F3BCC908ull }
+	{
+		// Hashed as raw bytes, padding would make equal content hash differently
+		static_assert( std::has_unique_object_representations_v<Engine::Vertex>, "Vertex must not contain padding" );
+		static_assert( sizeof( GeometryLod ) == 5 * sizeof( u32 ), "GeometryLod must not contain padding" );
+		static_assert( sizeof( GeometryCluster ) == 2 * sizeof( u32 ) + 8 * sizeof( f32 ), "GeometryCluster must not contain padding" );
+		static_assert( sizeof( Engine::PositionFrame ) == 4 * sizeof( f32 ), "PositionFrame must not contain padding" );
+
+		m_Pending.reserve( CHUNK_SIZE );
+	}
+
+	//--------------------------------------------------------------------
+	void GeometryHasher::add( const Engine::Vertex& _vertex )
+	{
+		m_Pending.push_back( _vertex );
+		if ( m_Pending.size() == CHUNK_SIZE )
+		{
+			hashChunk( m_Pending );
+			m_Pending.clear();
+		}
+	}
+
+	//--------------------------------------------------------------------
+	void GeometryHasher::add( std::span<const Engine::Vertex> _vertices )
+	{
+		// Top up a partial chunk first, whole chunks are then hashed in place
+		while ( !m_Pending.empty() && !_vertices.empty() )
+		{
+			add( _vertices.front() );
+			_vertices = _vertices.subspan( 1 );
+		}
+
+		for ( ; _vertices.size() >= CHUNK_SIZE; _vertices = _vertices.subspan( CHUNK_SIZE ) )
+		{
+			hashChunk( _vertices.first( CHUNK_SIZE ) );
+		}
+		m_Pending.insert( m_Pending.end(), _vertices.begin(), _vertices.end() );
+	}
+
+	//--------------------------------------------------------------------
+	GeometryHash GeometryHasher::finish( std::span<const u32> _indices, std::span<const GeometryLod> _lods, std::span<const GeometryCluster> _clusters,
+		const Engine::PositionFrame& _frame )
+	{
+		if ( !m_Pending.empty() )
+		{
+			hashChunk( m_Pending );
+			m_Pending.clear();
+		}
+
+		// Chained through the seeds, the counts keep blobs split at different points apart
+		const std::array<u32, 2> counts{ m_VertexCount, static_cast<u32>( _indices.size() ) };
+		for ( u64* pHash : { &m_Hash.m_Key, &m_Hash.m_Check } )
+		{
+			u64 hash = Utils::Hash::Span<u32>( counts, *pHash );
+			hash = Utils::Hash::Span( _indices, hash );
+			hash = Utils::Hash::Span( _lods, hash );
+			hash = Utils::Hash::Span( _clusters, hash );
+			*pHash = Utils::Hash::Span( std::span<const Engine::PositionFrame>( &_frame, 1 ), hash );
+		}
+		return m_Hash;
+	}
+
+	//--------------------------------------------------------------------
+	void GeometryHasher::hashChunk( std::span<const Engine::Vertex> _chunk )
+	{
+		m_Hash.m_Key = Utils::Hash::Span( _chunk, m_Hash.m_Key );
+		m_Hash.m_Check = Utils::Hash::Span( _chunk, m_Hash.m_Check );
+		m_VertexCount += static_cast<u32>( _chunk.size() );
+	}
+
+	//--------------------------------------------------------------------
+	GeometryAssetRef GeometryAsset::create( std::vector<Engine::Vertex>&& _vertices, std::vector<u32>&& _indices, CpuDataPolicy _policy )
+	{
+		// Constructor is private, so make_shared cannot be used
+		return GeometryAssetRef( new GeometryAsset( std::move( _vertices ), std::move( _indices ), _policy ) );
+	}
+
+	//--------------------------------------------------------------------
+	GeometryAssetRef GeometryAsset::create( u32 _vertexCount, u32 _indexCount, GeometryWriter&& _writer, std::vector<GeometryLod>&& _lods,
+		std::vector<GeometryCluster>&& _clusters, const GeometryBounds& _bounds, const Engine::PositionFrame& _frame, const GeometryHash& _hash )
+	{
+		return GeometryAssetRef( new GeometryAsset( _vertexCount, _indexCount, std::move( _writer ), std::move( _lods ), std::move( _clusters ), _bounds, _frame, _hash ) );
+	}
+
+	//--------------------------------------------------------------------
+	GeometryAsset::GeometryAsset( std::vector<Engine::Vertex>&& _vertices, std::vector<u32>&& _indices, CpuDataPolicy _policy )
+		: m_Id( NextGeometryId() )
+		, m_VertexCount( static_cast<u32>( _vertices.size() ) )
+		, m_IndexCount( static_cast<u32>( _indices.size() ) )
+		, m_Policy( _policy )
+		, m_Lods{ GeometryLod{ .m_FirstIndex = 0, .m_IndexCount = m_IndexCount, .m_Error = 0.0f } }
+		, m_Bounds( ComputeBounds( _vertices ) )
+		, m_Vertices( std::move( _vertices ) )
+		, m_Indices( std::move( _indices ) )
+	{
+		GeometryHasher hasher;
+		hasher.add( m_Vertices );
+		m_Hash = hasher.finish( m_Indices, m_Lods, m_Clusters, m_Frame );
+	}
+
+	//--------------------------------------------------------------------
+	GeometryAsset::GeometryAsset( u32 _vertexCount, u32 _indexCount, GeometryWriter&& _writer, std::vector<GeometryLod>&& _lods,
+		std::vector<GeometryCluster>&& _clusters, const GeometryBounds& _bounds, const Engine::PositionFrame& _frame, const GeometryHash& _hash )
+		: m_Id( NextGeometryId() )
+		, m_VertexCount( _vertexCount )
+		, m_IndexCount( _indexCount )
+		, m_Policy( CpuDataPolicy::RELEASE_AFTER_UPLOAD )
+		, m_Lods( std::move( _lods ) )
+		, m_Clusters( std::move( _clusters ) )
+		, m_Bounds( _bounds )
+		, m_Frame( _frame )
+		, m_Hash( _hash )
+		, m_Writer( std::move( _writer ) )
+	{
+		if ( m_Lods.empty() )
+		{
+			m_Lods.push_back( GeometryLod{ .m_FirstIndex = 0, .m_IndexCount = _indexCount, .m_Error = 0.0f } );
+		}
+
+		assert( std::ranges::all_of( m_Lods, [_indexCount]( const GeometryLod& _lod ) { return u64( _lod.m_FirstIndex ) + _lod.m_IndexCount <= _indexCount; } ) );
+		assert( std::ranges::all_of( m_Lods, [this]( const GeometryLod& _lod ) { return u64( _lod.m_FirstCluster ) + _lod.m_ClusterCount <= m_Clusters.size(); } ) );
+	}
+
+	//--------------------------------------------------------------------
+	void GeometryAsset::releaseCpuData() const
+	{
+		// swap with empty vectors so the capacity is actually returned
+		std::vector<Engine::Vertex>().swap( m_Vertices );
+		std::vector<u32>().swap( m_Indices );
+		m_Writer = nullptr;
+	}
+
+	//--------------------------------------------------------------------
+	void GeometryAsset::write( std::span<Engine::Vertex> _vertices, std::span<u32> _indices ) const
+	{
+		assert( _vertices.size() == m_VertexCount && _indices.size() == m_IndexCount );
+
+		if ( m_Writer )
+		{
+			m_Writer( _vertices, _indices );
+			return;
+		}
+
+		assert( hasCpuData() );
+		std::memcpy( _vertices.data(), m_Vertices.data(), m_Vertices.size() * sizeof( Engine::Vertex ) );
+		std::memcpy( _indices.data(), m_Indices.data(), m_Indices.size() * sizeof( u32 ) );
+	}
+
+} // end namespace Scene
@@ -0,0 +1,171 @@
+#pragma once
+
+#include "../Utils/Common.h"
+#include <span>
+
+#include "../Engine/VulkanTypes.h"
+#include "../Maths/Vector3.h"
+
+namespace Engine {
+	class Renderer;
+}
+
+namespace Scene {
+
+	enum class CpuDataPolicy : u8 {
+		// Vertices and indices stay readable for the asset's whole lifetime
+		KEEP,
+		// The renderer frees the CPU copy once the GPU upload has completed
+		RELEASE_AFTER_UPLOAD
+	};
+
+	// Index range drawn for one level of detail, LOD 0 is the full mesh and coarser levels follow it in the index buffer
+	struct GeometryLod
+	{
+		u32 m_FirstIndex{ 0 };
+		u32 m_IndexCount{ 0 };
+		// Object space distance the level may deviate from the full mesh, grows with the level
+		f32 m_Error{ 0.0f };
+		// Into GeometryAsset::getClusters(), none when the level is small enough to be drawn whole
+		u32 m_FirstCluster{ 0 };
+		u32 m_ClusterCount{ 0 };
+	};
+
+	// Contiguous index range of one level, culled on its own by the renderer when its sphere is outside the frustum
+	// or when every one of its triangles faces away from the camera
+	struct GeometryCluster
+	{
+		u32 m_FirstIndex{ 0 };
+		u32 m_IndexCount{ 0 };
+		// Object space bounding sphere
+		Maths::Vector3 m_Center;
+		f32 m_Radius{ 0.0f };
+		// Normal cone of the triangles, counter-clockwise winding
+		Maths::Vector3 m_ConeAxis;
+		// Sine of the cone's half angle, 1 when the normals spread too far to ever all face away together
+		f32 m_ConeCutoff{ 1.0f };
+	};
+
+	// Object space bounding sphere, projected by the scene to pick a level of detail
+	struct GeometryBounds
+	{
+		Maths::Vector3 m_Center;
+		f32 m_Radius{ 0.0f };
+
+		// Encloses the box, looser than the tightest sphere but cheap to get from a stored box
+		static GeometryBounds FromBox( const Maths::Vector3& _min, const Maths::Vector3& _max );
+	};
+
+	// Content hash of an asset's vertices, indices, levels and clusters: assets hashing equally upload identical GPU data
+	struct GeometryHash
+	{
+		u64 m_Key{ 0 };
+		// Same bytes under another seed, checked along with the counts when keys match so a collision can't alias two meshes
+		u64 m_Check{ 0 };
+
+		bool operator==( const GeometryHash& ) const = default;
+	};
+
+	// Builds a GeometryHash from vertices fed in any number of pieces, so sources without one contiguous copy need none.
+	// Vertices are hashed in fixed size chunks, the result only depends on the content
+	class GeometryHasher
+	{
+	public:
+		GeometryHasher();
+
+		void add( const Engine::Vertex& _vertex );
+		void add( std::span<const Engine::Vertex> _vertices );
+
+		// After every vertex has been added
+		GeometryHash finish( std::span<const u32> _indices, std::span<const GeometryLod> _lods, std::span<const GeometryCluster> _clusters,
+			const Engine::PositionFrame& _frame );
+
+	private:
+		static constexpr u32 CHUNK_SIZE = 4096;
+
+		void hashChunk( std::span<const Engine::Vertex> _chunk );
+
+		// Fewer than CHUNK_SIZE, waiting for the chunk to fill
+		std::vector<Engine::Vertex> m_Pending;
+		u32 m_VertexCount{ 0 };
+		GeometryHash m_Hash;
+	};
+
+	class GeometryAsset;
+	using GeometryAssetRef = std::shared_ptr<const GeometryAsset>;
+
+	// Writes an asset's vertices and indices into spans sized by its counts, the renderer passes mapped staging memory
+	using GeometryWriter = std::function<void( std::span<Engine::Vertex> _vertices, std::span<u32> _indices )>;
+
+	// Immutable vertex/index data shared by any number of mesh instances.
+	// Editing geometry means creating a new asset and pointing meshes at it.
+	class GeometryAsset
+	{
+	public:
+		// A single level of detail, bounds are computed from the vertices
+		static GeometryAssetRef create( std::vector<Engine::Vertex>&& _vertices, std::vector<u32>&& _indices,
+			CpuDataPolicy _policy = CpuDataPolicy::KEEP );
+		// No CPU copy at all: _writer fills the upload staging memory once and is released with it (RELEASE_AFTER_UPLOAD).
+		// _lods index into the written indices, an empty list means a single level covering all of them. _clusters may be empty.
+		// Written positions are relative to _frame. _hash is of the content _writer produces, the source hashes it while it still holds the data (see GeometryHasher)
+		static GeometryAssetRef create( u32 _vertexCount, u32 _indexCount, GeometryWriter&& _writer, std::vector<GeometryLod>&& _lods,
+			std::vector<GeometryCluster>&& _clusters, const GeometryBounds& _bounds, const Engine::PositionFrame& _frame, const GeometryHash& _hash );
+
+		GeometryAsset( const GeometryAsset& ) = delete;
+		GeometryAsset& operator=( const GeometryAsset& ) = delete;
+
+		// Unique for the lifetime of the process, the renderer keys GPU buffers by it
+		u64 getId() const { return m_Id; };
+
+		// Empty once the CPU copy has been released
+		std::span<const Engine::Vertex> getVertices() const { return m_Vertices; };
+		std::span<const u32> getIndices() const { return m_Indices; };
+
+		// Still valid after the CPU copy has been released
+		u32 getVertexCount() const { return m_VertexCount; };
+		u32 getIndexCount() const { return m_IndexCount; };
+
+		// Never empty, ordered from the full mesh to the coarsest level
+		std::span<const GeometryLod> getLods() const { return m_Lods; };
+		u32 getLodCount() const { return static_cast<u32>( m_Lods.size() ); };
+		const GeometryBounds& getBounds() const { return m_Bounds; };
+		// Maps the stored vertex positions to object space, the identity for assets created from vertices.
+		// Bounds, level errors and clusters are in object space already
+		const Engine::PositionFrame& getPositionFrame() const { return m_Frame; };
+		// Of every level, each level's range is in its GeometryLod
+		std::span<const GeometryCluster> getClusters() const { return m_Clusters; };
+
+		// Taken at creation, still valid after the CPU copy has been released
+		const GeometryHash& getContentHash() const { return m_Hash; };
+
+		bool hasCpuData() const { return !m_Vertices.empty(); };
+		bool hasWriter() const { return static_cast<bool>( m_Writer ); };
+		CpuDataPolicy getCpuDataPolicy() const { return m_Policy; };
+
+	private:
+		GeometryAsset( std::vector<Engine::Vertex>&& _vertices, std::vector<u32>&& _indices, CpuDataPolicy _policy );
+		GeometryAsset( u32 _vertexCount, u32 _indexCount, GeometryWriter&& _writer, std::vector<GeometryLod>&& _lods,
+			std::vector<GeometryCluster>&& _clusters, const GeometryBounds& _bounds, const Engine::PositionFrame& _frame, const GeometryHash& _hash );
+
+		// Only the renderer may drop the data, after it owns a GPU copy
+		friend class Engine::Renderer;
+		void releaseCpuData() const;
+		// CPU copy or writer, whichever the asset has
+		void write( std::span<Engine::Vertex> _vertices, std::span<u32> _indices ) const;
+
+		u64 m_Id;
+		u32 m_VertexCount;
+		u32 m_IndexCount;
+		CpuDataPolicy m_Policy;
+		std::vector<GeometryLod> m_Lods;
+		std::vector<GeometryCluster> m_Clusters;
+		GeometryBounds m_Bounds;
+		Engine::PositionFrame m_Frame;
+		GeometryHash m_Hash;
+
+		mutable std::vector<Engine::Vertex> m_Vertices;
+		mutable std::vector<u32> m_Indices;
+		mutable GeometryWriter m_Writer;
+	};
+
+} // end namespace Scene
@@ -0,0 +1,630 @@
+#include "GltfParser.h"
+
+#include <atomic>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#include "../../Maths/LinAlg.h"
+#include "../../Maths/Matrix4.h"
+#include "../../Utils/Json.h"
+#include "../../Utils/MappedFile.h"
+
+namespace Scene {
+
+	namespace {
+		constexpr u32 GLB_MAGIC = 0x46546C67;
+		constexpr u32 GLB_VERSION = 2;
+		constexpr u32 GLB_CHUNK_JSON = 0x4E4F534A;
+		constexpr u32 GLB_CHUNK_BIN = 0x004E4942;
+
+		constexpr u32 COMPONENT_BYTE = 5120;
+		constexpr u32 COMPONENT_UNSIGNED_BYTE = 5121;
+		constexpr u32 COMPONENT_SHORT = 5122;
+		constexpr u32 COMPONENT_UNSIGNED_SHORT = 5123;
+		constexpr u32 COMPONENT_UNSIGNED_INT = 5125;
+		constexpr u32 COMPONENT_FLOAT = 5126;
+
+		constexpr u32 MODE_TRIANGLES = 4;
+		constexpr u32 MODE_TRIANGLE_STRIP = 5;
+		constexpr u32 MODE_TRIANGLE_FAN = 6;
+
+		// Node hierarchies are trees, deeper than this is a cycle in a broken file
+		constexpr u32 MAX_NODE_DEPTH = 64;
+		// Vertices or triangles per job inside one primitive
+		constexpr u32 EXPAND_GRAIN = 16384;
+
+		// Every buffer the document refers to, with whatever keeps its bytes alive
+		struct BufferSet {
+			std::vector<std::span<const std::byte>> m_Buffers;
+			std::vector<MappedFile> m_Files;
+			std::vector<std::vector<std::byte>> m_Decoded;
+		};
+
+		// One primitive of one node, a mesh used by several nodes is expanded once per node
+		struct PrimitiveInstance {
+			const Utils::JsonValue* m_pPrimitive;
+			Maths::Matrix4 m_World;
+		};
+
+		//--------------------------------------------------------------------
+		u32 ReadU32( std::span<const std::byte> _data, size_t _offset )
+		{
+			u32 value;
+			std::memcpy( &value, _data.data() + _offset, sizeof( u32 ) );
+			return value;
+		}
+
+		//--------------------------------------------------------------------
+		u32 ComponentSize( u32 _componentType )
+		{
+			switch ( _componentType )
+			{
+			case COMPONENT_BYTE:
+			case COMPONENT_UNSIGNED_BYTE:
+				return 1;
+			case COMPONENT_SHORT:
+			case COMPONENT_UNSIGNED_SHORT:
+				return 2;
+			case COMPONENT_UNSIGNED_INT:
+			case COMPONENT_FLOAT:
+				return 4;
+			default:
+				return 0;
+			}
+		}
+
+		//--------------------------------------------------------------------
+		u32 ComponentCount( std::string_view _type )
+		{
+			if ( _type == "SCALAR" )
+				return 1;
+			if ( _type == "VEC2" )
+				return 2;
+			if ( _type == "VEC3" )
+				return 3;
+			if ( _type == "VEC4" )
+				return 4;
+			return 0;
+		}
+
+		// Typed, bounds checked view of an accessor
+		class Accessor
+		{
+		public:
+			//--------------------------------------------------------------------
+			bool resolve( const Utils::JsonValue& _document, const BufferSet& _buffers, u32 _index )
+			{
+				const Utils::JsonValue& accessor = _document["accessors"][_index];
+				// Accessors without a buffer view are all zeros, useless for geometry
+				if ( !accessor.isObject() || !accessor.contains( "bufferView" ) || accessor.contains( "sparse" ) )
+					return false;
+
+				m_ComponentType = accessor["componentType"].asU32();
+				m_ComponentSize = ComponentSize( m_ComponentType );
+				m_ComponentCount = ComponentCount( accessor["type"].asString() );
+				m_Count = accessor["count"].asU32();
+				m_Normalized = accessor["normalized"].asBool();
+				if ( m_ComponentSize == 0 || m_ComponentCount == 0 )
+					return false;
+
+				const Utils::JsonValue& view = _document["bufferViews"][accessor["bufferView"].asU32()];
+				const u32 bufferIndex = view["buffer"].asU32( ~0u );
+				if ( bufferIndex >= _buffers.m_Buffers.size() )
+					return false;
+
+				const std::span<const std::byte> buffer = _buffers.m_Buffers[bufferIndex];
+				const u64 viewOffset = view["byteOffset"].asU32();
+				const u64 viewLength = view["byteLength"].asU32();
+				const u64 elementSize = m_ComponentSize * m_ComponentCount;
+				const u64 accessorOffset = accessor["byteOffset"].asU32();
+
+				m_Stride = view["byteStride"].asU32( static_cast<u32>( elementSize ) );
+				if ( m_Stride == 0 )
+					m_Stride = static_cast<u32>( elementSize );
+
+				if ( viewOffset + viewLength > buffer.size() )
+					return false;
+				if ( m_Count > 0 && accessorOffset + u64( m_Stride ) * ( m_Count - 1 ) + elementSize > viewLength )
+					return false;
+
+				m_pData = buffer.data() + viewOffset + accessorOffset;
+				return true;
+			}
+
+			u32 getCount() const { return m_Count; };
+			u32 getComponentCount() const { return m_ComponentCount; };
+			bool isFloat() const { return m_ComponentType == COMPONENT_FLOAT; };
+			bool isIndexType() const { return m_ComponentCount == 1 && ( m_ComponentType == COMPONENT_UNSIGNED_BYTE || m_ComponentType == COMPONENT_UNSIGNED_SHORT || m_ComponentType == COMPONENT_UNSIGNED_INT ); };
+
+			//--------------------------------------------------------------------
+			f32 readComponent( u32 _element, u32 _component ) const
+			{
+				const std::byte* p = m_pData + size_t( _element ) * m_Stride + _component * m_ComponentSize;
+				switch ( m_ComponentType )
+				{
+				case COMPONENT_FLOAT:
+				{
+					f32 value;
+					std::memcpy( &value, p, sizeof( value ) );
+					return value;
+				}
+				case COMPONENT_UNSIGNED_BYTE:
+				{
+					const f32 value = static_cast<f32>( static_cast<u8>( *p ) );
+					return m_Normalized ? value / 255.0f : value;
+				}
+				case COMPONENT_BYTE:
+				{
+					const f32 value = static_cast<f32>( static_cast<std::int8_t>( *p ) );
+					return m_Normalized ? std::max( value / 127.0f, -1.0f ) : value;
+				}
+				case COMPONENT_UNSIGNED_SHORT:
+				{
+					u16 value;
+					std::memcpy( &value, p, sizeof( value ) );
+					return m_Normalized ? value / 65535.0f : static_cast<f32>( value );
+				}
+				case COMPONENT_SHORT:
+				{
+					std::int16_t value;
+					std::memcpy( &value, p, sizeof( value ) );
+					return m_Normalized ? std::max( value / 32767.0f, -1.0f ) : static_cast<f32>( value );
+				}
+				default:
+				{
+					u32 value;
+					std::memcpy( &value, p, sizeof( value ) );
+					return static_cast<f32>( value );
+				}
+				}
+			}
+
+			//--------------------------------------------------------------------
+			Maths::Vector3 readVector3( u32 _element ) const
+			{
+				return Maths::Vector3{ .x = readComponent( _element, 0 ), .y = readComponent( _element, 1 ), .z = readComponent( _element, 2 ) };
+			}
+
+			//--------------------------------------------------------------------
+			u32 readIndex( u32 _element ) const
+			{
+				const std::byte* p = m_pData + size_t( _element ) * m_Stride;
+				switch ( m_ComponentType )
+				{
+				case COMPONENT_UNSIGNED_BYTE:
+					return static_cast<u8>( *p );
+				case COMPONENT_UNSIGNED_SHORT:
+				{
+					u16 value;
+					std::memcpy( &value, p, sizeof( value ) );
+					return value;
+				}
+				default:
+				{
+					u32 value;
+					std::memcpy( &value, p, sizeof( value ) );
+					return value;
+				}
+				}
+			}
+
+		private:
+			const std::byte* m_pData{ nullptr };
+			u32 m_Count{ 0 };
+			u32 m_Stride{ 0 };
+			u32 m_ComponentType{ 0 };
+			u32 m_ComponentSize{ 0 };
+			u32 m_ComponentCount{ 0 };
+			bool m_Normalized{ false };
+		};
+
+		//--------------------------------------------------------------------
+		bool DecodeBase64( std::string_view _text, std::vector<std::byte>& _out )
+		{
+			auto value = []( char _c ) -> i32 {
+				if ( _c >= 'A' && _c <= 'Z' ) return _c - 'A';
+				if ( _c >= 'a' && _c <= 'z' ) return _c - 'a' + 26;
+				if ( _c >= '0' && _c <= '9' ) return _c - '0' + 52;
+				if ( _c == '+' ) return 62;
+				if ( _c == '/' ) return 63;
+				return -1;
+			};
+
+			_out.reserve( _text.size() / 4 * 3 );
+
+			u32 bits = 0;
+			u32 bitCount = 0;
+			for ( char c : _text )
+			{
+				if ( c == '=' )
+					break;
+
+				const i32 v = value( c );
+				if ( v < 0 )
+					return false;
+
+				bits = ( bits << 6 ) | static_cast<u32>( v );
+				bitCount += 6;
+				if ( bitCount >= 8 )
+				{
+					bitCount -= 8;
+					_out.push_back( static_cast<std::byte>( ( bits >> bitCount ) & 0xFF ) );
+				}
+			}
+
+			return true;
+		}
+
+		//--------------------------------------------------------------------
+		// Percent escapes resolved, UTF-8 as glTF requires
+		std::filesystem::path DecodeUri( std::string_view _uri )
+		{
+			std::u8string decoded;
+			for ( size_t i = 0; i < _uri.size(); i++ )
+			{
+				u32 escaped;
+				if ( _uri[i] == '%' && i + 2 < _uri.size() && std::from_chars( _uri.data() + i + 1, _uri.data() + i + 3, escaped, 16 ).ec == std::errc() )
+				{
+					decoded += static_cast<char8_t>( escaped );
+					i += 2;
+				}
+				else
+				{
+					decoded += static_cast<char8_t>( _uri[i] );
+				}
+			}
+			return decoded;
+		}
+
+		//--------------------------------------------------------------------
+		bool LoadBuffers( const Utils::JsonValue& _document, const std::filesystem::path& _directory, std::span<const std::byte> _glbBinary, BufferSet& _out )
+		{
+			const std::span<const Utils::JsonValue> buffers = _document["buffers"].getElements();
+			_out.m_Files.reserve( buffers.size() );
+			_out.m_Decoded.reserve( buffers.size() );
+
+			for ( size_t i = 0; i < buffers.size(); i++ )
+			{
+				const Utils::JsonValue& buffer = buffers[i];
+				std::span<const std::byte> bytes;
+
+				if ( !buffer.contains( "uri" ) )
+				{
+					// Only the first buffer of a .glb may live in the binary chunk
+					if ( i != 0 || _glbBinary.empty() )
+						return false;
+					bytes = _glbBinary;
+				}
+				else if ( const std::string_view uri = buffer["uri"].asString(); uri.starts_with( "data:" ) )
+				{
+					const size_t payload = uri.find( ";base64," );
+					if ( payload == std::string_view::npos || !DecodeBase64( uri.substr( payload + 8 ), _out.m_Decoded.emplace_back() ) )
+						return false;
+					bytes = _out.m_Decoded.back();
+				}
+				else
+				{
+					const std::filesystem::path path = _directory / DecodeUri( uri );
+					if ( !_out.m_Files.emplace_back().open( path ) )
+					{
+						std::cerr << "Missing glTF buffer " << path << std::endl;
+						return false;
+					}
+					bytes = _out.m_Files.back().bytes();
+				}
+
+				const size_t byteLength = buffer["byteLength"].asU32();
+				if ( bytes.size() < byteLength )
+					return false;
+
+				_out.m_Buffers.push_back( bytes.first( byteLength ) );
+			}
+
+			return true;
+		}
+
+		//--------------------------------------------------------------------
+		Maths::Matrix4 NodeMatrix( const Utils::JsonValue& _node )
+		{
+			if ( const Utils::JsonValue& matrix = _node["matrix"]; matrix.size() == 16 )
+			{
+				// Column-major in glTF as well
+				auto column = [&matrix]( size_t _c ) {
+					return Maths::Vector4{ .x = static_cast<f32>( matrix[_c * 4].asNumber() ), .y = static_cast<f32>( matrix[_c * 4 + 1].asNumber() ),
+						.z = static_cast<f32>( matrix[_c * 4 + 2].asNumber() ), .w = static_cast<f32>( matrix[_c * 4 + 3].asNumber() ) };
+				};
+				return Maths::Matrix4{ .c1 = column( 0 ), .c2 = column( 1 ), .c3 = column( 2 ), .c4 = column( 3 ) };
+			}
+
+			const Utils::JsonValue& t = _node["translation"];
+			const Utils::JsonValue& r = _node["rotation"];
+			const Utils::JsonValue& s = _node["scale"];
+
+			const f32 x = static_cast<f32>( r[0].asNumber( 0.0 ) );
+			const f32 y = static_cast<f32>( r[1].asNumber( 0.0 ) );
+			const f32 z = static_cast<f32>( r[2].asNumber( 0.0 ) );
+			const f32 w = static_cast<f32>( r[3].asNumber( 1.0 ) );
+			const f32 sx = static_cast<f32>( s[0].asNumber( 1.0 ) );
+			const f32 sy = static_cast<f32>( s[1].asNumber( 1.0 ) );
+			const f32 sz = static_cast<f32>( s[2].asNumber( 1.0 ) );
+
+			// T * R * S
+			return Maths::Matrix4{
+				.c1 = { .x = ( 1.0f - 2.0f * ( y * y + z * z ) ) * sx, .y = 2.0f * ( x * y + z * w ) * sx, .z = 2.0f * ( x * z - y * w ) * sx, .w = 0.0f },
+				.c2 = { .x = 2.0f * ( x * y - z * w ) * sy, .y = ( 1.0f - 2.0f * ( x * x + z * z ) ) * sy, .z = 2.0f * ( y * z + x * w ) * sy, .w = 0.0f },
+				.c3 = { .x = 2.0f * ( x * z + y * w ) * sz, .y = 2.0f * ( y * z - x * w ) * sz, .z = ( 1.0f - 2.0f * ( x * x + y * y ) ) * sz, .w = 0.0f },
+				.c4 = { .x = static_cast<f32>( t[0].asNumber() ), .y = static_cast<f32>( t[1].asNumber() ), .z = static_cast<f32>( t[2].asNumber() ), .w = 1.0f }
+			};
+		}
+
+		//--------------------------------------------------------------------
+		void CollectNode( const Utils::JsonValue& _document, u32 _nodeIndex, const Maths::Matrix4& _parent, u32 _depth, std::vector<PrimitiveInstance>& _out )
+		{
+			const Utils::JsonValue& node = _document["nodes"][_nodeIndex];
+			if ( _depth > MAX_NODE_DEPTH || !node.isObject() )
+				return;
+
+			const Maths::Matrix4 world = _parent * NodeMatrix( node );
+
+			if ( node.contains( "mesh" ) )
+			{
+				for ( const Utils::JsonValue& primitive : _document["meshes"][node["mesh"].asU32()]["primitives"].getElements() )
+				{
+					_out.push_back( PrimitiveInstance{ .m_pPrimitive = &primitive, .m_World = world } );
+				}
+			}
+
+			for ( const Utils::JsonValue& child : node["children"].getElements() )
+			{
+				CollectNode( _document, child.asU32(), world, _depth + 1, _out );
+			}
+		}
+
+		//--------------------------------------------------------------------
+		// Of the linear part: zero scale is a common way to hide a node, it has no surface left to draw
+		f32 LinearDeterminant( const Maths::Matrix4& _world )
+		{
+			const Maths::Vector3 axisX{ _world.c1.x, _world.c1.y, _world.c1.z };
+			const Maths::Vector3 axisY{ _world.c2.x, _world.c2.y, _world.c2.z };
+			const Maths::Vector3 axisZ{ _world.c3.x, _world.c3.y, _world.c3.z };
+			return Maths::LinAlg::Dot( axisX, Maths::LinAlg::Cross( axisY, axisZ ) );
+		}
+
+		//--------------------------------------------------------------------
+		bool IsDrawn( const PrimitiveInstance& _instance )
+		{
+			const u32 mode = ( *_instance.m_pPrimitive )["mode"].asU32( MODE_TRIANGLES );
+			return ( mode == MODE_TRIANGLES || mode == MODE_TRIANGLE_STRIP || mode == MODE_TRIANGLE_FAN )
+				&& std::abs( LinearDeterminant( _instance.m_World ) ) >= std::numeric_limits<f32>::min();
+		}
+
+		//--------------------------------------------------------------------
+		// Grows _min and _max by the positions the instance bakes. glTF requires min and max on position accessors,
+		// their box's corners are transformed instead of every vertex. Files leaving them out are read through
+		void GrowBox( const Utils::JsonValue& _document, const BufferSet& _buffers, const PrimitiveInstance& _instance, Maths::Vector3& _min, Maths::Vector3& _max )
+		{
+			const u32 accessorIndex = ( *_instance.m_pPrimitive )["attributes"]["POSITION"].asU32( ~0u );
+			Accessor positions;
+			// Rejected by ExpandPrimitive
+			if ( !positions.resolve( _document, _buffers, accessorIndex ) || positions.getComponentCount() != 3 )
+				return;
+
+			auto grow = [&_min, &_max]( const Maths::Vector3& _position ) {
+				_min = Maths::Vector3{ .x = std::min( _min.x, _position.x ), .y = std::min( _min.y, _position.y ), .z = std::min( _min.z, _position.z ) };
+				_max = Maths::Vector3{ .x = std::max( _max.x, _position.x ), .y = std::max( _max.y, _position.y ), .z = std::max( _max.z, _position.z ) };
+			};
+
+			const Utils::JsonValue& accessor = _document["accessors"][accessorIndex];
+			const std::span<const Utils::JsonValue> boxMin = accessor["min"].getElements();
+			const std::span<const Utils::JsonValue> boxMax = accessor["max"].getElements();
+			// Normalized integer bounds are stored unnormalized, only float ones are used as they are
+			if ( positions.isFloat() && boxMin.size() == 3 && boxMax.size() == 3 )
+			{
+				for ( u32 corner = 0; corner < 8; corner++ )
+				{
+					const Maths::Vector3 position{
+						.x = static_cast<f32>( ( corner & 1 ? boxMax : boxMin )[0].asNumber() ),
+						.y = static_cast<f32>( ( corner & 2 ? boxMax : boxMin )[1].asNumber() ),
+						.z = static_cast<f32>( ( corner & 4 ? boxMax : boxMin )[2].asNumber() )
+					};
+					grow( _instance.m_World.TransformPoint( position ) );
+				}
+				return;
+			}
+
+			for ( u32 i = 0; i < positions.getCount(); i++ )
+			{
+				grow( _instance.m_World.TransformPoint( positions.readVector3( i ) ) );
+			}
+		}
+
+		//--------------------------------------------------------------------
+		bool ExpandPrimitive( const Utils::JsonValue& _document, const BufferSet& _buffers, const PrimitiveInstance& _instance, const Engine::PositionFrame& _frame,
+			Utils::JobSystem& _jobs, CornerBatch& _out )
+		{
+			// Points and lines have no surface to draw, and neither do nodes scaled to zero
+			if ( !IsDrawn( _instance ) )
+				return true;
+
+			const Utils::JsonValue& primitive = *_instance.m_pPrimitive;
+			const u32 mode = primitive["mode"].asU32( MODE_TRIANGLES );
+
+			const Utils::JsonValue& attributes = primitive["attributes"];
+
+			Accessor positions;
+			if ( !positions.resolve( _document, _buffers, attributes["POSITION"].asU32( ~0u ) ) || positions.getComponentCount() != 3 )
+				return false;
+
+			const u32 vertexCount = positions.getCount();
+
+			Accessor normals;
+			const bool hasNormals = attributes.contains( "NORMAL" );
+			if ( hasNormals && ( !normals.resolve( _document, _buffers, attributes["NORMAL"].asU32() ) || normals.getComponentCount() != 3 || normals.getCount() != vertexCount ) )
+				return false;
+
+			Accessor colors;
+			const bool hasColors = attributes.contains( "COLOR_0" );
+			if ( hasColors && ( !colors.resolve( _document, _buffers, attributes["COLOR_0"].asU32() ) || colors.getComponentCount() < 3 || colors.getCount() != vertexCount ) )
+				return false;
+
+			Accessor indices;
+			const bool hasIndices = primitive.contains( "indices" );
+			if ( hasIndices && ( !indices.resolve( _document, _buffers, primitive["indices"].asU32() ) || !indices.isIndexType() ) )
+				return false;
+
+			// Vertices are transformed once, then copied to every corner using them
+			const Maths::Matrix4& world = _instance.m_World;
+
+			// Mirroring transforms turn the triangles inside out, baking them swaps two corners back
+			const bool flipWinding = LinearDeterminant( world ) < 0.0f;
+
+			// Only needed to color by normal
+			const Maths::Matrix4 normalMatrix = hasNormals && !hasColors ? world.AffineInverse().Transpose() : Maths::Matrix4{};
+
+			std::vector<Engine::Vertex> vertices( vertexCount );
+			_jobs.parallelFor( vertexCount, EXPAND_GRAIN, [&]( u32 _begin, u32 _end ) {
+				for ( u32 i = _begin; i < _end; i++ )
+				{
+					Maths::Vector3 color = MeshImport::DEFAULT_COLOR;
+					if ( hasColors )
+					{
+						color = colors.readVector3( i );
+					}
+					else if ( hasNormals )
+					{
+						Maths::Vector3 normal = normalMatrix.TransformVector( normals.readVector3( i ) );
+						color = MeshImport::NormalColor( normal.Normalize() );
+					}
+
+					vertices[i] = Engine::Vertex( _frame.toStored( world.TransformPoint( positions.readVector3( i ) ) ), color );
+				}
+			} );
+
+			const u32 elementCount = hasIndices ? indices.getCount() : vertexCount;
+			u32 triangleCount = 0;
+			if ( mode == MODE_TRIANGLES )
+				triangleCount = elementCount / 3;
+			else if ( elementCount >= 3 )
+				triangleCount = elementCount - 2;
+
+			std::atomic<bool> valid{ true };
+			_out.resize( size_t( triangleCount ) * 3 );
+			_jobs.parallelFor( triangleCount, EXPAND_GRAIN, [&]( u32 _begin, u32 _end ) {
+				for ( u32 t = _begin; t < _end; t++ )
+				{
+					std::array<u32, 3> elements{ 3 * t, 3 * t + 1, 3 * t + 2 };
+					if ( mode == MODE_TRIANGLE_STRIP )
+					{
+						// Every other strip triangle is flipped back to the winding of the first
+						elements = ( t & 1 ) ? std::array<u32, 3>{ t + 1, t, t + 2 } : std::array<u32, 3>{ t, t + 1, t + 2 };
+					}
+					else if ( mode == MODE_TRIANGLE_FAN )
+					{
+						elements = { 0, t + 1, t + 2 };
+					}
+
+					for ( u32 corner = 0; corner < 3; corner++ )
+					{
+						const u32 index = hasIndices ? indices.readIndex( elements[corner] ) : elements[corner];
+						if ( index >= vertexCount )
+						{
+							valid.store( false, std::memory_order_relaxed );
+							return;
+						}
+
+						const u32 outCorner = flipWinding && corner != 0 ? 3 - corner : corner;
+						_out[size_t( t ) * 3 + outCorner] = vertices[index];
+					}
+				}
+			} );
+
+			return valid;
+		}
+	} // end anonymous namespace
+
+	//--------------------------------------------------------------------
+	bool GltfParser::parse( const std::filesystem::path& _path, std::span<const std::byte> _data, Utils::JobSystem& _jobs, std::vector<CornerBatch>& _batches,
+		Engine::PositionFrame& _frame )
+	{
+		std::string_view json( reinterpret_cast<const char*>( _data.data() ), _data.size() );
+		std::span<const std::byte> binary;
+
+		// .glb: 12-byte header, a JSON chunk, then an optional binary chunk
+		if ( _data.size() >= 12 && ReadU32( _data, 0 ) == GLB_MAGIC )
+		{
+			const size_t length = ReadU32( _data, 8 );
+			if ( ReadU32( _data, 4 ) != GLB_VERSION || length > _data.size() || length < 20 )
+				return false;
+
+			const size_t jsonLength = ReadU32( _data, 12 );
+			if ( ReadU32( _data, 16 ) != GLB_CHUNK_JSON || 20 + jsonLength > length )
+				return false;
+			json = std::string_view( reinterpret_cast<const char*>( _data.data() + 20 ), jsonLength );
+
+			// Chunks are padded to 4 bytes
+			const size_t binOffset = 20 + ( ( jsonLength + 3 ) & ~size_t( 3 ) );
+			if ( binOffset + 8 <= length && ReadU32( _data, binOffset + 4 ) == GLB_CHUNK_BIN )
+			{
+				const size_t binLength = ReadU32( _data, binOffset );
+				if ( binOffset + 8 + binLength > length )
+					return false;
+				binary = _data.subspan( binOffset + 8, binLength );
+			}
+		}
+
+		const std::optional<Utils::JsonValue> document = Utils::JsonValue::parse( json );
+		if ( !document || !document->isObject() )
+			return false;
+
+		BufferSet buffers;
+		if ( !LoadBuffers( *document, _path.parent_path(), binary, buffers ) )
+			return false;
+
+		std::vector<PrimitiveInstance> instances;
+		const Utils::JsonValue& scene = ( *document )["scenes"][( *document )["scene"].asU32()];
+		if ( scene.isObject() )
+		{
+			for ( const Utils::JsonValue& node : scene["nodes"].getElements() )
+			{
+				CollectNode( *document, node.asU32(), Maths::Matrix4::Identity(), 0, instances );
+			}
+		}
+		else
+		{
+			// No scene to place meshes, each is drawn once untransformed
+			for ( const Utils::JsonValue& mesh : ( *document )["meshes"].getElements() )
+			{
+				for ( const Utils::JsonValue& primitive : mesh["primitives"].getElements() )
+				{
+					instances.push_back( PrimitiveInstance{ .m_pPrimitive = &primitive, .m_World = Maths::Matrix4::Identity() } );
+				}
+			}
+		}
+
+		// Node transforms are baked, the frame has to fit every instance before any is expanded
+		Maths::Vector3 min{ std::numeric_limits<f32>::max(), std::numeric_limits<f32>::max(), std::numeric_limits<f32>::max() };
+		Maths::Vector3 max{ -min.x, -min.y, -min.z };
+		for ( const PrimitiveInstance& instance : instances )
+		{
+			if ( IsDrawn( instance ) )
+				GrowBox( *document, buffers, instance, min, max );
+		}
+		_frame = min.x <= max.x ? Engine::PositionFrame::FromBox( min, max ) : Engine::PositionFrame{};
+
+		const u32 instanceCount = static_cast<u32>( instances.size() );
+		std::atomic<bool> valid{ true };
+		_batches.resize( instanceCount );
+		_jobs.parallelFor( instanceCount, 1, [&]( u32 _begin, u32 _end ) {
+			for ( u32 i = _begin; i < _end; i++ )
+			{
+				if ( !ExpandPrimitive( *document, buffers, instances[i], _frame, _jobs, _batches[i] ) )
+					valid.store( false, std::memory_order_relaxed );
+			}
+		} );
+
+		return valid;
+	}
+
+} // end namespace Scene
@@ -0,0 +1,22 @@
+#pragma once
+
+#include "../../Utils/Common.h"
+#include <filesystem>
+#include <span>
+
+#include "MeshImporter.h"
+
+namespace Scene {
+
+	// glTF 2.0, as .gltf with external or base64 buffers, or as binary .glb.
+	// Triangle primitives of the default scene are flattened into one mesh with node transforms applied;
+	// positions, normals and COLOR_0 are read, materials, skins, morph targets and sparse accessors are not.
+	class GltfParser
+	{
+	public:
+		// _path locates external buffers, one batch per primitive instance. Positions are stored relative to _frame, which fits them all
+		static bool parse( const std::filesystem::path& _path, std::span<const std::byte> _data, Utils::JobSystem& _jobs, std::vector<CornerBatch>& _batches,
+			Engine::PositionFrame& _frame );
+	};
+
+} // end namespace Scene
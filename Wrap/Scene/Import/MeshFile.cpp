@@ -0,0 +1,302 @@
+#include "MeshFile.h"
+
+#include <cstring>
+#include <fstream>
+
+#include "MeshImporter.h"
+
+namespace Scene {
+	using namespace MeshFileFormat;
+
+	namespace {
+		using DrawLayout = Engine::VertexLayout<Engine::Vertex>;
+
+		//--------------------------------------------------------------------
+		// Layout of the Engine::Vertex this build draws with, a file must match it exactly to be copied as is
+		std::array<VertexAttribute, DrawLayout::ATTRIBUTE_COUNT> CurrentLayout()
+		{
+			std::array<VertexAttribute, DrawLayout::ATTRIBUTE_COUNT> layout{};
+			for ( u32 i = 0; i < DrawLayout::ATTRIBUTE_COUNT; i++ )
+			{
+				layout[i] = VertexAttribute{
+					.m_Location = DrawLayout::ATTRIBUTES[i].m_Location,
+					.m_Format = static_cast<u32>( DrawLayout::ATTRIBUTES[i].m_Format ),
+					.m_Offset = DrawLayout::ATTRIBUTES[i].m_Offset,
+					.m_Reserved = 0
+				};
+			}
+
+			return layout;
+		}
+
+		//--------------------------------------------------------------------
+		u64 AlignBlob( u64 _offset )
+		{
+			return ( _offset + BLOB_ALIGNMENT - 1 ) & ~( BLOB_ALIGNMENT - 1 );
+		}
+
+		//--------------------------------------------------------------------
+		std::vector<GeometryLod> ToGeometryLods( std::span<const LodEntry> _lods )
+		{
+			std::vector<GeometryLod> lods( _lods.size() );
+			std::ranges::transform( _lods, lods.begin(), []( const LodEntry& _lod ) {
+				return GeometryLod{ .m_FirstIndex = _lod.m_FirstIndex, .m_IndexCount = _lod.m_IndexCount, .m_Error = _lod.m_Error,
+					.m_FirstCluster = _lod.m_FirstCluster, .m_ClusterCount = _lod.m_ClusterCount };
+			} );
+
+			return lods;
+		}
+
+		//--------------------------------------------------------------------
+		std::vector<GeometryCluster> ToGeometryClusters( std::span<const ClusterEntry> _clusters )
+		{
+			std::vector<GeometryCluster> clusters( _clusters.size() );
+			std::ranges::transform( _clusters, clusters.begin(), []( const ClusterEntry& _cluster ) {
+				return GeometryCluster{ .m_FirstIndex = _cluster.m_FirstIndex, .m_IndexCount = _cluster.m_IndexCount, .m_Center = _cluster.m_Center,
+					.m_Radius = _cluster.m_Radius, .m_ConeAxis = _cluster.m_ConeAxis, .m_ConeCutoff = _cluster.m_ConeCutoff };
+			} );
+
+			return clusters;
+		}
+
+		//--------------------------------------------------------------------
+		// The frame's scale is positive, object space keeps the box's corners in order
+		Bounds ComputeBounds( std::span<const Engine::Vertex> _vertices, const Engine::PositionFrame& _frame )
+		{
+			if ( _vertices.empty() )
+				return Bounds{};
+
+			Bounds bounds{ .m_Min = _vertices[0].getPosition(), .m_Max = _vertices[0].getPosition() };
+			for ( const Engine::Vertex& vertex : _vertices )
+			{
+				const Maths::Vector3 position = vertex.getPosition();
+				bounds.m_Min = Maths::Vector3{ .x = std::min( bounds.m_Min.x, position.x ), .y = std::min( bounds.m_Min.y, position.y ), .z = std::min( bounds.m_Min.z, position.z ) };
+				bounds.m_Max = Maths::Vector3{ .x = std::max( bounds.m_Max.x, position.x ), .y = std::max( bounds.m_Max.y, position.y ), .z = std::max( bounds.m_Max.z, position.z ) };
+			}
+
+			return Bounds{ .m_Min = _frame.toObject( bounds.m_Min ), .m_Max = _frame.toObject( bounds.m_Max ) };
+		}
+	} // end anonymous namespace
+
+	//--------------------------------------------------------------------
+	std::shared_ptr<const MeshFile> MeshFile::open( const std::filesystem::path& _path )
+	{
+		// Constructor is private, so make_shared cannot be used
+		std::shared_ptr<MeshFile> pFile( new MeshFile() );
+		if ( !pFile->m_File.open( _path ) )
+		{
+			std::cerr << "Failed to open mesh " << _path << std::endl;
+			return nullptr;
+		}
+
+		const auto bytes = pFile->m_File.bytes();
+		if ( bytes.size() < sizeof( FileHeader ) )
+		{
+			std::cerr << "Mesh file " << _path << " is truncated" << std::endl;
+			return nullptr;
+		}
+
+		const auto* pHeader = reinterpret_cast<const FileHeader*>( bytes.data() );
+		const u64 attributesBegin = sizeof( FileHeader );
+		const u64 lodsBegin = attributesBegin + u64( sizeof( VertexAttribute ) ) * pHeader->m_AttributeCount;
+		const u64 clustersBegin = lodsBegin + u64( sizeof( LodEntry ) ) * pHeader->m_LodCount;
+		const u64 tableEnd = clustersBegin + u64( sizeof( ClusterEntry ) ) * pHeader->m_ClusterCount;
+
+		if ( pHeader->m_Magic != MAGIC || pHeader->m_Version != VERSION || tableEnd > bytes.size() )
+		{
+			std::cerr << "Mesh file " << _path << " is invalid or out of date, convert it again" << std::endl;
+			return nullptr;
+		}
+
+		const auto layout = CurrentLayout();
+		const std::span<const VertexAttribute> attributes( reinterpret_cast<const VertexAttribute*>( bytes.data() + attributesBegin ), pHeader->m_AttributeCount );
+		const bool layoutMatches = pHeader->m_VertexStride == sizeof( Engine::Vertex ) && pHeader->m_IndexSize == sizeof( u32 )
+			&& std::ranges::equal( attributes, layout, []( const VertexAttribute& _a, const VertexAttribute& _b ) {
+				return _a.m_Location == _b.m_Location && _a.m_Format == _b.m_Format && _a.m_Offset == _b.m_Offset;
+			} );
+
+		if ( !layoutMatches )
+		{
+			std::cerr << "Mesh file " << _path << " was written with a different vertex layout, convert it again" << std::endl;
+			return nullptr;
+		}
+
+		// Also false for NaN
+		if ( !( pHeader->m_Frame.m_Scale > 0.0f ) )
+		{
+			std::cerr << "Mesh file " << _path << " has an invalid position frame" << std::endl;
+			return nullptr;
+		}
+
+		const u64 vertexBytes = u64( pHeader->m_VertexCount ) * sizeof( Engine::Vertex );
+		const u64 indexBytes = u64( pHeader->m_IndexCount ) * sizeof( u32 );
+		// Subtract form, hostile offsets near the u64 limit would wrap the sums
+		const u64 fileSize = bytes.size();
+		auto inFile = [fileSize, tableEnd]( u64 _offset, u64 _size ) { return _offset >= tableEnd && _offset <= fileSize && _size <= fileSize - _offset; };
+
+		if ( pHeader->m_VertexOffset % BLOB_ALIGNMENT != 0 || pHeader->m_IndexOffset % BLOB_ALIGNMENT != 0
+			|| !inFile( pHeader->m_VertexOffset, vertexBytes ) || !inFile( pHeader->m_IndexOffset, indexBytes ) )
+		{
+			std::cerr << "Mesh file " << _path << " has out of range blobs" << std::endl;
+			return nullptr;
+		}
+
+		// Both ranges are in the file, their ends can't overflow anymore
+		if ( vertexBytes > 0 && indexBytes > 0
+			&& pHeader->m_IndexOffset < pHeader->m_VertexOffset + vertexBytes && pHeader->m_VertexOffset < pHeader->m_IndexOffset + indexBytes )
+		{
+			std::cerr << "Mesh file " << _path << " has overlapping vertex and index blobs" << std::endl;
+			return nullptr;
+		}
+
+		pFile->m_Lods = std::span<const LodEntry>( reinterpret_cast<const LodEntry*>( bytes.data() + lodsBegin ), pHeader->m_LodCount );
+		pFile->m_Clusters = std::span<const ClusterEntry>( reinterpret_cast<const ClusterEntry*>( bytes.data() + clustersBegin ), pHeader->m_ClusterCount );
+		for ( const LodEntry& lod : pFile->m_Lods )
+		{
+			if ( u64( lod.m_FirstIndex ) + lod.m_IndexCount > pHeader->m_IndexCount || u64( lod.m_FirstCluster ) + lod.m_ClusterCount > pHeader->m_ClusterCount )
+			{
+				std::cerr << "Mesh file " << _path << " has an out of range LOD" << std::endl;
+				return nullptr;
+			}
+		}
+
+		for ( const ClusterEntry& cluster : pFile->m_Clusters )
+		{
+			if ( u64( cluster.m_FirstIndex ) + cluster.m_IndexCount > pHeader->m_IndexCount )
+			{
+				std::cerr << "Mesh file " << _path << " has an out of range cluster" << std::endl;
+				return nullptr;
+			}
+		}
+
+		pFile->m_pHeader = pHeader;
+		pFile->m_Vertices = std::span<const Engine::Vertex>( reinterpret_cast<const Engine::Vertex*>( bytes.data() + pHeader->m_VertexOffset ), pHeader->m_VertexCount );
+		pFile->m_Indices = std::span<const u32>( reinterpret_cast<const u32*>( bytes.data() + pHeader->m_IndexOffset ), pHeader->m_IndexCount );
+
+		// One pass over the indices, cheaper than the staging copy: a stale or corrupt file would otherwise make
+		// vertex pulling read out of bounds, and 16-bit index buffers would wrap the value silently
+		if ( !pFile->m_Indices.empty() && std::ranges::max( pFile->m_Indices ) >= pHeader->m_VertexCount )
+		{
+			std::cerr << "Mesh file " << _path << " has out of range indices" << std::endl;
+			return nullptr;
+		}
+
+		return pFile;
+	}
+
+	//--------------------------------------------------------------------
+	GeometryAssetRef MeshFile::load( const std::filesystem::path& _path )
+	{
+		std::shared_ptr<const MeshFile> pFile = open( _path );
+		if ( !pFile )
+			return nullptr;
+
+		std::vector<GeometryLod> lods = ToGeometryLods( pFile->m_Lods );
+		std::vector<GeometryCluster> clusters = ToGeometryClusters( pFile->m_Clusters );
+		const Bounds& bounds = pFile->getBounds();
+
+		return GeometryAsset::create( static_cast<u32>( pFile->m_Vertices.size() ), static_cast<u32>( pFile->m_Indices.size() ),
+			[pFile]( std::span<Engine::Vertex> _vertices, std::span<u32> _indices ) {
+				std::memcpy( _vertices.data(), pFile->m_Vertices.data(), pFile->m_Vertices.size_bytes() );
+				std::memcpy( _indices.data(), pFile->m_Indices.data(), pFile->m_Indices.size_bytes() );
+			},
+			std::move( lods ), std::move( clusters ), GeometryBounds::FromBox( bounds.m_Min, bounds.m_Max ), pFile->getFrame(), pFile->m_pHeader->m_Hash );
+	}
+
+	//--------------------------------------------------------------------
+	bool MeshFile::write( const std::filesystem::path& _dest, std::span<const Engine::Vertex> _vertices, std::span<const u32> _indices,
+		std::span<const LodEntry> _lods /*= {}*/, std::span<const ClusterEntry> _clusters /*= {}*/, const Engine::PositionFrame& _frame /*= {}*/ )
+	{
+		const LodEntry fullLod{ .m_FirstIndex = 0, .m_IndexCount = static_cast<u32>( _indices.size() ), .m_Error = 0.0f, .m_FirstCluster = 0, .m_ClusterCount = 0, .m_Reserved = 0 };
+		const std::span<const LodEntry> lods = _lods.empty() ? std::span<const LodEntry>( &fullLod, 1 ) : _lods;
+		const auto layout = CurrentLayout();
+
+		const u64 vertexOffset = AlignBlob( sizeof( FileHeader ) + sizeof( VertexAttribute ) * layout.size() + lods.size_bytes() + _clusters.size_bytes() );
+		const u64 indexOffset = AlignBlob( vertexOffset + _vertices.size_bytes() );
+
+		// Hashed as MeshFile::load will hand the content to the renderer
+		GeometryHasher hasher;
+		hasher.add( _vertices );
+		const GeometryHash hash = hasher.finish( _indices, ToGeometryLods( lods ), ToGeometryClusters( _clusters ), _frame );
+
+		const FileHeader header{
+			.m_Magic = MAGIC,
+			.m_Version = VERSION,
+			.m_VertexCount = static_cast<u32>( _vertices.size() ),
+			.m_IndexCount = static_cast<u32>( _indices.size() ),
+			.m_VertexStride = sizeof( Engine::Vertex ),
+			.m_IndexSize = sizeof( u32 ),
+			.m_AttributeCount = static_cast<u32>( layout.size() ),
+			.m_LodCount = static_cast<u32>( lods.size() ),
+			.m_ClusterCount = static_cast<u32>( _clusters.size() ),
+			.m_Reserved = 0,
+			.m_Bounds = ComputeBounds( _vertices, _frame ),
+			.m_Frame = _frame,
+			.m_VertexOffset = vertexOffset,
+			.m_IndexOffset = indexOffset,
+			.m_Hash = hash
+		};
+
+		std::ofstream out( _dest, std::ios::binary | std::ios::trunc );
+		if ( !out )
+		{
+			std::cerr << "Error writing to " << _dest << " Verify directory exists" << std::endl;
+			return false;
+		}
+
+		const std::array<char, BLOB_ALIGNMENT> padding{};
+		auto padTo = [&]( u64 _offset ) { out.write( padding.data(), _offset - static_cast<u64>( out.tellp() ) ); };
+
+		out.write( reinterpret_cast<const char*>( &header ), sizeof( header ) );
+		out.write( reinterpret_cast<const char*>( layout.data() ), sizeof( VertexAttribute ) * layout.size() );
+		out.write( reinterpret_cast<const char*>( lods.data() ), lods.size_bytes() );
+		out.write( reinterpret_cast<const char*>( _clusters.data() ), _clusters.size_bytes() );
+		padTo( vertexOffset );
+		out.write( reinterpret_cast<const char*>( _vertices.data() ), _vertices.size_bytes() );
+		padTo( indexOffset );
+		out.write( reinterpret_cast<const char*>( _indices.data() ), _indices.size_bytes() );
+
+		return static_cast<bool>( out );
+	}
+
+	//--------------------------------------------------------------------
+	bool MeshFile::convert( const std::filesystem::path& _source, const std::filesystem::path& _dest )
+	{
+		std::shared_ptr<ImportedMesh> pMesh = MeshImporter::parse( _source );
+		if ( !pMesh )
+			return false;
+
+		const MeshOptimizeReport report = pMesh->optimize();
+		pMesh->generateLods();
+		pMesh->buildClusters();
+
+		std::vector<Engine::Vertex> vertices( pMesh->getVertexCount() );
+		std::vector<u32> indices( pMesh->getIndexCount() );
+		pMesh->write( vertices, indices, Utils::JobSystem::Instance() );
+
+		std::vector<LodEntry> lods( pMesh->getLods().size() );
+		std::ranges::transform( pMesh->getLods(), lods.begin(), []( const GeometryLod& _lod ) {
+			return LodEntry{ .m_FirstIndex = _lod.m_FirstIndex, .m_IndexCount = _lod.m_IndexCount, .m_Error = _lod.m_Error,
+				.m_FirstCluster = _lod.m_FirstCluster, .m_ClusterCount = _lod.m_ClusterCount, .m_Reserved = 0 };
+		} );
+		std::vector<ClusterEntry> clusters( pMesh->getClusters().size() );
+		std::ranges::transform( pMesh->getClusters(), clusters.begin(), []( const GeometryCluster& _cluster ) {
+			return ClusterEntry{ .m_FirstIndex = _cluster.m_FirstIndex, .m_IndexCount = _cluster.m_IndexCount, .m_Center = _cluster.m_Center,
+				.m_Radius = _cluster.m_Radius, .m_ConeAxis = _cluster.m_ConeAxis, .m_ConeCutoff = _cluster.m_ConeCutoff };
+		} );
+
+		if ( !write( _dest, vertices, indices, lods, clusters, pMesh->getFrame() ) )
+			return false;
+
+		std::cout << "Converted " << _source << " into " << _dest << ": " << pMesh->getTriangleCount() << " triangles, "
+			<< pMesh->getVertexCount() << " vertices, ACMR " << report.m_Before.m_Acmr << " -> " << report.m_After.m_Acmr
+			<< ", ATVR " << report.m_Before.m_Atvr << " -> " << report.m_After.m_Atvr << ", LOD triangles";
+		for ( const GeometryLod& lod : pMesh->getLods() )
+		{
+			std::cout << " " << lod.m_IndexCount / 3;
+		}
+		std::cout << ", " << clusters.size() << " clusters" << std::endl;
+		return true;
+	}
+
+} // end namespace Scene
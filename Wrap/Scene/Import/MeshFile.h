@@ -0,0 +1,123 @@
+#pragma once
+
+#include "../../Utils/Common.h"
+#include <filesystem>
+#include <span>
+
+#include "../GeometryAsset.h"
+#include "../../Maths/Vector3.h"
+#include "../../Utils/MappedFile.h"
+
+namespace Scene {
+
+	// Wrap native mesh layout:
+	//   FileHeader | VertexAttribute[attributeCount] | LodEntry[lodCount] | ClusterEntry[clusterCount] | vertex blob | index blob
+	// Blobs are addressed by offsets from the start of the file and stored exactly as the GPU buffers expect them,
+	// so loading is a mapping plus one copy of each blob into upload staging memory
+	namespace MeshFileFormat {
+		constexpr u32 MAGIC = 0x48534D57; // "WMSH"
+		constexpr u32 VERSION = 4;
+		// Largest minStorageBufferOffsetAlignment in the wild, blobs stay bindable at any offset
+		constexpr u64 BLOB_ALIGNMENT = 256;
+		constexpr const char* EXTENSION = ".wmesh";
+
+		struct Bounds
+		{
+			Maths::Vector3 m_Min;
+			Maths::Vector3 m_Max;
+		};
+
+		struct FileHeader
+		{
+			u32 m_Magic;
+			u32 m_Version;
+			u32 m_VertexCount;
+			u32 m_IndexCount;
+			u32 m_VertexStride;
+			u32 m_IndexSize;
+			u32 m_AttributeCount;
+			u32 m_LodCount;
+			u32 m_ClusterCount;
+			u32 m_Reserved;
+			// Object space
+			Bounds m_Bounds;
+			// Of the stored vertex positions
+			Engine::PositionFrame m_Frame;
+			u64 m_VertexOffset;
+			u64 m_IndexOffset;
+			// Of the content as loaded, computed when writing so loading never reads the blobs
+			GeometryHash m_Hash;
+		};
+
+		// Mirrors VkVertexInputAttributeDescription of binding 0
+		struct VertexAttribute
+		{
+			u32 m_Location;
+			u32 m_Format;
+			u32 m_Offset;
+			u32 m_Reserved;
+		};
+
+		// Index range drawn for one level of detail, LOD 0 is the full mesh
+		struct LodEntry
+		{
+			u32 m_FirstIndex;
+			u32 m_IndexCount;
+			// Object space distance from the full mesh
+			f32 m_Error;
+			// Into the cluster table, none if the level is drawn whole
+			u32 m_FirstCluster;
+			u32 m_ClusterCount;
+			u32 m_Reserved;
+		};
+
+		// Index range culled as a unit, see Scene::GeometryCluster
+		struct ClusterEntry
+		{
+			u32 m_FirstIndex;
+			u32 m_IndexCount;
+			Maths::Vector3 m_Center;
+			f32 m_Radius;
+			Maths::Vector3 m_ConeAxis;
+			f32 m_ConeCutoff;
+		};
+	} // end namespace MeshFileFormat
+
+	class MeshFile
+	{
+	public:
+		MeshFile( const MeshFile& ) = delete;
+		MeshFile& operator=( const MeshFile& ) = delete;
+
+		// nullptr if the file is missing, invalid or was written with a different Engine::Vertex layout
+		static std::shared_ptr<const MeshFile> open( const std::filesystem::path& _path );
+
+		// The asset keeps the mapping alive until its upload copies the blobs into staging memory
+		static GeometryAssetRef load( const std::filesystem::path& _path );
+
+		// Empty _lods writes a single LOD covering every index, the vertex positions are relative to _frame
+		static bool write( const std::filesystem::path& _dest, std::span<const Engine::Vertex> _vertices, std::span<const u32> _indices,
+			std::span<const MeshFileFormat::LodEntry> _lods = {}, std::span<const MeshFileFormat::ClusterEntry> _clusters = {}, const Engine::PositionFrame& _frame = {} );
+
+		// Imports _source with Scene::MeshImporter and writes it as a mesh file
+		static bool convert( const std::filesystem::path& _source, const std::filesystem::path& _dest );
+
+		std::span<const Engine::Vertex> getVertices() const { return m_Vertices; };
+		std::span<const u32> getIndices() const { return m_Indices; };
+		std::span<const MeshFileFormat::LodEntry> getLods() const { return m_Lods; };
+		std::span<const MeshFileFormat::ClusterEntry> getClusters() const { return m_Clusters; };
+		const MeshFileFormat::Bounds& getBounds() const { return m_pHeader->m_Bounds; };
+		const Engine::PositionFrame& getFrame() const { return m_pHeader->m_Frame; };
+
+	private:
+		MeshFile() = default;
+
+		MappedFile m_File;
+		const MeshFileFormat::FileHeader* m_pHeader{ nullptr };
+		std::span<const MeshFileFormat::LodEntry> m_Lods;
+		std::span<const MeshFileFormat::ClusterEntry> m_Clusters;
+		std::span<const Engine::Vertex> m_Vertices;
+		std::span<const u32> m_Indices;
+	};
+
+} // end namespace Scene
@@ -0,0 +1,364 @@
+#include "MeshImporter.h"
+
+#include <bit>
+#include <cctype>
+#include <cstring>
+#include <limits>
+#include <utility>
+
+#include "ObjParser.h"
+#include "GltfParser.h"
+#include "../../Utils/MappedFile.h"
+
+namespace Scene {
+
+	namespace {
+		// Vertices copied per job when writing out
+		constexpr u32 WRITE_GRAIN = 16384;
+
+		// Corners per deduplication work item
+		constexpr u32 SLICE_SIZE = 1 << 16;
+
+		// Corners are partitioned by the top hash bits, each shard then has its own small table
+		constexpr u32 SHARD_BITS = 8;
+		constexpr u32 SHARD_COUNT = 1 << SHARD_BITS;
+
+		// Table slots: the corner's 32-bit hash in the upper half, the shard-local vertex index in the lower half
+		constexpr u64 EMPTY_SLOT = ~0ull;
+
+		// Contiguous run of corners inside one batch
+		struct Slice {
+			const Engine::Vertex* m_pCorners;
+			u32 m_First;
+			u32 m_Count;
+		};
+
+		// Copied rather than pointed to, so a shard reads its corners sequentially
+		struct ShardedCorner {
+			Engine::Vertex m_Vertex;
+			u32 m_Corner;
+			u32 m_Hash;
+		};
+
+		//--------------------------------------------------------------------
+		u8 ShardOf( u64 _hash )
+		{
+			return static_cast<u8>( _hash >> ( 64 - SHARD_BITS ) );
+		}
+
+		//--------------------------------------------------------------------
+		std::string Lowercase( std::string _text )
+		{
+			std::ranges::transform( _text, _text.begin(), []( char _c ) { return static_cast<char>( std::tolower( static_cast<unsigned char>( _c ) ) ); } );
+			return _text;
+		}
+	} // end anonymous namespace
+
+	//--------------------------------------------------------------------
+	void ImportedMesh::write( std::span<Engine::Vertex> _vertices, std::span<u32> _indices, Utils::JobSystem& _jobs ) const
+	{
+		assert( _vertices.size() == m_Unique.size() && _indices.size() == m_Indices.size() );
+
+		_jobs.parallelFor( getVertexCount(), WRITE_GRAIN, [&]( u32 _begin, u32 _end ) {
+			for ( u32 i = _begin; i < _end; i++ )
+			{
+				_vertices[i] = *m_Unique[i];
+			}
+		} );
+
+		std::memcpy( _indices.data(), m_Indices.data(), m_Indices.size() * sizeof( u32 ) );
+	}
+
+	//--------------------------------------------------------------------
+	GeometryHash ImportedMesh::hashContent() const
+	{
+		GeometryHasher hasher;
+		for ( const Engine::Vertex* pVertex : m_Unique )
+		{
+			hasher.add( *pVertex );
+		}
+		return hasher.finish( m_Indices, m_Lods, m_Clusters, m_Frame );
+	}
+
+	//--------------------------------------------------------------------
+	MeshOptimizeReport ImportedMesh::optimize()
+	{
+		MeshOptimizeReport report;
+		report.m_Before = MeshOptimizer::analyzeVertexCache( m_Indices, getVertexCount() );
+
+		MeshOptimizer::optimizeVertexCache( m_Indices, getVertexCount() );
+
+		MeshOptimizer::optimizeOverdraw( m_Indices, getPositions() );
+
+		// Reordering vertices only moves the pointers, the corners stay where the parser put them
+		std::vector<u32> remap;
+		std::vector<const Engine::Vertex*> fetchOrdered( MeshOptimizer::optimizeVertexFetch( m_Indices, getVertexCount(), remap ) );
+		for ( size_t v = 0; v < m_Unique.size(); v++ )
+		{
+			if ( remap[v] != ~0u )
+			{
+				fetchOrdered[remap[v]] = m_Unique[v];
+			}
+		}
+		m_Unique = std::move( fetchOrdered );
+
+		report.m_After = MeshOptimizer::analyzeVertexCache( m_Indices, getVertexCount() );
+		return report;
+	}
+
+	//--------------------------------------------------------------------
+	std::vector<Maths::Vector3> ImportedMesh::getPositions() const
+	{
+		std::vector<Maths::Vector3> positions( getVertexCount() );
+		std::ranges::transform( m_Unique, positions.begin(), [this]( const Engine::Vertex* _pVertex ) { return m_Frame.toObject( _pVertex->getPosition() ); } );
+		return positions;
+	}
+
+	//--------------------------------------------------------------------
+	void ImportedMesh::generateLods()
+	{
+		const std::vector<Maths::Vector3> positions = getPositions();
+
+		if ( !positions.empty() )
+		{
+			Maths::Vector3 min = positions[0];
+			Maths::Vector3 max = min;
+			for ( const Maths::Vector3& position : positions )
+			{
+				min = Maths::Vector3{ .x = std::min( min.x, position.x ), .y = std::min( min.y, position.y ), .z = std::min( min.z, position.z ) };
+				max = Maths::Vector3{ .x = std::max( max.x, position.x ), .y = std::max( max.y, position.y ), .z = std::max( max.z, position.z ) };
+			}
+			m_Bounds = GeometryBounds::FromBox( min, max );
+		}
+
+		m_Lods = MeshOptimizer::generateLods( m_Indices, positions );
+	}
+
+	//--------------------------------------------------------------------
+	void ImportedMesh::buildClusters()
+	{
+		if ( m_Lods.empty() )
+		{
+			m_Lods.push_back( GeometryLod{ .m_FirstIndex = 0, .m_IndexCount = getIndexCount(), .m_Error = 0.0f } );
+		}
+
+		m_Clusters = MeshOptimizer::buildClusters( m_Indices, getPositions(), m_Lods );
+	}
+
+	//--------------------------------------------------------------------
+	std::shared_ptr<ImportedMesh> MeshImporter::parse( const std::filesystem::path& _path, Utils::JobSystem& _jobs /*= Utils::JobSystem::Instance()*/ )
+	{
+		MappedFile file;
+		if ( !file.open( _path ) )
+		{
+			std::cerr << "Failed to open mesh " << _path << std::endl;
+			return nullptr;
+		}
+
+		const std::string extension = Lowercase( _path.extension().string() );
+
+		std::vector<CornerBatch> batches;
+		Engine::PositionFrame frame;
+		bool parsed = false;
+		if ( extension == ".obj" )
+		{
+			parsed = ObjParser::parse( std::string_view( reinterpret_cast<const char*>( file.data() ), file.size() ), _jobs, batches, frame );
+		}
+		else if ( extension == ".gltf" || extension == ".glb" )
+		{
+			parsed = GltfParser::parse( _path, file.bytes(), _jobs, batches, frame );
+		}
+		else
+		{
+			std::cerr << "Unsupported mesh format " << _path << std::endl;
+			return nullptr;
+		}
+
+		if ( !parsed )
+		{
+			std::cerr << "Failed to parse mesh " << _path << std::endl;
+			return nullptr;
+		}
+
+		return deduplicate( std::move( batches ), frame, _jobs );
+	}
+
+	//--------------------------------------------------------------------
+	GeometryAssetRef MeshImporter::load( const std::filesystem::path& _path )
+	{
+		std::shared_ptr<ImportedMesh> pMesh = parse( _path );
+		if ( !pMesh )
+			return nullptr;
+
+		pMesh->optimize();
+		pMesh->generateLods();
+		pMesh->buildClusters();
+
+		return GeometryAsset::create( pMesh->getVertexCount(), pMesh->getIndexCount(),
+			[pMesh]( std::span<Engine::Vertex> _vertices, std::span<u32> _indices ) { pMesh->write( _vertices, _indices, Utils::JobSystem::Instance() ); },
+			std::vector<GeometryLod>( pMesh->getLods().begin(), pMesh->getLods().end() ),
+			std::vector<GeometryCluster>( pMesh->getClusters().begin(), pMesh->getClusters().end() ), pMesh->getBounds(), pMesh->getFrame(), pMesh->hashContent() );
+	}
+
+	//--------------------------------------------------------------------
+	std::shared_ptr<ImportedMesh> MeshImporter::deduplicate( std::vector<CornerBatch>&& _batches, const Engine::PositionFrame& _frame, Utils::JobSystem& _jobs )
+	{
+		auto pMesh = std::make_shared<ImportedMesh>();
+		pMesh->m_Batches = std::move( _batches );
+		pMesh->m_Frame = _frame;
+
+		// Fixed size work items whatever the batch sizes, one primitive can hold most of a glTF file
+		std::vector<Slice> slices;
+		size_t cornerCount = 0;
+		for ( const CornerBatch& batch : pMesh->m_Batches )
+		{
+			for ( size_t begin = 0; begin < batch.size(); begin += SLICE_SIZE )
+			{
+				const u32 count = static_cast<u32>( std::min<size_t>( SLICE_SIZE, batch.size() - begin ) );
+				slices.push_back( Slice{ .m_pCorners = batch.data() + begin, .m_First = static_cast<u32>( cornerCount ), .m_Count = count } );
+				cornerCount += count;
+
+				if ( cornerCount >= std::numeric_limits<u32>::max() )
+				{
+					std::cerr << "Mesh has too many triangles for 32-bit indices" << std::endl;
+					return nullptr;
+				}
+			}
+		}
+
+		const u32 sliceCount = static_cast<u32>( slices.size() );
+		std::vector<u8> shards( cornerCount );
+		std::vector<std::array<u32, SHARD_COUNT>> shardOffsets( sliceCount );
+
+		// Shard of every corner, and how many each slice sends to each shard
+		_jobs.parallelFor( sliceCount, 1, [&]( u32 _begin, u32 _end ) {
+			for ( u32 s = _begin; s < _end; s++ )
+			{
+				const Slice& slice = slices[s];
+				shardOffsets[s].fill( 0 );
+				for ( u32 i = 0; i < slice.m_Count; i++ )
+				{
+					const u8 shard = ShardOf( MeshOptimizer::hashVertex( slice.m_pCorners[i] ) );
+					shards[slice.m_First + i] = shard;
+					shardOffsets[s][shard]++;
+				}
+			}
+		} );
+
+		// Counts become write offsets, shard by shard then slice by slice so each shard keeps corner order
+		std::array<u32, SHARD_COUNT + 1> shardBegin{};
+		u32 offset = 0;
+		for ( u32 shard = 0; shard < SHARD_COUNT; shard++ )
+		{
+			shardBegin[shard] = offset;
+			for ( u32 s = 0; s < sliceCount; s++ )
+			{
+				offset += std::exchange( shardOffsets[s][shard], offset );
+			}
+		}
+		shardBegin[SHARD_COUNT] = offset;
+
+		std::vector<ShardedCorner> sharded( cornerCount );
+		_jobs.parallelFor( sliceCount, 1, [&]( u32 _begin, u32 _end ) {
+			for ( u32 s = _begin; s < _end; s++ )
+			{
+				const Slice& slice = slices[s];
+				for ( u32 i = 0; i < slice.m_Count; i++ )
+				{
+					const Engine::Vertex& vertex = slice.m_pCorners[i];
+					const u32 corner = slice.m_First + i;
+					sharded[shardOffsets[s][shards[corner]]++] = ShardedCorner{ .m_Vertex = vertex, .m_Corner = corner, .m_Hash = static_cast<u32>( MeshOptimizer::hashVertex( vertex ) ) };
+				}
+			}
+		} );
+
+		// Each shard is deduplicated on its own, in a table small enough to stay in cache.
+		// m_Indices temporarily holds the shard-local vertex index, firsts marks the corner that introduced it.
+		pMesh->m_Indices.resize( cornerCount );
+		std::vector<u8> firsts( cornerCount, 0 );
+		std::vector<std::vector<u32>> shardToGlobal( SHARD_COUNT );
+
+		_jobs.parallelFor( SHARD_COUNT, 1, [&]( u32 _begin, u32 _end ) {
+			for ( u32 shard = _begin; shard < _end; shard++ )
+			{
+				const u32 count = shardBegin[shard + 1] - shardBegin[shard];
+				const u64 mask = std::bit_ceil( std::max<u64>( 16, count + count / 2 ) ) - 1;
+				std::vector<u64> table( mask + 1, EMPTY_SLOT );
+				std::vector<Engine::Vertex> unique;
+
+				for ( u32 k = shardBegin[shard]; k < shardBegin[shard + 1]; k++ )
+				{
+					const ShardedCorner& entry = sharded[k];
+					const u64 tag = u64( entry.m_Hash ) << 32;
+
+					for ( u64 slot = entry.m_Hash & mask;; slot = ( slot + 1 ) & mask )
+					{
+						const u64 value = table[slot];
+						if ( value == EMPTY_SLOT )
+						{
+							const u32 local = static_cast<u32>( unique.size() );
+							table[slot] = tag | local;
+							unique.push_back( entry.m_Vertex );
+							pMesh->m_Indices[entry.m_Corner] = local;
+							firsts[entry.m_Corner] = 1;
+							break;
+						}
+
+						const u32 local = static_cast<u32>( value );
+						if ( ( value >> 32 ) == entry.m_Hash && std::memcmp( &unique[local], &entry.m_Vertex, sizeof( Engine::Vertex ) ) == 0 )
+						{
+							pMesh->m_Indices[entry.m_Corner] = local;
+							break;
+						}
+					}
+				}
+
+				shardToGlobal[shard].resize( unique.size() );
+			}
+		} );
+
+		// Global numbering in order of first use, which keeps the index stream cache friendly
+		std::vector<u32> sliceFirstVertex( sliceCount + 1, 0 );
+		_jobs.parallelFor( sliceCount, 1, [&]( u32 _begin, u32 _end ) {
+			for ( u32 s = _begin; s < _end; s++ )
+			{
+				sliceFirstVertex[s + 1] = static_cast<u32>( std::count( firsts.begin() + slices[s].m_First, firsts.begin() + slices[s].m_First + slices[s].m_Count, u8( 1 ) ) );
+			}
+		} );
+		for ( u32 s = 0; s < sliceCount; s++ )
+		{
+			sliceFirstVertex[s + 1] += sliceFirstVertex[s];
+		}
+
+		pMesh->m_Unique.resize( sliceFirstVertex[sliceCount] );
+		_jobs.parallelFor( sliceCount, 1, [&]( u32 _begin, u32 _end ) {
+			for ( u32 s = _begin; s < _end; s++ )
+			{
+				u32 global = sliceFirstVertex[s];
+				for ( u32 i = 0; i < slices[s].m_Count; i++ )
+				{
+					const u32 corner = slices[s].m_First + i;
+					if ( firsts[corner] )
+					{
+						shardToGlobal[shards[corner]][pMesh->m_Indices[corner]] = global;
+						pMesh->m_Unique[global] = slices[s].m_pCorners + i;
+						global++;
+					}
+				}
+			}
+		} );
+
+		_jobs.parallelFor( sliceCount, 1, [&]( u32 _begin, u32 _end ) {
+			for ( u32 s = _begin; s < _end; s++ )
+			{
+				for ( u32 corner = slices[s].m_First; corner < slices[s].m_First + slices[s].m_Count; corner++ )
+				{
+					pMesh->m_Indices[corner] = shardToGlobal[shards[corner]][pMesh->m_Indices[corner]];
+				}
+			}
+		} );
+
+		return pMesh;
+	}
+
+} // end namespace Scene
@@ -0,0 +1,90 @@
+#pragma once
+
+#include "../../Utils/Common.h"
+#include <filesystem>
+#include <span>
+
+#include "../GeometryAsset.h"
+#include "MeshOptimizer.h"
+#include "../../Utils/JobSystem.h"
+
+namespace Scene {
+
+	// Triangle corners in draw order, one full vertex each, as the format parsers produce them
+	using CornerBatch = std::vector<Engine::Vertex>;
+
+	namespace MeshImport {
+		// Vertices only carry a color: files without one are shaded by their normal, or flat without normals
+		constexpr Maths::Vector3 DEFAULT_COLOR{ 0.8f, 0.8f, 0.8f };
+
+		inline Maths::Vector3 NormalColor( const Maths::Vector3& _normal )
+		{
+			return Maths::Vector3{ .x = _normal.x * 0.5f + 0.5f, .y = _normal.y * 0.5f + 0.5f, .z = _normal.z * 0.5f + 0.5f };
+		}
+	} // end namespace MeshImport
+
+	// Parsed and deduplicated mesh, kept as corners plus an index remap until the destination exists
+	class ImportedMesh
+	{
+	public:
+		u32 getVertexCount() const { return static_cast<u32>( m_Unique.size() ); };
+		// Every level of detail, LOD 0 first
+		u32 getIndexCount() const { return static_cast<u32>( m_Indices.size() ); };
+		// Of the full mesh
+		u32 getTriangleCount() const { return ( m_Lods.empty() ? getIndexCount() : m_Lods[0].m_IndexCount ) / 3; };
+
+		// Stored vertex positions are relative to it, levels, bounds and clusters are in object space
+		const Engine::PositionFrame& getFrame() const { return m_Frame; };
+
+		// Empty until generateLods()
+		std::span<const GeometryLod> getLods() const { return m_Lods; };
+		const GeometryBounds& getBounds() const { return m_Bounds; };
+		// Empty until buildClusters()
+		std::span<const GeometryCluster> getClusters() const { return m_Clusters; };
+
+		// Vertex cache, overdraw and fetch ordering through Scene::MeshOptimizer, duplicates are already merged
+		MeshOptimizeReport optimize();
+
+		// Simplified levels appended after the optimized full mesh, run after optimize()
+		void generateLods();
+
+		// Cluster ranges of every large enough level, run last: it reads the final index order
+		void buildClusters();
+
+		// Spans sized by the counts above, typically mapped upload staging memory
+		void write( std::span<Engine::Vertex> _vertices, std::span<u32> _indices, Utils::JobSystem& _jobs ) const;
+
+		// Of what write() produces, without writing it anywhere. Run last, like buildClusters()
+		GeometryHash hashContent() const;
+
+	private:
+		friend class MeshImporter;
+
+		// Object space
+		std::vector<Maths::Vector3> getPositions() const;
+
+		std::vector<CornerBatch> m_Batches;
+		// First corner of each unique vertex, in order of first use
+		std::vector<const Engine::Vertex*> m_Unique;
+		std::vector<u32> m_Indices;
+		std::vector<GeometryLod> m_Lods;
+		std::vector<GeometryCluster> m_Clusters;
+		GeometryBounds m_Bounds;
+		Engine::PositionFrame m_Frame;
+	};
+
+	// Loads OBJ and glTF 2.0 (.gltf/.glb) files: memory-mapped, parsed in parallel chunks, identical vertices merged.
+	class MeshImporter
+	{
+	public:
+		// nullptr on failure, the reason is printed. Vertices are merged but not reordered yet
+		static std::shared_ptr<ImportedMesh> parse( const std::filesystem::path& _path, Utils::JobSystem& _jobs = Utils::JobSystem::Instance() );
+
+		// Asset without a CPU copy: the upload writes the optimized mesh and its levels of detail straight into staging memory, then frees it
+		static GeometryAssetRef load( const std::filesystem::path& _path );
+
+	private:
+		static std::shared_ptr<ImportedMesh> deduplicate( std::vector<CornerBatch>&& _batches, const Engine::PositionFrame& _frame, Utils::JobSystem& _jobs );
+	};
+
+} // end namespace Scene
@@ -0,0 +1,965 @@
+#include "MeshOptimizer.h"
+
+#include <bit>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+
+#include "../../Maths/LinAlg.h"
+
+namespace Scene {
+
+	namespace {
+		constexpr u32 NO_VERTEX = ~0u;
+
+		// FIFO cache as timestamps: a vertex is resident while fewer than CACHE_SIZE misses happened since its own
+		class CacheSimulator
+		{
+		public:
+			explicit CacheSimulator( u32 _vertexCount ) : m_Stamps( _vertexCount, 0 ) {};
+
+			//--------------------------------------------------------------------
+			bool access( u32 _vertex )
+			{
+				if ( m_Time - m_Stamps[_vertex] <= MeshOptimizer::CACHE_SIZE )
+					return false;
+
+				m_Stamps[_vertex] = m_Time++;
+				return true;
+			}
+
+			//--------------------------------------------------------------------
+			u32 triangleMisses( std::span<const u32> _indices, u32 _triangle )
+			{
+				return u32( access( _indices[_triangle * 3 + 0] ) ) + u32( access( _indices[_triangle * 3 + 1] ) ) + u32( access( _indices[_triangle * 3 + 2] ) );
+			}
+
+			//--------------------------------------------------------------------
+			void flush()
+			{
+				m_Time += MeshOptimizer::CACHE_SIZE + 1;
+			}
+
+			//--------------------------------------------------------------------
+			bool wasUsed( u32 _vertex ) const
+			{
+				return m_Stamps[_vertex] != 0;
+			}
+
+		private:
+			std::vector<u32> m_Stamps;
+			u32 m_Time{ MeshOptimizer::CACHE_SIZE + 1 };
+		};
+
+		//--------------------------------------------------------------------
+		u64 Mix( u64 _h )
+		{
+			_h ^= _h >> 33;
+			_h *= 0xFF51AFD7ED558CCDull;
+			_h ^= _h >> 33;
+			_h *= 0xC4CEB9FE1A85EC53ull;
+			_h ^= _h >> 33;
+			return _h;
+		}
+
+		// Triangles of every vertex, packed
+		struct Adjacency {
+			std::vector<u32> m_Offsets;
+			std::vector<u32> m_Triangles;
+		};
+
+		//--------------------------------------------------------------------
+		Adjacency BuildAdjacency( std::span<const u32> _indices, u32 _vertexCount )
+		{
+			Adjacency adjacency{ .m_Offsets = std::vector<u32>( _vertexCount + 1, 0 ), .m_Triangles = std::vector<u32>( _indices.size() ) };
+			for ( u32 index : _indices )
+			{
+				adjacency.m_Offsets[index + 1]++;
+			}
+			for ( u32 v = 0; v < _vertexCount; v++ )
+			{
+				adjacency.m_Offsets[v + 1] += adjacency.m_Offsets[v];
+			}
+
+			std::vector<u32> cursors( adjacency.m_Offsets.begin(), adjacency.m_Offsets.end() - 1 );
+			for ( size_t i = 0; i < _indices.size(); i++ )
+			{
+				adjacency.m_Triangles[cursors[_indices[i]]++] = static_cast<u32>( i / 3 );
+			}
+
+			return adjacency;
+		}
+
+		// Symmetric 4x4 matrix summing squared distances to planes, each weighted by its triangle's area
+		struct Quadric
+		{
+			f32 m_A00{ 0.0f }, m_A01{ 0.0f }, m_A02{ 0.0f }, m_A11{ 0.0f }, m_A12{ 0.0f }, m_A22{ 0.0f };
+			f32 m_B0{ 0.0f }, m_B1{ 0.0f }, m_B2{ 0.0f };
+			f32 m_C{ 0.0f };
+			f32 m_Weight{ 0.0f };
+
+			//--------------------------------------------------------------------
+			// Plane through _point with unit _normal
+			static Quadric FromPlane( const Maths::Vector3& _normal, const Maths::Vector3& _point, f32 _weight )
+			{
+				const f32 d = -Maths::LinAlg::Dot( _normal, _point );
+				return Quadric{
+					.m_A00 = _normal.x * _normal.x * _weight, .m_A01 = _normal.x * _normal.y * _weight, .m_A02 = _normal.x * _normal.z * _weight,
+					.m_A11 = _normal.y * _normal.y * _weight, .m_A12 = _normal.y * _normal.z * _weight, .m_A22 = _normal.z * _normal.z * _weight,
+					.m_B0 = _normal.x * d * _weight, .m_B1 = _normal.y * d * _weight, .m_B2 = _normal.z * d * _weight,
+					.m_C = d * d * _weight,
+					.m_Weight = _weight
+				};
+			}
+
+			//--------------------------------------------------------------------
+			Quadric operator+( const Quadric& _rhs ) const
+			{
+				return Quadric{
+					.m_A00 = m_A00 + _rhs.m_A00, .m_A01 = m_A01 + _rhs.m_A01, .m_A02 = m_A02 + _rhs.m_A02,
+					.m_A11 = m_A11 + _rhs.m_A11, .m_A12 = m_A12 + _rhs.m_A12, .m_A22 = m_A22 + _rhs.m_A22,
+					.m_B0 = m_B0 + _rhs.m_B0, .m_B1 = m_B1 + _rhs.m_B1, .m_B2 = m_B2 + _rhs.m_B2,
+					.m_C = m_C + _rhs.m_C,
+					.m_Weight = m_Weight + _rhs.m_Weight
+				};
+			}
+
+			//--------------------------------------------------------------------
+			// Area weighted mean squared distance of _p to the planes
+			f32 evaluate( const Maths::Vector3& _p ) const
+			{
+				const f32 rx = m_A00 * _p.x + m_A01 * _p.y + m_A02 * _p.z + 2.0f * m_B0;
+				const f32 ry = m_A01 * _p.x + m_A11 * _p.y + m_A12 * _p.z + 2.0f * m_B1;
+				const f32 rz = m_A02 * _p.x + m_A12 * _p.y + m_A22 * _p.z + 2.0f * m_B2;
+				const f32 sum = rx * _p.x + ry * _p.y + rz * _p.z + m_C;
+
+				return m_Weight > 0.0f ? std::abs( sum ) / m_Weight : 0.0f;
+			}
+		};
+
+		//--------------------------------------------------------------------
+		// First vertex at each distinct position, vertices split by attributes share it
+		std::vector<u32> WeldPositions( std::span<const Maths::Vector3> _positions )
+		{
+			const size_t tableSize = std::bit_ceil( std::max<size_t>( 16, _positions.size() + _positions.size() / 2 ) );
+			std::vector<u32> table( tableSize, NO_VERTEX );
+
+			std::vector<u32> welded( _positions.size() );
+			for ( size_t v = 0; v < _positions.size(); v++ )
+			{
+				const Maths::Vector3& position = _positions[v];
+				size_t slot = Mix( u64( std::bit_cast<u32>( position.x ) ) ^ ( u64( std::bit_cast<u32>( position.y ) ) << 21 ) ^ ( u64( std::bit_cast<u32>( position.z ) ) << 42 ) ) & ( tableSize - 1 );
+				while ( table[slot] != NO_VERTEX && std::memcmp( &_positions[table[slot]], &position, sizeof( Maths::Vector3 ) ) != 0 )
+				{
+					slot = ( slot + 1 ) & ( tableSize - 1 );
+				}
+
+				if ( table[slot] == NO_VERTEX )
+				{
+					table[slot] = static_cast<u32>( v );
+				}
+				welded[v] = table[slot];
+			}
+
+			return welded;
+		}
+
+		//--------------------------------------------------------------------
+		// Vertices that may not move: on an attribute seam, or on an edge used by one triangle only (open or non-manifold)
+		std::vector<u8> LockVertices( std::span<const u32> _indices, std::span<const u32> _welded )
+		{
+			const u32 vertexCount = static_cast<u32>( _welded.size() );
+			std::vector<u8> locked( vertexCount, 0 );
+			for ( u32 v = 0; v < vertexCount; v++ )
+			{
+				if ( _welded[v] != v )
+				{
+					locked[v] = 1;
+					locked[_welded[v]] = 1;
+				}
+			}
+
+			std::vector<u32> weldedIndices( _indices.size() );
+			std::ranges::transform( _indices, weldedIndices.begin(), [_welded]( u32 _index ) { return _welded[_index]; } );
+			const Adjacency adjacency = BuildAdjacency( weldedIndices, vertexCount );
+
+			// Around an interior vertex every neighbor is shared by exactly two triangles
+			std::vector<u32> ring;
+			for ( u32 v = 0; v < vertexCount; v++ )
+			{
+				ring.clear();
+				for ( u32 a = adjacency.m_Offsets[v]; a < adjacency.m_Offsets[v + 1]; a++ )
+				{
+					const u32* pCorners = &weldedIndices[adjacency.m_Triangles[a] * 3];
+					for ( u32 corner = 0; corner < 3; corner++ )
+					{
+						if ( pCorners[corner] != v )
+						{
+							ring.push_back( pCorners[corner] );
+						}
+					}
+				}
+
+				std::ranges::sort( ring );
+				for ( size_t begin = 0, end = 0; begin < ring.size() && !locked[v]; begin = end )
+				{
+					for ( end = begin; end < ring.size() && ring[end] == ring[begin]; end++ ) {}
+					locked[v] = end - begin != 2;
+				}
+			}
+
+			return locked;
+		}
+
+		//--------------------------------------------------------------------
+		// _indices are the cluster's own, starting at _firstIndex of the index buffer. Sphere around the box of their vertices, cone around the average triangle normal
+		GeometryCluster MakeCluster( std::span<const u32> _indices, u32 _firstIndex, std::span<const Maths::Vector3> _positions )
+		{
+			Maths::Vector3 min = _positions[_indices[0]];
+			Maths::Vector3 max = min;
+			for ( u32 index : _indices )
+			{
+				const Maths::Vector3& position = _positions[index];
+				min = Maths::Vector3{ .x = std::min( min.x, position.x ), .y = std::min( min.y, position.y ), .z = std::min( min.z, position.z ) };
+				max = Maths::Vector3{ .x = std::max( max.x, position.x ), .y = std::max( max.y, position.y ), .z = std::max( max.z, position.z ) };
+			}
+
+			const Maths::Vector3 center{ .x = ( min.x + max.x ) * 0.5f, .y = ( min.y + max.y ) * 0.5f, .z = ( min.z + max.z ) * 0.5f };
+			f32 radius = 0.0f;
+			for ( u32 index : _indices )
+			{
+				radius = std::max( radius, ( _positions[index] - center ).Length() );
+			}
+
+			std::vector<Maths::Vector3> normals;
+			normals.reserve( _indices.size() / 3 );
+			Maths::Vector3 axis{};
+			for ( size_t i = 0; i < _indices.size(); i += 3 )
+			{
+				const Maths::Vector3& a = _positions[_indices[i + 0]];
+				Maths::Vector3 normal = Maths::LinAlg::Cross( _positions[_indices[i + 1]] - a, _positions[_indices[i + 2]] - a );
+
+				// Zero area triangles never rasterize, they don't constrain the cone
+				if ( normal.Length() == 0.0f )
+					continue;
+
+				normal.Normalize();
+				normals.push_back( normal );
+				axis = axis + normal;
+			}
+
+			GeometryCluster cluster{ .m_FirstIndex = _firstIndex, .m_IndexCount = static_cast<u32>( _indices.size() ), .m_Center = center, .m_Radius = radius };
+
+			const f32 axisLength = axis.Length();
+			if ( normals.empty() || axisLength < 1e-6f )
+				return cluster;
+
+			axis.Normalize();
+			f32 minDot = 1.0f;
+			for ( const Maths::Vector3& normal : normals )
+			{
+				minDot = std::min( minDot, Maths::LinAlg::Dot( normal, axis ) );
+			}
+
+			// Past ~85 degrees the cone test almost never passes, skip it on the GPU
+			if ( minDot > 0.1f )
+			{
+				cluster.m_ConeAxis = axis;
+				cluster.m_ConeCutoff = std::sqrt( 1.0f - minDot * minDot );
+			}
+
+			return cluster;
+		}
+	} // end anonymous namespace
+
+	//--------------------------------------------------------------------
+	u64 MeshOptimizer::hashVertex( const Engine::Vertex& _vertex )
+	{
+		// Padding bytes would make equal vertices hash and compare differently
+		static_assert( std::has_unique_object_representations_v<Engine::Vertex>, "Vertex must not contain padding" );
+
+		// Whole words, the last one zero padded
+		u64 words[( sizeof( Engine::Vertex ) + sizeof( u64 ) - 1 ) / sizeof( u64 )]{};
+		std::memcpy( words, &_vertex, sizeof( Engine::Vertex ) );
+
+		u64 hash = 0;
+		for ( u64 word : words )
+		{
+			hash = Mix( hash ^ word );
+		}
+		return hash;
+	}
+
+	//--------------------------------------------------------------------
+	VertexCacheStats MeshOptimizer::analyzeVertexCache( std::span<const u32> _indices, u32 _vertexCount )
+	{
+		if ( _indices.empty() )
+			return VertexCacheStats{};
+
+		CacheSimulator cache( _vertexCount );
+		u64 misses = 0;
+		for ( u32 index : _indices )
+		{
+			misses += cache.access( index );
+		}
+
+		u32 usedCount = 0;
+		for ( u32 v = 0; v < _vertexCount; v++ )
+		{
+			usedCount += cache.wasUsed( v );
+		}
+
+		return VertexCacheStats{ .m_Acmr = f32( f64( misses ) / f64( _indices.size() / 3 ) ), .m_Atvr = f32( f64( misses ) / f64( usedCount ) ) };
+	}
+
+	//--------------------------------------------------------------------
+	void MeshOptimizer::remapDuplicates( std::vector<Engine::Vertex>& _vertices, std::vector<u32>& _indices )
+	{
+		// Open addressing over indices into unique, a load factor of at most 2/3
+		const size_t tableSize = std::bit_ceil( std::max<size_t>( 16, _vertices.size() + _vertices.size() / 2 ) );
+		std::vector<u32> table( tableSize, NO_VERTEX );
+
+		std::vector<Engine::Vertex> unique;
+		std::vector<u32> remap( _vertices.size() );
+		for ( size_t v = 0; v < _vertices.size(); v++ )
+		{
+			const Engine::Vertex& vertex = _vertices[v];
+			size_t slot = hashVertex( vertex ) & ( tableSize - 1 );
+			while ( table[slot] != NO_VERTEX && std::memcmp( &unique[table[slot]], &vertex, sizeof( Engine::Vertex ) ) != 0 )
+			{
+				slot = ( slot + 1 ) & ( tableSize - 1 );
+			}
+
+			if ( table[slot] == NO_VERTEX )
+			{
+				table[slot] = static_cast<u32>( unique.size() );
+				unique.push_back( vertex );
+			}
+			remap[v] = table[slot];
+		}
+
+		for ( u32& index : _indices )
+		{
+			index = remap[index];
+		}
+
+		_vertices = std::move( unique );
+	}
+
+	//--------------------------------------------------------------------
+	void MeshOptimizer::optimizeVertexCache( std::span<u32> _indices, u32 _vertexCount )
+	{
+		const Adjacency adjacency = BuildAdjacency( _indices, _vertexCount );
+
+		// Triangles not emitted yet around each vertex
+		std::vector<u32> live( _vertexCount );
+		for ( u32 v = 0; v < _vertexCount; v++ )
+		{
+			live[v] = adjacency.m_Offsets[v + 1] - adjacency.m_Offsets[v];
+		}
+
+		std::vector<u32> stamps( _vertexCount, 0 );
+		u32 time = CACHE_SIZE + 1;
+		std::vector<u8> emitted( _indices.size() / 3, 0 );
+		std::vector<u32> deadEnds;
+		std::vector<u32> candidates;
+		std::vector<u32> output;
+		output.reserve( _indices.size() );
+		u32 inputCursor = 0;
+
+		// Recently touched vertices first, then the first live vertex in input order
+		auto skipDeadEnd = [&]() {
+			while ( !deadEnds.empty() )
+			{
+				const u32 vertex = deadEnds.back();
+				deadEnds.pop_back();
+				if ( live[vertex] > 0 )
+					return vertex;
+			}
+
+			while ( inputCursor < _vertexCount )
+			{
+				if ( live[inputCursor] > 0 )
+					return inputCursor;
+				inputCursor++;
+			}
+
+			return NO_VERTEX;
+		};
+
+		u32 fan = skipDeadEnd();
+		while ( fan != NO_VERTEX )
+		{
+			candidates.clear();
+			for ( u32 a = adjacency.m_Offsets[fan]; a < adjacency.m_Offsets[fan + 1]; a++ )
+			{
+				const u32 triangle = adjacency.m_Triangles[a];
+				if ( emitted[triangle] )
+					continue;
+
+				for ( u32 corner = 0; corner < 3; corner++ )
+				{
+					const u32 vertex = _indices[triangle * 3 + corner];
+					output.push_back( vertex );
+					deadEnds.push_back( vertex );
+					candidates.push_back( vertex );
+					live[vertex]--;
+					if ( time - stamps[vertex] > CACHE_SIZE )
+					{
+						stamps[vertex] = time++;
+					}
+				}
+				emitted[triangle] = 1;
+			}
+
+			// Oldest candidate that will still be resident once its own remaining fan is emitted
+			fan = NO_VERTEX;
+			i64 bestPriority = -1;
+			for ( u32 vertex : candidates )
+			{
+				if ( live[vertex] == 0 )
+					continue;
+
+				i64 priority = 0;
+				if ( time - stamps[vertex] + 2 * live[vertex] <= CACHE_SIZE )
+				{
+					priority = time - stamps[vertex];
+				}
+
+				if ( priority > bestPriority )
+				{
+					bestPriority = priority;
+					fan = vertex;
+				}
+			}
+
+			if ( fan == NO_VERTEX )
+			{
+				fan = skipDeadEnd();
+			}
+		}
+
+		std::ranges::copy( output, _indices.begin() );
+	}
+
+	//--------------------------------------------------------------------
+	void MeshOptimizer::optimizeOverdraw( std::span<u32> _indices, std::span<const Maths::Vector3> _positions )
+	{
+		const u32 triangleCount = static_cast<u32>( _indices.size() / 3 );
+		if ( triangleCount == 0 )
+			return;
+
+		const u32 vertexCount = static_cast<u32>( _positions.size() );
+
+		// Hard boundaries: the cache was flushed, moving the cluster cannot cost any reuse.
+		// The first triangle always opens one, it can be degenerate and miss less than three times
+		std::vector<u32> hardClusters;
+		CacheSimulator cache( vertexCount );
+		for ( u32 t = 0; t < triangleCount; t++ )
+		{
+			if ( cache.triangleMisses( _indices, t ) == 3 || t == 0 )
+			{
+				hardClusters.push_back( t );
+			}
+		}
+		hardClusters.push_back( triangleCount );
+
+		// Soft boundaries: split further wherever the cluster's ACMR so far is already within the threshold
+		std::vector<u32> clusters;
+		for ( size_t c = 0; c + 1 < hardClusters.size(); c++ )
+		{
+			const u32 begin = hardClusters[c];
+			const u32 end = hardClusters[c + 1];
+
+			cache.flush();
+			u32 clusterMisses = 0;
+			for ( u32 t = begin; t < end; t++ )
+			{
+				clusterMisses += cache.triangleMisses( _indices, t );
+			}
+			const f32 threshold = OVERDRAW_THRESHOLD * f32( clusterMisses ) / f32( end - begin );
+
+			cache.flush();
+			clusters.push_back( begin );
+			u32 runningMisses = 0;
+			u32 runningTriangles = 0;
+			for ( u32 t = begin; t + 1 < end; t++ )
+			{
+				runningMisses += cache.triangleMisses( _indices, t );
+				runningTriangles++;
+				if ( f32( runningMisses ) <= threshold * f32( runningTriangles ) )
+				{
+					clusters.push_back( t + 1 );
+					cache.flush();
+					runningMisses = 0;
+					runningTriangles = 0;
+				}
+			}
+		}
+		clusters.push_back( triangleCount );
+
+		auto trianglePositions = [&]( u32 _triangle ) {
+			return std::array<Maths::Vector3, 3>{ _positions[_indices[_triangle * 3 + 0]], _positions[_indices[_triangle * 3 + 1]], _positions[_indices[_triangle * 3 + 2]] };
+		};
+
+		Maths::Vector3 meshCentroid;
+		for ( u32 index : _indices )
+		{
+			meshCentroid = meshCentroid + _positions[index];
+		}
+		const f32 cornerScale = 1.0f / f32( _indices.size() );
+		meshCentroid = Maths::Vector3{ .x = meshCentroid.x * cornerScale, .y = meshCentroid.y * cornerScale, .z = meshCentroid.z * cornerScale };
+
+		// Clusters far out along their own facing direction occlude the rest from most view points, they go first
+		const u32 clusterCount = static_cast<u32>( clusters.size() - 1 );
+		std::vector<f32> sortKeys( clusterCount );
+		for ( u32 c = 0; c < clusterCount; c++ )
+		{
+			Maths::Vector3 centroid;
+			Maths::Vector3 normal;
+			f32 area = 0.0f;
+			for ( u32 t = clusters[c]; t < clusters[c + 1]; t++ )
+			{
+				const auto p = trianglePositions( t );
+				// Twice the area, the scale cancels out below
+				const Maths::Vector3 weightedNormal = Maths::LinAlg::Cross( p[1] - p[0], p[2] - p[0] );
+				const f32 weight = weightedNormal.Length();
+				const Maths::Vector3 center = p[0] + p[1] + p[2];
+
+				centroid = centroid + Maths::Vector3{ .x = center.x * weight, .y = center.y * weight, .z = center.z * weight };
+				normal = normal + weightedNormal;
+				area += weight;
+			}
+
+			const f32 centroidScale = area > 0.0f ? 1.0f / ( 3.0f * area ) : 0.0f;
+			centroid = Maths::Vector3{ .x = centroid.x * centroidScale, .y = centroid.y * centroidScale, .z = centroid.z * centroidScale };
+			sortKeys[c] = Maths::LinAlg::Dot( centroid - meshCentroid, normal.Normalize() );
+		}
+
+		std::vector<u32> order( clusterCount );
+		for ( u32 c = 0; c < clusterCount; c++ )
+		{
+			order[c] = c;
+		}
+		std::ranges::stable_sort( order, [&sortKeys]( u32 _a, u32 _b ) { return sortKeys[_a] > sortKeys[_b]; } );
+
+		std::vector<u32> output;
+		output.reserve( _indices.size() );
+		for ( u32 c : order )
+		{
+			output.insert( output.end(), _indices.begin() + clusters[c] * 3, _indices.begin() + clusters[c + 1] * 3 );
+		}
+
+		std::ranges::copy( output, _indices.begin() );
+	}
+
+	//--------------------------------------------------------------------
+	u32 MeshOptimizer::optimizeVertexFetch( std::span<u32> _indices, u32 _vertexCount, std::vector<u32>& _remap )
+	{
+		_remap.assign( _vertexCount, NO_VERTEX );
+
+		u32 nextVertex = 0;
+		for ( u32& index : _indices )
+		{
+			if ( _remap[index] == NO_VERTEX )
+			{
+				_remap[index] = nextVertex++;
+			}
+			index = _remap[index];
+		}
+
+		return nextVertex;
+	}
+
+	//--------------------------------------------------------------------
+	MeshOptimizeReport MeshOptimizer::optimize( std::vector<Engine::Vertex>& _vertices, std::vector<u32>& _indices )
+	{
+		MeshOptimizeReport report;
+		report.m_Before = analyzeVertexCache( _indices, static_cast<u32>( _vertices.size() ) );
+
+		remapDuplicates( _vertices, _indices );
+		optimizeVertexCache( _indices, static_cast<u32>( _vertices.size() ) );
+
+		std::vector<Maths::Vector3> positions( _vertices.size() );
+		std::ranges::transform( _vertices, positions.begin(), []( const Engine::Vertex& _vertex ) { return _vertex.getPosition(); } );
+		optimizeOverdraw( _indices, positions );
+
+		std::vector<u32> remap;
+		std::vector<Engine::Vertex> fetchOrdered( optimizeVertexFetch( _indices, static_cast<u32>( _vertices.size() ), remap ) );
+		for ( size_t v = 0; v < _vertices.size(); v++ )
+		{
+			if ( remap[v] != NO_VERTEX )
+			{
+				fetchOrdered[remap[v]] = _vertices[v];
+			}
+		}
+		_vertices = std::move( fetchOrdered );
+
+		report.m_After = analyzeVertexCache( _indices, static_cast<u32>( _vertices.size() ) );
+		return report;
+	}
+
+	//--------------------------------------------------------------------
+	std::vector<u32> MeshOptimizer::simplify( std::span<const u32> _indices, std::span<const Maths::Vector3> _positions, u32 _targetIndexCount, f32& _error )
+	{
+		_error = 0.0f;
+		std::vector<u32> result( _indices.begin(), _indices.end() );
+		if ( result.size() <= _targetIndexCount || _positions.empty() )
+			return result;
+
+		const u32 vertexCount = static_cast<u32>( _positions.size() );
+
+		// Scaled into a unit cube so the quadrics keep their precision in f32 whatever the mesh units
+		Maths::Vector3 min = _positions[0];
+		Maths::Vector3 max = min;
+		for ( const Maths::Vector3& position : _positions )
+		{
+			min = Maths::Vector3{ .x = std::min( min.x, position.x ), .y = std::min( min.y, position.y ), .z = std::min( min.z, position.z ) };
+			max = Maths::Vector3{ .x = std::max( max.x, position.x ), .y = std::max( max.y, position.y ), .z = std::max( max.z, position.z ) };
+		}
+		const f32 extent = std::max( { max.x - min.x, max.y - min.y, max.z - min.z } );
+		const f32 scale = extent > 0.0f ? 1.0f / extent : 1.0f;
+
+		std::vector<Maths::Vector3> points( vertexCount );
+		std::ranges::transform( _positions, points.begin(), [&min, scale]( const Maths::Vector3& _position ) {
+			return Maths::Vector3{ .x = ( _position.x - min.x ) * scale, .y = ( _position.y - min.y ) * scale, .z = ( _position.z - min.z ) * scale };
+		} );
+
+		const std::vector<u8> locked = LockVertices( _indices, WeldPositions( _positions ) );
+
+		// Kept for the whole simplification, a collapsed vertex hands its planes to the survivor
+		std::vector<Quadric> quadrics( vertexCount );
+		for ( size_t i = 0; i < result.size(); i += 3 )
+		{
+			Maths::Vector3 normal = Maths::LinAlg::Cross( points[result[i + 1]] - points[result[i]], points[result[i + 2]] - points[result[i]] );
+			const f32 doubleArea = normal.Length();
+			if ( doubleArea == 0.0f )
+				continue;
+
+			const Quadric quadric = Quadric::FromPlane( normal.Normalize(), points[result[i]], doubleArea * 0.5f );
+			for ( u32 corner = 0; corner < 3; corner++ )
+			{
+				quadrics[result[i + corner]] = quadrics[result[i + corner]] + quadric;
+			}
+		}
+
+		// Per pass: a vertex next to a collapsed one may still be a target but no longer moves, a collapsed vertex is neither
+		enum CollapseState : u8 { FREE, PINNED, COLLAPSED };
+
+		std::vector<u32> remap( vertexCount );
+		std::vector<u32> collapseTarget( vertexCount );
+		std::vector<f32> collapseCost( vertexCount );
+		std::vector<u8> states( vertexCount );
+		// Cost bits above the vertex: non-negative floats order like their bits, so this sorts by cost
+		std::vector<u64> candidates;
+		f32 maxCost = 0.0f;
+
+		// Passes of collapses that never move a corner of another collapse's triangles, so each check sees the final neighborhood
+		while ( result.size() > _targetIndexCount )
+		{
+			const u32 triangleCount = static_cast<u32>( result.size() / 3 );
+			const Adjacency adjacency = BuildAdjacency( result, vertexCount );
+
+			// Cheapest edge of every vertex that may move
+			std::ranges::fill( collapseCost, std::numeric_limits<f32>::max() );
+			for ( u32 t = 0; t < triangleCount; t++ )
+			{
+				for ( u32 corner = 0; corner < 3; corner++ )
+				{
+					const u32 from = result[t * 3 + corner];
+					const u32 to = result[t * 3 + ( corner + 1 ) % 3];
+					if ( locked[from] || from == to )
+						continue;
+
+					const f32 cost = ( quadrics[from] + quadrics[to] ).evaluate( points[to] );
+					if ( cost < collapseCost[from] )
+					{
+						collapseCost[from] = cost;
+						collapseTarget[from] = to;
+					}
+				}
+			}
+
+			candidates.clear();
+			for ( u32 v = 0; v < vertexCount; v++ )
+			{
+				if ( collapseCost[v] != std::numeric_limits<f32>::max() )
+				{
+					candidates.push_back( ( u64( std::bit_cast<u32>( collapseCost[v] ) ) << 32 ) | v );
+				}
+			}
+			std::ranges::sort( candidates );
+			// The costlier half waits for the next pass, where the cheap collapses have updated the quadrics
+			candidates.resize( std::max<size_t>( candidates.size() / 2, std::min<size_t>( candidates.size(), 1 ) ) );
+
+			for ( u32 v = 0; v < vertexCount; v++ )
+			{
+				remap[v] = v;
+			}
+			std::ranges::fill( states, FREE );
+
+			const u32 removableTriangles = triangleCount - _targetIndexCount / 3;
+			u32 removedTriangles = 0;
+			for ( u64 candidate : candidates )
+			{
+				if ( removedTriangles >= removableTriangles )
+					break;
+
+				const u32 from = static_cast<u32>( candidate );
+				const u32 to = collapseTarget[from];
+				if ( states[from] != FREE || states[to] == COLLAPSED )
+					continue;
+
+				// Triangles around the edge vanish, the others must not flip or fold over
+				bool valid = true;
+				u32 vanishing = 0;
+				for ( u32 a = adjacency.m_Offsets[from]; a < adjacency.m_Offsets[from + 1] && valid; a++ )
+				{
+					const u32* pCorners = &result[adjacency.m_Triangles[a] * 3];
+					if ( pCorners[0] == to || pCorners[1] == to || pCorners[2] == to )
+					{
+						vanishing++;
+						continue;
+					}
+
+					auto moved = [&]( u32 _vertex ) { return _vertex == from ? points[to] : points[_vertex]; };
+					const Maths::Vector3 before = Maths::LinAlg::Cross( points[pCorners[1]] - points[pCorners[0]], points[pCorners[2]] - points[pCorners[0]] );
+					const Maths::Vector3 after = Maths::LinAlg::Cross( moved( pCorners[1] ) - moved( pCorners[0] ), moved( pCorners[2] ) - moved( pCorners[0] ) );
+					valid = Maths::LinAlg::Dot( before, after ) > 0.25f * before.Length() * after.Length();
+				}
+
+				if ( !valid || vanishing == 0 )
+					continue;
+
+				remap[from] = to;
+				quadrics[to] = quadrics[to] + quadrics[from];
+				maxCost = std::max( maxCost, collapseCost[from] );
+				removedTriangles += vanishing;
+
+				for ( u32 a = adjacency.m_Offsets[from]; a < adjacency.m_Offsets[from + 1]; a++ )
+				{
+					for ( u32 corner = 0; corner < 3; corner++ )
+					{
+						u8& state = states[result[adjacency.m_Triangles[a] * 3 + corner]];
+						state = std::max<u8>( state, PINNED );
+					}
+				}
+				states[from] = COLLAPSED;
+			}
+
+			if ( removedTriangles == 0 )
+				break;
+
+			size_t write = 0;
+			for ( size_t i = 0; i < result.size(); i += 3 )
+			{
+				const u32 a = remap[result[i]];
+				const u32 b = remap[result[i + 1]];
+				const u32 c = remap[result[i + 2]];
+				if ( a == b || b == c || a == c )
+					continue;
+
+				result[write++] = a;
+				result[write++] = b;
+				result[write++] = c;
+			}
+			result.resize( write );
+		}
+
+		_error = std::sqrt( maxCost ) * extent;
+		return result;
+	}
+
+	//--------------------------------------------------------------------
+	std::vector<GeometryLod> MeshOptimizer::generateLods( std::vector<u32>& _indices, std::span<const Maths::Vector3> _positions )
+	{
+		std::vector<GeometryLod> lods{ GeometryLod{ .m_FirstIndex = 0, .m_IndexCount = static_cast<u32>( _indices.size() ), .m_Error = 0.0f } };
+		std::vector<u32> previous( _indices );
+
+		while ( lods.size() < MAX_LODS )
+		{
+			const u32 targetTriangles = static_cast<u32>( f32( previous.size() / 3 ) * LOD_REDUCTION );
+			if ( targetTriangles < MIN_LOD_TRIANGLES )
+				break;
+
+			f32 stepError = 0.0f;
+			std::vector<u32> lod = simplify( previous, _positions, targetTriangles * 3, stepError );
+
+			// Mostly borders and seams left, another level would cost memory without saving triangles
+			if ( f32( lod.size() ) > f32( previous.size() ) * ( 1.0f + LOD_REDUCTION ) * 0.5f )
+				break;
+
+			optimizeVertexCache( lod, static_cast<u32>( _positions.size() ) );
+
+			// Each level is measured against the previous one, their sum bounds the distance to LOD 0
+			lods.push_back( GeometryLod{ .m_FirstIndex = static_cast<u32>( _indices.size() ), .m_IndexCount = static_cast<u32>( lod.size() ),
+				.m_Error = lods.back().m_Error + stepError } );
+			_indices.insert( _indices.end(), lod.begin(), lod.end() );
+			previous = std::move( lod );
+		}
+
+		return lods;
+	}
+
+	//--------------------------------------------------------------------
+	std::vector<GeometryCluster> MeshOptimizer::buildClusters( std::span<u32> _indices, std::span<const Maths::Vector3> _positions, std::span<GeometryLod> _lods )
+	{
+		const u32 vertexCount = static_cast<u32>( _positions.size() );
+
+		std::vector<GeometryCluster> clusters;
+		// Id of the cluster that last took each vertex, the open cluster's id is clusters.size()
+		std::vector<u32> owners( vertexCount, NO_VERTEX );
+
+		for ( GeometryLod& lod : _lods )
+		{
+			lod.m_FirstCluster = static_cast<u32>( clusters.size() );
+			lod.m_ClusterCount = 0;
+
+			if ( lod.m_IndexCount / 3 < MIN_CLUSTERED_TRIANGLES )
+				continue;
+
+			const std::span<u32> indices = _indices.subspan( lod.m_FirstIndex, lod.m_IndexCount );
+			const u32 triangleCount = lod.m_IndexCount / 3;
+			const Adjacency adjacency = BuildAdjacency( indices, vertexCount );
+
+			std::vector<Maths::Vector3> centroids( triangleCount );
+			for ( u32 t = 0; t < triangleCount; t++ )
+			{
+				const Maths::Vector3 sum = _positions[indices[t * 3 + 0]] + _positions[indices[t * 3 + 1]] + _positions[indices[t * 3 + 2]];
+				centroids[t] = Maths::Vector3{ .x = sum.x / 3.0f, .y = sum.y / 3.0f, .z = sum.z / 3.0f };
+			}
+
+			std::vector<bool> used( triangleCount, false );
+			// Free triangles around each vertex
+			std::vector<u32> liveCounts( vertexCount, 0 );
+			for ( u32 v = 0; v < vertexCount; v++ )
+			{
+				liveCounts[v] = adjacency.m_Offsets[v + 1] - adjacency.m_Offsets[v];
+			}
+			// Cluster id a triangle was last queued as a candidate for, avoids duplicates in the list
+			std::vector<u32> queuedFor( triangleCount, NO_VERTEX );
+			// Free triangles touching the open cluster
+			std::vector<u32> candidates;
+			std::vector<u32> ordered;
+			ordered.reserve( indices.size() );
+			u32 cursor = 0;
+
+			while ( ordered.size() < indices.size() )
+			{
+				const u32 open = static_cast<u32>( clusters.size() );
+
+				// A free triangle next to the previous cluster keeps neighbours together, else the next free one in stream order
+				u32 seed = NO_VERTEX;
+				for ( u32 candidate : candidates )
+				{
+					if ( !used[candidate] )
+					{
+						seed = candidate;
+						break;
+					}
+				}
+				if ( seed == NO_VERTEX )
+				{
+					while ( used[cursor] )
+					{
+						cursor++;
+					}
+					seed = cursor;
+				}
+				candidates.clear();
+
+				const u32 first = static_cast<u32>( ordered.size() );
+				u32 clusterVertices = 0;
+				u32 clusterTriangles = 0;
+				Maths::Vector3 centroidSum{};
+
+				auto add = [&]( u32 _triangle ) {
+					used[_triangle] = true;
+					clusterTriangles++;
+					liveCounts[indices[_triangle * 3 + 0]]--;
+					liveCounts[indices[_triangle * 3 + 1]]--;
+					liveCounts[indices[_triangle * 3 + 2]]--;
+					centroidSum = centroidSum + centroids[_triangle];
+
+					for ( u32 k = 0; k < 3; k++ )
+					{
+						const u32 vertex = indices[_triangle * 3 + k];
+						ordered.push_back( vertex );
+
+						if ( owners[vertex] == open )
+							continue;
+
+						owners[vertex] = open;
+						clusterVertices++;
+
+						for ( u32 a = adjacency.m_Offsets[vertex]; a < adjacency.m_Offsets[vertex + 1]; a++ )
+						{
+							const u32 neighbor = adjacency.m_Triangles[a];
+							if ( !used[neighbor] && queuedFor[neighbor] != open )
+							{
+								queuedFor[neighbor] = open;
+								candidates.push_back( neighbor );
+							}
+						}
+					}
+				};
+
+				add( seed );
+
+				// Greedy growth: fewest new vertices first, so clusters fill their vertex budget, then closest to the cluster so they stay round
+				while ( clusterTriangles < CLUSTER_MAX_TRIANGLES )
+				{
+					const f32 scale = 1.0f / f32( clusterTriangles );
+					const Maths::Vector3 center{ .x = centroidSum.x * scale, .y = centroidSum.y * scale, .z = centroidSum.z * scale };
+
+					u32 best = NO_VERTEX;
+					u32 bestNew = 4;
+					u32 bestLive = NO_VERTEX;
+					f32 bestDistance = std::numeric_limits<f32>::max();
+					size_t kept = 0;
+
+					for ( u32 candidate : candidates )
+					{
+						if ( used[candidate] )
+							continue;
+
+						candidates[kept++] = candidate;
+
+						const u32 newVertices = u32( owners[indices[candidate * 3 + 0]] != open ) + u32( owners[indices[candidate * 3 + 1]] != open )
+							+ u32( owners[indices[candidate * 3 + 2]] != open );
+						if ( clusterVertices + newVertices > CLUSTER_MAX_VERTICES )
+							continue;
+
+						// A vertex with few free triangles left is closed off now rather than left as a fragment for a later cluster
+						const u32 live = std::min( { liveCounts[indices[candidate * 3 + 0]], liveCounts[indices[candidate * 3 + 1]], liveCounts[indices[candidate * 3 + 2]], 2u } );
+						const Maths::Vector3 offset = centroids[candidate] - center;
+						const f32 distance = Maths::LinAlg::Dot( offset, offset );
+						if ( newVertices < bestNew || ( newVertices == bestNew && ( live < bestLive || ( live == bestLive && distance < bestDistance ) ) ) )
+						{
+							best = candidate;
+							bestNew = newVertices;
+							bestLive = live;
+							bestDistance = distance;
+						}
+					}
+					candidates.resize( kept );
+
+					if ( best == NO_VERTEX )
+						break;
+
+					add( best );
+				}
+
+				clusters.push_back( MakeCluster( std::span<const u32>( ordered ).subspan( first ), lod.m_FirstIndex + first, _positions ) );
+			}
+
+			// Clusters become consecutive ranges, each keeps the locality of its greedy growth
+			std::ranges::copy( ordered, indices.begin() );
+			lod.m_ClusterCount = static_cast<u32>( clusters.size() ) - lod.m_FirstCluster;
+		}
+
+		return clusters;
+	}
+
+} // end namespace Scene
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "../../Utils/Common.h"
+#include <span>
+
+#include "../GeometryAsset.h"
+#include "../../Engine/VulkanTypes.h"
+#include "../../Maths/Vector3.h"
+
+namespace Scene {
+
+	// Post-transform vertex cache quality of an index stream, simulated as a FIFO of MeshOptimizer::CACHE_SIZE entries
+	struct VertexCacheStats
+	{
+		// Transformed vertices per triangle: 3 without any reuse, 0.5 is the best a regular grid can reach
+		f32 m_Acmr{ 0.0f };
+		// Transformed vertices per vertex: 1 means every vertex is shaded exactly once
+		f32 m_Atvr{ 0.0f };
+	};
+
+	struct MeshOptimizeReport
+	{
+		VertexCacheStats m_Before;
+		VertexCacheStats m_After;
+	};
+
+	// Reorders triangles and vertices so large meshes shade fewer vertices, overdraw less and fetch linearly.
+	// Every step keeps the rendered result identical, only the order (and duplicate vertices) change.
+	class MeshOptimizer
+	{
+	public:
+		// Conservative for current GPUs, their batching keeps a FIFO of at least this many shaded vertices
+		static constexpr u32 CACHE_SIZE = 16;
+		// Overdraw ordering may give up this much ACMR for finer clusters
+		static constexpr f32 OVERDRAW_THRESHOLD = 1.05f;
+
+		// Levels generated per mesh, LOD 0 included
+		static constexpr u32 MAX_LODS = 5;
+		// Triangle count of each level relative to the previous one
+		static constexpr f32 LOD_REDUCTION = 0.5f;
+		// Meshes this small are cheaper to draw than to switch
+		static constexpr u32 MIN_LOD_TRIANGLES = 64;
+
+		// Within the mesh shader output limits of every vendor, the same clusters could feed a task/mesh pipeline
+		static constexpr u32 CLUSTER_MAX_VERTICES = 64;
+		static constexpr u32 CLUSTER_MAX_TRIANGLES = 124;
+		// Smaller levels are drawn whole, a handful of clusters would not pay for the culling dispatch
+		static constexpr u32 MIN_CLUSTERED_TRIANGLES = 4 * CLUSTER_MAX_TRIANGLES;
+
+		// Of the vertex bytes, equal vertices hash equally; also used by Scene::MeshImporter's deduplication
+		static u64 hashVertex( const Engine::Vertex& _vertex );
+
+		static VertexCacheStats analyzeVertexCache( std::span<const u32> _indices, u32 _vertexCount );
+
+		// Bitwise identical vertices are merged, the remaining ones keep their relative order
+		static void remapDuplicates( std::vector<Engine::Vertex>& _vertices, std::vector<u32>& _indices );
+
+		// Tipsify (Sander et al. 2007): fans around recently used vertices, linear in the triangle count
+		static void optimizeVertexCache( std::span<u32> _indices, u32 _vertexCount );
+
+		// Splits the cache ordered stream into clusters and draws outward facing clusters first, run after optimizeVertexCache
+		static void optimizeOverdraw( std::span<u32> _indices, std::span<const Maths::Vector3> _positions );
+
+		// Renumbers vertices in order of first use, _remap receives the new index of every old vertex (~0u if unused).
+		// Returns the number of vertices still referenced
+		static u32 optimizeVertexFetch( std::span<u32> _indices, u32 _vertexCount, std::vector<u32>& _remap );
+
+		// All of the above in order
+		static MeshOptimizeReport optimize( std::vector<Engine::Vertex>& _vertices, std::vector<u32>& _indices );
+
+		// Quadric error metric edge collapses (Garland and Heckbert 1997) onto existing vertices, so the vertex buffer is shared by every level.
+		// Borders and attribute seams are kept. _error receives the object space deviation, stops early when nothing can collapse
+		static std::vector<u32> simplify( std::span<const u32> _indices, std::span<const Maths::Vector3> _positions, u32 _targetIndexCount, f32& _error );
+
+		// LOD 0 is _indices as given, each coarser level is simplified from the previous one, cache optimized and appended to _indices
+		static std::vector<GeometryLod> generateLods( std::vector<u32>& _indices, std::span<const Maths::Vector3> _positions );
+
+		// Grows clusters over triangle adjacency and reorders each level's triangles so every cluster is one index range.
+		// Fills the cluster ranges of _lods, levels below MIN_CLUSTERED_TRIANGLES are left whole
+		static std::vector<GeometryCluster> buildClusters( std::span<u32> _indices, std::span<const Maths::Vector3> _positions, std::span<GeometryLod> _lods );
+	};
+
+} // end namespace Scene
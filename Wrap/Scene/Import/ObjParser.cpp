@@ -0,0 +1,354 @@
+#include "ObjParser.h"
+
+#include <atomic>
+#include <charconv>
+
+namespace Scene {
+
+	namespace {
+		// Chunks end at the first line break past this size
+		constexpr size_t CHUNK_SIZE = 1 << 20;
+
+		// Positions written without the color extension, the color then comes from the normal
+		constexpr Maths::Vector3 NO_COLOR{ -1.0f, -1.0f, -1.0f };
+
+		constexpr i32 NO_INDEX = -1;
+
+		struct ElementCounts {
+			u32 m_Positions{ 0 };
+			u32 m_Normals{ 0 };
+		};
+
+		// Resolved to zero-based indices into the whole file
+		struct Corner {
+			i32 m_Position;
+			i32 m_Normal;
+		};
+
+		// Shared destination of every chunk, each writes its own range
+		struct Elements {
+			std::vector<Maths::Vector3> m_Positions;
+			std::vector<Maths::Vector3> m_Colors;
+			std::vector<Maths::Vector3> m_Normals;
+		};
+
+		//--------------------------------------------------------------------
+		bool IsSpace( char _c )
+		{
+			return _c == ' ' || _c == '\t' || _c == '\r';
+		}
+
+		// Cursor over the tokens of one line
+		class LineCursor
+		{
+		public:
+			explicit LineCursor( std::string_view _line ) : m_p( _line.data() ), m_pEnd( _line.data() + _line.size() ) {};
+
+			//--------------------------------------------------------------------
+			bool atEnd()
+			{
+				skipSpaces();
+				return m_p == m_pEnd;
+			}
+
+			//--------------------------------------------------------------------
+			// Consumes _keyword if it is the next whole token
+			bool keyword( std::string_view _keyword )
+			{
+				skipSpaces();
+				if ( static_cast<size_t>( m_pEnd - m_p ) < _keyword.size() || std::string_view( m_p, _keyword.size() ) != _keyword )
+					return false;
+
+				const char* pAfter = m_p + _keyword.size();
+				if ( pAfter != m_pEnd && !IsSpace( *pAfter ) )
+					return false;
+
+				m_p = pAfter;
+				return true;
+			}
+
+			//--------------------------------------------------------------------
+			bool readFloat( f32& _out )
+			{
+				skipSpaces();
+				// from_chars does not take an explicit plus sign
+				if ( m_p != m_pEnd && *m_p == '+' )
+					m_p++;
+
+				const auto [pNext, error] = std::from_chars( m_p, m_pEnd, _out );
+				if ( error != std::errc() )
+					return false;
+
+				m_p = pNext;
+				return true;
+			}
+
+			//--------------------------------------------------------------------
+			bool readVector( Maths::Vector3& _out )
+			{
+				return readFloat( _out.x ) && readFloat( _out.y ) && readFloat( _out.z );
+			}
+
+			//--------------------------------------------------------------------
+			// "p", "p/t", "p//n" or "p/t/n", texture coordinates are skipped
+			bool readCorner( i32& _position, i32& _normal )
+			{
+				skipSpaces();
+				if ( !readInt( _position ) )
+					return false;
+
+				_normal = 0;
+				if ( m_p == m_pEnd || *m_p != '/' )
+					return true;
+
+				m_p++;
+				i32 texCoord;
+				if ( m_p != m_pEnd && *m_p != '/' && !readInt( texCoord ) )
+					return false;
+
+				if ( m_p == m_pEnd || *m_p != '/' )
+					return true;
+
+				m_p++;
+				return readInt( _normal );
+			}
+
+		private:
+			//--------------------------------------------------------------------
+			void skipSpaces()
+			{
+				while ( m_p != m_pEnd && IsSpace( *m_p ) )
+				{
+					m_p++;
+				}
+			}
+
+			//--------------------------------------------------------------------
+			bool readInt( i32& _out )
+			{
+				const auto [pNext, error] = std::from_chars( m_p, m_pEnd, _out );
+				if ( error != std::errc() )
+					return false;
+
+				m_p = pNext;
+				return true;
+			}
+
+			const char* m_p;
+			const char* m_pEnd;
+		};
+
+		//--------------------------------------------------------------------
+		template<typename F>
+		void ForEachLine( std::string_view _text, F&& _function )
+		{
+			size_t begin = 0;
+			while ( begin < _text.size() )
+			{
+				size_t end = _text.find( '\n', begin );
+				if ( end == std::string_view::npos )
+					end = _text.size();
+
+				_function( _text.substr( begin, end - begin ) );
+				begin = end + 1;
+			}
+		}
+
+		//--------------------------------------------------------------------
+		std::vector<std::string_view> SplitChunks( std::string_view _text )
+		{
+			std::vector<std::string_view> chunks;
+
+			size_t begin = 0;
+			while ( begin < _text.size() )
+			{
+				size_t end = std::min( _text.size(), begin + CHUNK_SIZE );
+				if ( end < _text.size() )
+				{
+					end = _text.find( '\n', end );
+					end = end == std::string_view::npos ? _text.size() : end + 1;
+				}
+
+				chunks.push_back( _text.substr( begin, end - begin ) );
+				begin = end;
+			}
+
+			return chunks;
+		}
+
+		//--------------------------------------------------------------------
+		ElementCounts CountElements( std::string_view _chunk )
+		{
+			ElementCounts counts;
+			ForEachLine( _chunk, [&counts]( std::string_view _line ) {
+				LineCursor cursor( _line );
+				if ( cursor.keyword( "v" ) )
+				{
+					counts.m_Positions++;
+				}
+				else if ( cursor.keyword( "vn" ) )
+				{
+					counts.m_Normals++;
+				}
+			} );
+
+			return counts;
+		}
+
+		//--------------------------------------------------------------------
+		// Relative (negative) indices count back from the elements read so far
+		i32 ResolveIndex( i32 _index, u32 _readCount )
+		{
+			if ( _index > 0 )
+				return _index - 1;
+			if ( _index < 0 )
+				return static_cast<i32>( _readCount ) + _index;
+			return NO_INDEX;
+		}
+
+		//--------------------------------------------------------------------
+		bool ParseChunk( std::string_view _chunk, ElementCounts _base, Elements& _elements, std::vector<Corner>& _corners )
+		{
+			ElementCounts read = _base;
+			std::vector<Corner> polygon;
+			bool valid = true;
+
+			ForEachLine( _chunk, [&]( std::string_view _line ) {
+				if ( !valid )
+					return;
+
+				LineCursor cursor( _line );
+				if ( cursor.keyword( "v" ) )
+				{
+					Maths::Vector3 color;
+					valid = cursor.readVector( _elements.m_Positions[read.m_Positions] );
+					_elements.m_Colors[read.m_Positions] = cursor.readVector( color ) ? color : NO_COLOR;
+					read.m_Positions++;
+				}
+				else if ( cursor.keyword( "vn" ) )
+				{
+					valid = cursor.readVector( _elements.m_Normals[read.m_Normals] );
+					read.m_Normals++;
+				}
+				else if ( cursor.keyword( "f" ) )
+				{
+					polygon.clear();
+					while ( valid && !cursor.atEnd() )
+					{
+						i32 position = 0;
+						i32 normal = 0;
+						valid = cursor.readCorner( position, normal );
+						polygon.push_back( Corner{ .m_Position = ResolveIndex( position, read.m_Positions ), .m_Normal = ResolveIndex( normal, read.m_Normals ) } );
+					}
+
+					// Convex polygons assumed, triangulated as a fan
+					for ( size_t i = 2; valid && i < polygon.size(); i++ )
+					{
+						_corners.push_back( polygon[0] );
+						_corners.push_back( polygon[i - 1] );
+						_corners.push_back( polygon[i] );
+					}
+				}
+			} );
+
+			return valid;
+		}
+
+		//--------------------------------------------------------------------
+		bool BuildCorners( std::span<const Corner> _corners, const Elements& _elements, const Engine::PositionFrame& _frame, CornerBatch& _batch )
+		{
+			const i32 positionCount = static_cast<i32>( _elements.m_Positions.size() );
+			const i32 normalCount = static_cast<i32>( _elements.m_Normals.size() );
+
+			_batch.resize( _corners.size() );
+			for ( size_t i = 0; i < _corners.size(); i++ )
+			{
+				const Corner& corner = _corners[i];
+				if ( corner.m_Position < 0 || corner.m_Position >= positionCount || corner.m_Normal >= normalCount )
+					return false;
+
+				Maths::Vector3 color = _elements.m_Colors[corner.m_Position];
+				if ( color.x < 0.0f )
+				{
+					color = corner.m_Normal != NO_INDEX ? MeshImport::NormalColor( _elements.m_Normals[corner.m_Normal] ) : MeshImport::DEFAULT_COLOR;
+				}
+
+				_batch[i] = Engine::Vertex( _frame.toStored( _elements.m_Positions[corner.m_Position] ), color );
+			}
+
+			return true;
+		}
+	} // end anonymous namespace
+
+	//--------------------------------------------------------------------
+	bool ObjParser::parse( std::string_view _text, Utils::JobSystem& _jobs, std::vector<CornerBatch>& _batches, Engine::PositionFrame& _frame )
+	{
+		const std::vector<std::string_view> chunks = SplitChunks( _text );
+		const u32 chunkCount = static_cast<u32>( chunks.size() );
+
+		// Faces can use any element read before them, so element offsets of every chunk are needed before parsing
+		std::vector<ElementCounts> bases( chunkCount );
+		_jobs.parallelFor( chunkCount, 1, [&]( u32 _begin, u32 _end ) {
+			for ( u32 c = _begin; c < _end; c++ )
+			{
+				bases[c] = CountElements( chunks[c] );
+			}
+		} );
+
+		ElementCounts total;
+		for ( ElementCounts& base : bases )
+		{
+			const ElementCounts count = base;
+			base = total;
+			total.m_Positions += count.m_Positions;
+			total.m_Normals += count.m_Normals;
+		}
+
+		Elements elements;
+		elements.m_Positions.resize( total.m_Positions );
+		elements.m_Colors.resize( total.m_Positions );
+		elements.m_Normals.resize( total.m_Normals );
+
+		std::vector<std::vector<Corner>> corners( chunkCount );
+		std::atomic<bool> valid{ true };
+		_jobs.parallelFor( chunkCount, 1, [&]( u32 _begin, u32 _end ) {
+			for ( u32 c = _begin; c < _end; c++ )
+			{
+				if ( !ParseChunk( chunks[c], bases[c], elements, corners[c] ) )
+					valid.store( false, std::memory_order_relaxed );
+			}
+		} );
+
+		if ( !valid )
+			return false;
+
+		// Unreferenced positions count too, they are rare and only make the frame looser
+		_frame = Engine::PositionFrame{};
+		if ( !elements.m_Positions.empty() )
+		{
+			Maths::Vector3 min = elements.m_Positions[0];
+			Maths::Vector3 max = min;
+			for ( const Maths::Vector3& position : elements.m_Positions )
+			{
+				min = Maths::Vector3{ .x = std::min( min.x, position.x ), .y = std::min( min.y, position.y ), .z = std::min( min.z, position.z ) };
+				max = Maths::Vector3{ .x = std::max( max.x, position.x ), .y = std::max( max.y, position.y ), .z = std::max( max.z, position.z ) };
+			}
+			_frame = Engine::PositionFrame::FromBox( min, max );
+		}
+
+		// Every element is in place, faces can now reference across chunks
+		_batches.resize( chunkCount );
+		_jobs.parallelFor( chunkCount, 1, [&]( u32 _begin, u32 _end ) {
+			for ( u32 c = _begin; c < _end; c++ )
+			{
+				if ( !BuildCorners( corners[c], elements, _frame, _batches[c] ) )
+					valid.store( false, std::memory_order_relaxed );
+
+				std::vector<Corner>().swap( corners[c] );
+			}
+		} );
+
+		return valid;
+	}
+
+} // end namespace Scene
@@ -0,0 +1,19 @@
+#pragma once
+
+#include "../../Utils/Common.h"
+#include <string_view>
+
+#include "MeshImporter.h"
+
+namespace Scene {
+
+	// Wavefront OBJ: positions (with the common "v x y z r g b" color extension), normals and polygonal faces.
+	// Groups, materials and texture coordinates are skipped, every face lands in one mesh.
+	class ObjParser
+	{
+	public:
+		// One batch per chunk of the file, in file order. Positions are stored relative to _frame, which fits them all
+		static bool parse( std::string_view _text, Utils::JobSystem& _jobs, std::vector<CornerBatch>& _batches, Engine::PositionFrame& _frame );
+	};
+
+} // end namespace Scene
@@ -1,9 +1,10 @@
 #include "Mesh.h"
 
 //--------------------------------------------------------------------
-Scene::Mesh::Mesh( std::string_view _name, const Maths::Matrix4& _modelMat )
+Scene::Mesh::Mesh( std::string_view _name, GeometryAssetRef _geometry, const Transform& _transform )
 	: m_Name( _name )
-	, m_ModelMat( _modelMat )
+	, m_Geometry( std::move( _geometry ) )
+	, m_Transform( _transform )
 {
 }
 
@@ -13,18 +14,3 @@ Scene::Mesh::~Mesh()
 
 }
 
-//--------------------------------------------------------------------
-void Scene::Mesh::setTransforms( const Maths::Matrix4& _mat )
-{
-	m_ModelMat = _mat;
-}
-
-//--------------------------------------------------------------------
-void Scene::Mesh::setVertices()
-{
-}
-
-//--------------------------------------------------------------------
-void Scene::Mesh::setIndices()
-{
-}
@@ -3,37 +3,47 @@
 #include "../Utils/Common.h"
 #include <span>
 
-#include "../Engine/VulkanTypes.h"
-#include "../Maths/Matrix4.h"
+#include "GeometryAsset.h"
+#include "Transform.h"
+#include "../Utils/StringInterner.h"
 
 namespace Scene {
 	class Mesh
 	{
 	public:
-		Mesh( std::string_view _name, const Maths::Matrix4& _modelMat = Maths::Matrix4::DefaultModelMatrix() );
+		Mesh( std::string_view _name, GeometryAssetRef _geometry, const Transform& _transform = {} );
 		virtual ~Mesh();
 
-		bool operator==( const Mesh& _other ) const { return m_Name == _other.m_Name; };
+		bool operator==( const Mesh& _other ) const { return m_NameId == _other.m_NameId; };
 
-		void setTransforms( const Maths::Matrix4& _mat );
+		void setTransform( const Transform& _transform ) { m_Transform = _transform; };
+		const Transform& getTransform() const { return m_Transform; };
 
-		std::vector<Engine::Vertex>& getVertices() { return m_Vertices; };
-		const std::vector<Engine::Vertex>& getVertices() const { return m_Vertices; };
+		// Shared with every other instance of the same geometry
+		const GeometryAssetRef& getGeometry() const { return m_Geometry; };
+		// Other geometry has other levels of detail, the scene picks one again from LOD 0
+		void setGeometry( GeometryAssetRef _geometry ) { m_Geometry = std::move( _geometry ); m_Lod = 0; };
 
-		std::vector<u16>& getIndices() { return m_Indices; };
-		const std::vector<u16>& getIndices() const { return m_Indices; };
+		// Level of detail of the geometry currently drawn, chosen by the scene from the camera
+		u32 getLod() const { return m_Lod; };
+		void setLod( u32 _lod ) { m_Lod = _lod; };
 
-		const Maths::Matrix4 getModelMat() const { return m_ModelMat; };
-		constexpr std::string getName() const { return m_Name; };
+		bool isVisible() const { return m_Visible; };
+		void setVisible( bool _visible ) { m_Visible = _visible; };
+		std::string_view getName() const { return m_Name; };
 
+		// Assigned by the scene when the mesh is added, used as the renderer side key
+		Utils::NameId getNameId() const { return m_NameId; };
+		void setNameId( Utils::NameId _id ) { m_NameId = _id; };
 
-	protected:
-		virtual void setVertices();
-		virtual void setIndices();
 
+	protected:
 		std::string m_Name;
-		std::vector<Engine::Vertex> m_Vertices{};
-		std::vector<u16> m_Indices{};
-		Maths::Matrix4 m_ModelMat;
+		Utils::NameId m_NameId{ Utils::INVALID_NAME_ID };
+		GeometryAssetRef m_Geometry;
+		// Initial value, once added the scene keeps the live transform in its TransformStorage
+		Transform m_Transform;
+		bool m_Visible{ true };
+		u32 m_Lod{ 0 };
 	};
 } // end namespace Scene
@@ -6,9 +6,6 @@ namespace Scene {
 		class Cube : public Mesh
 		{
 			using Mesh::Mesh;
-
-			virtual void setVertices() override;
-			virtual void setIndices() override;
 		};
 	} // end namespace Primitives
 } // end namespace Scene
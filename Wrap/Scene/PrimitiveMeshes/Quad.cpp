@@ -1,11 +1,9 @@
 #include "Quad.h"
 
 //--------------------------------------------------------------------
-Scene::Primitives::Quad::Quad( std::string_view _name, const Maths::Matrix4& _modelMat )
-	: Mesh( _name, _modelMat )
+Scene::Primitives::Quad::Quad( std::string_view _name, const Transform& _transform )
+	: Mesh( _name, Geometry(), _transform )
 {
-	setVertices();
-	setIndices();
 }
 
 //--------------------------------------------------------------------
@@ -15,18 +13,16 @@ Scene::Primitives::Quad::~Quad()
 }
 
 //--------------------------------------------------------------------
-void Scene::Primitives::Quad::setVertices()
+const Scene::GeometryAssetRef& Scene::Primitives::Quad::Geometry()
 {
-	m_Vertices = {
-		{{-0.5f, -0.5f}, {1.0f, 0.0f, 0.0f}},
-		{{0.5f, -0.5f}, {0.0f, 1.0f, 0.0f}},
-		{{0.5f, 0.5f}, {0.0f, 0.0f, 1.0f}},
-		{{-0.5f, 0.5f}, {1.0f, 1.0f, 1.0f}}
-	};
-}
+	static const GeometryAssetRef geometry = GeometryAsset::create(
+		{
+			{{-0.5f, -0.5f, 0.0f}, {1.0f, 0.0f, 0.0f}},
+			{{0.5f, -0.5f, 0.0f}, {0.0f, 1.0f, 0.0f}},
+			{{0.5f, 0.5f, 0.0f}, {0.0f, 0.0f, 1.0f}},
+			{{-0.5f, 0.5f, 0.0f}, {1.0f, 1.0f, 1.0f}}
+		},
+		{ 0, 1, 2, 2, 3, 0 } );
 
-//--------------------------------------------------------------------
-void Scene::Primitives::Quad::setIndices()
-{
-	m_Indices = { 0, 1, 2, 2, 3, 0 };
+	return geometry;
 }
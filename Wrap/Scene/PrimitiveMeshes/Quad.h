@@ -7,11 +7,11 @@ namespace Scene {
 		class Quad : public Mesh
 		{
 		public:
-			Quad( std::string_view _name, const Maths::Matrix4& _modelMat = Maths::Matrix4::DefaultModelMatrix() );
+			Quad( std::string_view _name, const Transform& _transform = {} );
 			virtual ~Quad();
 
-			virtual void setVertices() override;
-			virtual void setIndices() override;
+			// One asset shared by every quad
+			static const GeometryAssetRef& Geometry();
 		};
 
 	} // end namespace Primitives
@@ -3,10 +3,8 @@
 
 //--------------------------------------------------------------------
 Scene::Primitives::Triangle::Triangle( std::string_view _name )
-	: Mesh( _name )
+	: Mesh( _name, Geometry() )
 {
-	setVertices();
-	setIndices();
 }
 
 //--------------------------------------------------------------------
@@ -16,17 +14,15 @@ Scene::Primitives::Triangle::~Triangle()
 }
 
 //--------------------------------------------------------------------
-void Scene::Primitives::Triangle::setVertices()
+const Scene::GeometryAssetRef& Scene::Primitives::Triangle::Geometry()
 {
-	m_Vertices = {
-		{{0.0f, -0.5f}, {1.0f, 0.0f, 0.0f}},
-		{{0.5f, 0.5f}, {0.0f, 1.0f, 0.0f}},
-		{{-0.5f, 0.5f}, {0.0f, 0.0f, 1.0f}}
-	};
-}
+	static const GeometryAssetRef geometry = GeometryAsset::create(
+		{
+			{{0.0f, -0.5f, 0.0f}, {1.0f, 0.0f, 0.0f}},
+			{{0.5f, 0.5f, 0.0f}, {0.0f, 1.0f, 0.0f}},
+			{{-0.5f, 0.5f, 0.0f}, {0.0f, 0.0f, 1.0f}}
+		},
+		{ 0, 1, 2 } );
 
-//--------------------------------------------------------------------
-void Scene::Primitives::Triangle::setIndices()
-{
-	m_Indices = { 0, 1, 2 };
+	return geometry;
 }
@@ -9,9 +9,8 @@ namespace Scene {
 			Triangle( std::string_view _name );
 			~Triangle();
 
-		private:
-			virtual void setVertices() override;
-			virtual void setIndices() override;
+			// One asset shared by every triangle
+			static const GeometryAssetRef& Geometry();
 		};
 	} // end namespace Primitives
 } // end namespace Scene
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "../Utils/Common.h"
+#include <variant>
+
+#include "Mesh.h"
+#include "../Utils/SlotMap.h"
+
+namespace Scene {
+
+	// Generational handle, stays safe to use after the mesh is removed (lookups just fail)
+	using MeshHandle = Utils::SlotHandle;
+
+	// Scene edits queued from any thread, applied by the simulation thread before it publishes a snapshot.
+	// Handles come from the simulation thread, commands on stale handles are dropped.
+	struct AddMeshCommand {
+		Mesh m_Mesh;
+	};
+
+	struct RemoveMeshCommand {
+		MeshHandle m_Handle;
+	};
+
+	struct SetMeshTransformCommand {
+		MeshHandle m_Handle;
+		Transform m_Transform;
+	};
+
+	struct SetMeshGeometryCommand {
+		MeshHandle m_Handle;
+		GeometryAssetRef m_Geometry;
+	};
+
+	struct SetMeshVisibleCommand {
+		MeshHandle m_Handle;
+		bool m_Visible;
+	};
+
+	// A null parent makes the mesh a root again
+	struct SetMeshParentCommand {
+		MeshHandle m_Handle;
+		MeshHandle m_Parent;
+	};
+
+	using SceneCommand = std::variant<AddMeshCommand, RemoveMeshCommand, SetMeshTransformCommand, SetMeshGeometryCommand, SetMeshVisibleCommand, SetMeshParentCommand>;
+
+} // end namespace Scene
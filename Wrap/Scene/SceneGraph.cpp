@@ -0,0 +1,354 @@
+#include "SceneGraph.h"
+
+#include <algorithm>
+
+#include "../Utils/JobSystem.h"
+
+namespace Scene {
+
+	namespace {
+		// Ranges larger than this are split at their root so their child subtrees can run in parallel
+		constexpr u32 SPLIT_NODE_COUNT = 1024;
+		// Below this many nodes to update, thread hand-off costs more than it saves
+		constexpr size_t PARALLEL_MIN_NODES = 4096;
+	} // end anonymous namespace
+
+	//--------------------------------------------------------------------
+	u32 SceneGraph::addObject( const Maths::Matrix4& _local )
+	{
+		const u32 object = static_cast<u32>( m_World.size() );
+
+		m_ParentOf.push_back( NO_PARENT );
+		m_FirstChild.push_back( NO_PARENT );
+		m_NextSibling.push_back( NO_PARENT );
+		m_PrevSibling.push_back( NO_PARENT );
+		m_World.push_back( _local );
+		m_Dirty.push_back( 0 );
+
+		// A new root goes last in pre-order, no reordering needed
+		const u32 node = static_cast<u32>( m_NodeObject.size() );
+		m_NodeOf.push_back( node );
+		m_NodeObject.push_back( object );
+		m_SubtreeEnd.push_back( node + 1 );
+
+		return object;
+	}
+
+	//--------------------------------------------------------------------
+	void SceneGraph::removeObject( u32 _object )
+	{
+		assert( _object < size() );
+
+		const u32 parent = m_ParentOf[_object];
+		const u32 last = static_cast<u32>( size() - 1 );
+
+		unlinkChild( _object );
+
+		// Children keep their local transform, now relative to the grandparent
+		for ( u32 child = m_FirstChild[_object]; child != NO_PARENT; )
+		{
+			const u32 next = m_NextSibling[child];
+
+			m_ParentOf[child] = parent;
+			m_PrevSibling[child] = NO_PARENT;
+			m_NextSibling[child] = NO_PARENT;
+			if ( parent != NO_PARENT )
+			{
+				linkChild( child, parent );
+			}
+			markDirty( child );
+
+			child = next;
+		}
+		m_FirstChild[_object] = NO_PARENT;
+
+		if ( _object != last )
+		{
+			// _object is unlinked and childless, the last object takes its slot and its links
+			const u32 lastParent = m_ParentOf[last];
+			const u32 prev = m_PrevSibling[last];
+			const u32 next = m_NextSibling[last];
+
+			m_ParentOf[_object] = lastParent;
+			m_FirstChild[_object] = m_FirstChild[last];
+			m_PrevSibling[_object] = prev;
+			m_NextSibling[_object] = next;
+			m_World[_object] = m_World[last];
+			m_Dirty[_object] = m_Dirty[last];
+
+			if ( prev != NO_PARENT )
+			{
+				m_NextSibling[prev] = _object;
+			}
+			else if ( lastParent != NO_PARENT )
+			{
+				m_FirstChild[lastParent] = _object;
+			}
+			if ( next != NO_PARENT )
+			{
+				m_PrevSibling[next] = _object;
+			}
+
+			for ( u32 child = m_FirstChild[_object]; child != NO_PARENT; child = m_NextSibling[child] )
+			{
+				m_ParentOf[child] = _object;
+			}
+
+			if ( m_Dirty[_object] )
+			{
+				m_DirtyObjects.push_back( _object );
+			}
+		}
+
+		m_ParentOf.pop_back();
+		m_FirstChild.pop_back();
+		m_NextSibling.pop_back();
+		m_PrevSibling.pop_back();
+		m_World.pop_back();
+		m_Dirty.pop_back();
+		m_NodeOf.pop_back();
+
+		m_OrderDirty = true;
+	}
+
+	//--------------------------------------------------------------------
+	bool SceneGraph::setParent( u32 _object, u32 _parent )
+	{
+		assert( _object < size() && ( _parent == NO_PARENT || _parent < size() ) );
+
+		// Walk up from the new parent, meeting _object means it would become its own ancestor
+		for ( u32 ancestor = _parent; ancestor != NO_PARENT; ancestor = m_ParentOf[ancestor] )
+		{
+			if ( ancestor == _object )
+				return false;
+		}
+
+		if ( m_ParentOf[_object] != _parent )
+		{
+			unlinkChild( _object );
+			m_ParentOf[_object] = _parent;
+			if ( _parent != NO_PARENT )
+			{
+				linkChild( _object, _parent );
+			}
+			m_OrderDirty = true;
+			markDirty( _object );
+		}
+
+		return true;
+	}
+
+	//--------------------------------------------------------------------
+	void SceneGraph::markDirty( u32 _object )
+	{
+		if ( !m_Dirty[_object] )
+		{
+			m_Dirty[_object] = 1;
+			m_DirtyObjects.push_back( _object );
+		}
+	}
+
+	//--------------------------------------------------------------------
+	void SceneGraph::linkChild( u32 _object, u32 _parent )
+	{
+		const u32 first = m_FirstChild[_parent];
+
+		m_PrevSibling[_object] = NO_PARENT;
+		m_NextSibling[_object] = first;
+		if ( first != NO_PARENT )
+		{
+			m_PrevSibling[first] = _object;
+		}
+		m_FirstChild[_parent] = _object;
+	}
+
+	//--------------------------------------------------------------------
+	void SceneGraph::unlinkChild( u32 _object )
+	{
+		const u32 parent = m_ParentOf[_object];
+		const u32 prev = m_PrevSibling[_object];
+		const u32 next = m_NextSibling[_object];
+
+		if ( prev != NO_PARENT )
+		{
+			m_NextSibling[prev] = next;
+		}
+		else if ( parent != NO_PARENT )
+		{
+			m_FirstChild[parent] = next;
+		}
+		if ( next != NO_PARENT )
+		{
+			m_PrevSibling[next] = prev;
+		}
+
+		m_PrevSibling[_object] = NO_PARENT;
+		m_NextSibling[_object] = NO_PARENT;
+	}
+
+	//--------------------------------------------------------------------
+	void SceneGraph::rebuildOrder()
+	{
+		const u32 count = static_cast<u32>( size() );
+
+		// Children grouped by parent (counting sort), roots use the extra last bucket
+		std::vector<u32> childStart( count + 3, 0 );
+		for ( u32 object = 0; object < count; object++ )
+		{
+			const u32 parent = m_ParentOf[object] == NO_PARENT ? count : m_ParentOf[object];
+			childStart[parent + 2]++;
+		}
+		for ( u32 i = 2; i < childStart.size(); i++ )
+		{
+			childStart[i] += childStart[i - 1];
+		}
+
+		std::vector<u32> children( count );
+		for ( u32 object = 0; object < count; object++ )
+		{
+			const u32 parent = m_ParentOf[object] == NO_PARENT ? count : m_ParentOf[object];
+			children[childStart[parent + 1]++] = object;
+		}
+
+		// Depth-first from every root, childStart[p] .. childStart[p + 1] now spans p's children
+		m_NodeObject.clear();
+		m_NodeObject.reserve( count );
+
+		std::vector<u32> stack;
+		for ( u32 r = childStart[count + 1]; r-- > childStart[count]; )
+		{
+			stack.push_back( children[r] );
+		}
+
+		while ( !stack.empty() )
+		{
+			const u32 object = stack.back();
+			stack.pop_back();
+
+			m_NodeOf[object] = static_cast<u32>( m_NodeObject.size() );
+			m_NodeObject.push_back( object );
+
+			// Reverse push keeps siblings in their original order
+			for ( u32 c = childStart[object + 1]; c-- > childStart[object]; )
+			{
+				stack.push_back( children[c] );
+			}
+		}
+
+		// Subtree sizes bottom-up, in reverse pre-order every child is visited before its parent
+		m_SubtreeEnd.assign( count, 1 );
+		for ( u32 node = count; node-- > 0; )
+		{
+			const u32 parent = m_ParentOf[m_NodeObject[node]];
+			if ( parent != NO_PARENT )
+			{
+				m_SubtreeEnd[m_NodeOf[parent]] += m_SubtreeEnd[node];
+			}
+		}
+		for ( u32 node = 0; node < count; node++ )
+		{
+			m_SubtreeEnd[node] += node;
+		}
+
+		m_OrderDirty = false;
+	}
+
+	//--------------------------------------------------------------------
+	void SceneGraph::computeNode( u32 _node, std::span<const Maths::Matrix4> _localMatrices )
+	{
+		const u32 object = m_NodeObject[_node];
+		const u32 parent = m_ParentOf[object];
+
+		m_World[object] = parent == NO_PARENT ? _localMatrices[object] : m_World[parent] * _localMatrices[object];
+	}
+
+	//--------------------------------------------------------------------
+	std::span<const u32> SceneGraph::updateWorld( std::span<const Maths::Matrix4> _localMatrices )
+	{
+		assert( _localMatrices.size() == size() );
+
+		m_Updated.clear();
+
+		if ( m_OrderDirty )
+		{
+			rebuildOrder();
+		}
+
+		m_DirtyNodes.clear();
+		for ( const u32 object : m_DirtyObjects )
+		{
+			if ( object < size() && m_Dirty[object] )
+			{
+				m_Dirty[object] = 0;
+				m_DirtyNodes.push_back( m_NodeOf[object] );
+			}
+		}
+		m_DirtyObjects.clear();
+
+		if ( m_DirtyNodes.empty() )
+			return m_Updated;
+
+		// Dirty nodes inside an already dirty subtree are covered by it
+		std::ranges::sort( m_DirtyNodes );
+
+		m_Work.clear();
+		u32 coveredEnd = 0;
+		for ( const u32 node : m_DirtyNodes )
+		{
+			if ( node < coveredEnd )
+				continue;
+
+			m_Work.push_back( Range{ .m_Begin = node, .m_End = m_SubtreeEnd[node] } );
+			coveredEnd = m_SubtreeEnd[node];
+
+			for ( u32 n = node; n < coveredEnd; n++ )
+			{
+				m_Updated.push_back( m_NodeObject[n] );
+			}
+		}
+
+		// Split large subtrees: their root is computed here, each child subtree becomes its own range.
+		// Work grows while it is walked, a root is always computed before the ranges under it are queued.
+		m_Ranges.clear();
+		for ( size_t w = 0; w < m_Work.size(); w++ )
+		{
+			const Range range = m_Work[w];
+			if ( range.m_End - range.m_Begin <= SPLIT_NODE_COUNT )
+			{
+				m_Ranges.push_back( range );
+				continue;
+			}
+
+			computeNode( range.m_Begin, _localMatrices );
+			for ( u32 child = range.m_Begin + 1; child < range.m_End; child = m_SubtreeEnd[child] )
+			{
+				m_Work.push_back( Range{ .m_Begin = child, .m_End = m_SubtreeEnd[child] } );
+			}
+		}
+
+		// Ranges are disjoint and their parents are final, so they can run in any order
+		auto computeRange = [this, _localMatrices]( const Range& _range ) {
+			for ( u32 node = _range.m_Begin; node < _range.m_End; node++ )
+			{
+				computeNode( node, _localMatrices );
+			}
+		};
+
+		if ( m_Updated.size() >= PARALLEL_MIN_NODES && m_Ranges.size() > 1 )
+		{
+			Utils::JobSystem::Instance().parallelFor( static_cast<u32>( m_Ranges.size() ), 1, [this, &computeRange]( u32 _begin, u32 _end ) {
+				for ( u32 r = _begin; r < _end; r++ )
+				{
+					computeRange( m_Ranges[r] );
+				}
+			} );
+		}
+		else
+		{
+			std::ranges::for_each( m_Ranges, computeRange );
+		}
+
+		return m_Updated;
+	}
+
+} // end namespace Scene
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "../Utils/Common.h"
+#include <span>
+
+#include "../Maths/Matrix4.h"
+
+namespace Scene {
+
+	// Transform hierarchy over objects addressed by dense index (the same indices as TransformStorage).
+	// Nodes are kept in depth-first pre-order, so a parent always precedes its children and every subtree
+	// is one contiguous range. A dirty node only recomputes its own range, independent ranges run in parallel.
+	class SceneGraph
+	{
+	public:
+		static constexpr u32 NO_PARENT = ~0u;
+
+		// New objects are roots, their world matrix is their local one
+		u32 addObject( const Maths::Matrix4& _local );
+		// Swap-and-pop like the other dense containers, children are reattached to the removed object's parent
+		void removeObject( u32 _object );
+
+		// Returns false if it would create a cycle
+		bool setParent( u32 _object, u32 _parent );
+		u32 getParent( u32 _object ) const { return m_ParentOf[_object]; };
+
+		// The local matrix changed, the object and all of its descendants need a new world matrix
+		void markDirty( u32 _object );
+
+		// Recomputes world matrices of dirty subtrees, returns every object whose world matrix was rewritten
+		std::span<const u32> updateWorld( std::span<const Maths::Matrix4> _localMatrices );
+
+		// Indexed by object
+		std::span<const Maths::Matrix4> getWorldMatrices() const { return m_World; };
+		size_t size() const { return m_World.size(); };
+
+	private:
+		struct Range {
+			u32 m_Begin;
+			u32 m_End;
+		};
+
+		// Sibling lists let removals and reparenting touch only the nodes involved
+		void linkChild( u32 _object, u32 _parent );
+		void unlinkChild( u32 _object );
+
+		void rebuildOrder();
+		void computeNode( u32 _node, std::span<const Maths::Matrix4> _localMatrices );
+
+		// Per object
+		std::vector<u32> m_ParentOf;
+		// Children of each parent as a doubly linked list, NO_PARENT ends it. Roots are not linked
+		std::vector<u32> m_FirstChild;
+		std::vector<u32> m_NextSibling;
+		std::vector<u32> m_PrevSibling;
+		std::vector<u32> m_NodeOf;
+		std::vector<Maths::Matrix4> m_World;
+		std::vector<u8> m_Dirty;
+		// May hold duplicates or stale entries after removals, m_Dirty is the source of truth
+		std::vector<u32> m_DirtyObjects;
+
+		// Per node, in pre-order
+		std::vector<u32> m_NodeObject;
+		std::vector<u32> m_SubtreeEnd;
+		// Set by reparenting and removals, appending roots keeps the order valid
+		bool m_OrderDirty{ false };
+
+		// Scratch, kept to avoid reallocating every frame
+		std::vector<u32> m_DirtyNodes;
+		std::vector<Range> m_Work;
+		std::vector<Range> m_Ranges;
+		std::vector<u32> m_Updated;
+	};
+
+} // end namespace Scene
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "../Utils/Common.h"
+
+#include "GeometryAsset.h"
+#include "../Maths/Matrix4.h"
+#include "../Maths/Vector3.h"
+#include "../Utils/StringInterner.h"
+
+namespace Scene {
+
+	enum class MeshChangeType : u8 {
+		ADDED,
+		REMOVED,
+		TRANSFORM_CHANGED,
+		GEOMETRY_CHANGED,
+		VISIBILITY_CHANGED,
+		LOD_CHANGED
+	};
+
+	// Journal entry, carries the state it sets so it can be applied without touching the live scene
+	struct MeshChange {
+		MeshChangeType m_Type;
+		// Snapshot version the entry was last written for, entries dropped by the journal are 0
+		u64 m_Version;
+		Utils::NameId m_MeshId;
+
+		// Only the fields relevant to m_Type are set
+		GeometryAssetRef m_Geometry;
+		Maths::Matrix4 m_Transform;
+		bool m_Visible{ true };
+		u32 m_Lod{ 0 };
+	};
+
+	struct Camera {
+		Maths::Vector3 m_EyePos;
+		Maths::Vector3 m_LookAt;
+		Maths::Vector3 m_WorldUp;
+	};
+
+	struct ProjectionSettings {
+		f32 m_Fov;
+		f32 m_Near;
+		f32 m_Far;
+	};
+
+	// Immutable view of the scene published once per frame, readers never see it change.
+	// Arrays are parallel and dense, in no particular order.
+	struct SceneSnapshot {
+		u64 m_Version{ 0 };
+		// Scene state the arrays were captured from, lets the writer skip the copy when nothing changed
+		u64 m_StateVersion{ 0 };
+
+		std::vector<Utils::NameId> m_MeshIds;
+		std::vector<Maths::Matrix4> m_Transforms;
+		std::vector<u8> m_Visible;
+
+		// Every change the reader has not acknowledged yet, in the order they apply. Repeated changes to a mesh are merged,
+		// snapshots skipped by a slow reader are never lost, their changes are repeated here.
+		std::vector<MeshChange> m_Changes;
+
+		Maths::Matrix4 m_View;
+		ProjectionSettings m_Projection{};
+		// Bumped on every camera change, the renderer only rewrites its camera UBO when it differs
+		u64 m_CameraVersion{ 0 };
+
+		size_t getMeshCount() const { return m_MeshIds.size(); };
+	};
+
+} // end namespace Scene
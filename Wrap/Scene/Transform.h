@@ -0,0 +1,19 @@
+#pragma once
+
+#include "../Maths/Matrix4.h"
+#include "../Maths/Quaternion.h"
+#include "../Maths/Vector3.h"
+
+namespace Scene {
+
+	// Local transform as edited by the scene, composed into a model matrix in batches by TransformStorage
+	struct Transform {
+		Maths::Vector3 m_Position{};
+		// Unit quaternion, Quaternion::FromEuler converts Euler-authored content
+		Maths::Quaternion m_Rotation{};
+		Maths::Vector3 m_Scale{ 1.0f, 1.0f, 1.0f };
+
+		Maths::Matrix4 toMatrix() const { return m_Rotation.ToModelMatrix( m_Position, m_Scale ); };
+	};
+
+} // end namespace Scene
@@ -0,0 +1,318 @@
+#include "TransformStorage.h"
+
+#include "../Maths/Simd.h"
+
+#include <cmath>
+#include <numeric>
+
+namespace Scene {
+
+	namespace {
+		// Above this share of dirty objects, a linear pass beats gathering the dirty ones
+		constexpr size_t FULL_PASS_RATIO = 4;
+
+#if WRAP_SIMD_SSE
+		//--------------------------------------------------------------------
+		// Same terms as Quaternion::ToModelMatrix, four objects per register. Writes four column-major matrices.
+		inline void compose4( const __m128 ( &_l )[10], Maths::Matrix4* const ( &_out )[4] )
+		{
+			const __m128 x = _l[3], y = _l[4], z = _l[5], w = _l[6];
+			const __m128 zero = _mm_setzero_ps();
+			const __m128 one = _mm_set1_ps( 1.0f );
+			const __m128 two = _mm_set1_ps( 2.0f );
+
+			const __m128 x2 = _mm_mul_ps( x, two ), y2 = _mm_mul_ps( y, two ), z2 = _mm_mul_ps( z, two );
+			const __m128 xx = _mm_mul_ps( x, x2 ), yy = _mm_mul_ps( y, y2 ), zz = _mm_mul_ps( z, z2 );
+			const __m128 xy = _mm_mul_ps( x, y2 ), xz = _mm_mul_ps( x, z2 ), yz = _mm_mul_ps( y, z2 );
+			const __m128 wx = _mm_mul_ps( w, x2 ), wy = _mm_mul_ps( w, y2 ), wz = _mm_mul_ps( w, z2 );
+
+			const __m128 m00 = _mm_sub_ps( one, _mm_add_ps( yy, zz ) );
+			const __m128 m01 = _mm_add_ps( xy, wz );
+			const __m128 m02 = _mm_sub_ps( xz, wy );
+			const __m128 m10 = _mm_sub_ps( xy, wz );
+			const __m128 m11 = _mm_sub_ps( one, _mm_add_ps( xx, zz ) );
+			const __m128 m12 = _mm_add_ps( yz, wx );
+			const __m128 m20 = _mm_add_ps( xz, wy );
+			const __m128 m21 = _mm_sub_ps( yz, wx );
+			const __m128 m22 = _mm_sub_ps( one, _mm_add_ps( xx, yy ) );
+
+			// Each group of four registers holds one column for four objects, transposing gives the column of each object
+			__m128 c1a = _mm_mul_ps( m00, _l[7] ), c1b = _mm_mul_ps( m01, _l[7] ), c1c = _mm_mul_ps( m02, _l[7] ), c1d = zero;
+			__m128 c2a = _mm_mul_ps( m10, _l[8] ), c2b = _mm_mul_ps( m11, _l[8] ), c2c = _mm_mul_ps( m12, _l[8] ), c2d = zero;
+			__m128 c3a = _mm_mul_ps( m20, _l[9] ), c3b = _mm_mul_ps( m21, _l[9] ), c3c = _mm_mul_ps( m22, _l[9] ), c3d = zero;
+			__m128 c4a = _l[0], c4b = _l[1], c4c = _l[2], c4d = one;
+
+			_MM_TRANSPOSE4_PS( c1a, c1b, c1c, c1d );
+			_MM_TRANSPOSE4_PS( c2a, c2b, c2c, c2d );
+			_MM_TRANSPOSE4_PS( c3a, c3b, c3c, c3d );
+			_MM_TRANSPOSE4_PS( c4a, c4b, c4c, c4d );
+
+			const __m128 columns[4][4] = {
+				{ c1a, c2a, c3a, c4a },
+				{ c1b, c2b, c3b, c4b },
+				{ c1c, c2c, c3c, c4c },
+				{ c1d, c2d, c3d, c4d }
+			};
+
+			for ( u32 i = 0; i < 4; i++ )
+			{
+				f32* pDest = &_out[i]->c1.x;
+				_mm_storeu_ps( pDest, columns[i][0] );
+				_mm_storeu_ps( pDest + 4, columns[i][1] );
+				_mm_storeu_ps( pDest + 8, columns[i][2] );
+				_mm_storeu_ps( pDest + 12, columns[i][3] );
+			}
+		}
+#endif
+	} // end anonymous namespace
+
+	//--------------------------------------------------------------------
+	u32 TransformStorage::push( const Transform& _transform )
+	{
+		const u32 index = static_cast<u32>( m_Matrices.size() );
+
+		for ( auto& lane : m_Lanes )
+		{
+			lane.push_back( 0.0f );
+		}
+		m_Matrices.emplace_back();
+		m_Dirty.push_back( 0 );
+
+		set( index, _transform );
+
+		// Composed right away so the object can be published in the same frame it was added
+		composeOne( index );
+		m_Dirty[index] = 0;
+
+		return index;
+	}
+
+	//--------------------------------------------------------------------
+	void TransformStorage::remove( u32 _index )
+	{
+		assert( _index < size() );
+
+		const u32 last = static_cast<u32>( size() - 1 );
+		if ( _index != last )
+		{
+			for ( auto& lane : m_Lanes )
+			{
+				lane[_index] = lane[last];
+			}
+			m_Matrices[_index] = m_Matrices[last];
+			m_Dirty[_index] = m_Dirty[last];
+
+			// The moved object keeps its pending rebuild under its new index
+			if ( m_Dirty[_index] )
+			{
+				m_DirtyList.push_back( _index );
+			}
+		}
+
+		for ( auto& lane : m_Lanes )
+		{
+			lane.pop_back();
+		}
+		m_Matrices.pop_back();
+		m_Dirty.pop_back();
+	}
+
+	//--------------------------------------------------------------------
+	void TransformStorage::reserve( size_t _capacity )
+	{
+		for ( auto& lane : m_Lanes )
+		{
+			lane.reserve( _capacity );
+		}
+		m_Matrices.reserve( _capacity );
+		m_Dirty.reserve( _capacity );
+	}
+
+	//--------------------------------------------------------------------
+	void TransformStorage::clear()
+	{
+		for ( auto& lane : m_Lanes )
+		{
+			lane.clear();
+		}
+		m_Matrices.clear();
+		m_Dirty.clear();
+		m_DirtyList.clear();
+		m_Updated.clear();
+	}
+
+	//--------------------------------------------------------------------
+	void TransformStorage::set( u32 _index, const Transform& _transform )
+	{
+		setPosition( _index, _transform.m_Position );
+		setRotation( _index, _transform.m_Rotation );
+		setScale( _index, _transform.m_Scale );
+	}
+
+	//--------------------------------------------------------------------
+	void TransformStorage::setPosition( u32 _index, const Maths::Vector3& _position )
+	{
+		m_Lanes[POS_X][_index] = _position.x;
+		m_Lanes[POS_Y][_index] = _position.y;
+		m_Lanes[POS_Z][_index] = _position.z;
+		markDirty( _index );
+	}
+
+	//--------------------------------------------------------------------
+	void TransformStorage::setRotation( u32 _index, const Maths::Quaternion& _rotation )
+	{
+		assert( std::abs( Maths::Quaternion::Dot( _rotation, _rotation ) - 1.0f ) < 1e-3f );
+
+		m_Lanes[ROT_X][_index] = _rotation.x;
+		m_Lanes[ROT_Y][_index] = _rotation.y;
+		m_Lanes[ROT_Z][_index] = _rotation.z;
+		m_Lanes[ROT_W][_index] = _rotation.w;
+		markDirty( _index );
+	}
+
+	//--------------------------------------------------------------------
+	void TransformStorage::setScale( u32 _index, const Maths::Vector3& _scale )
+	{
+		m_Lanes[SCALE_X][_index] = _scale.x;
+		m_Lanes[SCALE_Y][_index] = _scale.y;
+		m_Lanes[SCALE_Z][_index] = _scale.z;
+		markDirty( _index );
+	}
+
+	//--------------------------------------------------------------------
+	Transform TransformStorage::get( u32 _index ) const
+	{
+		return Transform{
+			.m_Position = Maths::Vector3{ m_Lanes[POS_X][_index], m_Lanes[POS_Y][_index], m_Lanes[POS_Z][_index] },
+			.m_Rotation = Maths::Quaternion{ m_Lanes[ROT_X][_index], m_Lanes[ROT_Y][_index], m_Lanes[ROT_Z][_index], m_Lanes[ROT_W][_index] },
+			.m_Scale = Maths::Vector3{ m_Lanes[SCALE_X][_index], m_Lanes[SCALE_Y][_index], m_Lanes[SCALE_Z][_index] }
+		};
+	}
+
+	//--------------------------------------------------------------------
+	void TransformStorage::markDirty( u32 _index )
+	{
+		if ( !m_Dirty[_index] )
+		{
+			m_Dirty[_index] = 1;
+			m_DirtyList.push_back( _index );
+		}
+	}
+
+	//--------------------------------------------------------------------
+	void TransformStorage::markAllDirty()
+	{
+		m_DirtyList.resize( size() );
+		std::iota( m_DirtyList.begin(), m_DirtyList.end(), 0u );
+		std::fill( m_Dirty.begin(), m_Dirty.end(), u8{ 1 } );
+	}
+
+	//--------------------------------------------------------------------
+	std::span<const u32> TransformStorage::updateMatrices()
+	{
+		m_Updated.clear();
+
+		if ( m_DirtyList.empty() )
+			return m_Updated;
+
+		// Stale entries only inflate the estimate, either path gives the same result
+		if ( m_DirtyList.size() * FULL_PASS_RATIO >= size() )
+		{
+			composeAll();
+		}
+		else
+		{
+			composeDirty();
+		}
+
+		m_DirtyList.clear();
+		return m_Updated;
+	}
+
+	//--------------------------------------------------------------------
+	void TransformStorage::composeAll()
+	{
+		const u32 count = static_cast<u32>( size() );
+		u32 i = 0;
+
+#if WRAP_SIMD_SSE
+		for ( ; i + 4 <= count; i += 4 )
+		{
+			__m128 lanes[LANE_COUNT];
+			for ( u32 l = 0; l < LANE_COUNT; l++ )
+			{
+				lanes[l] = _mm_loadu_ps( &m_Lanes[l][i] );
+			}
+
+			Maths::Matrix4* const outputs[4] = { &m_Matrices[i], &m_Matrices[i + 1], &m_Matrices[i + 2], &m_Matrices[i + 3] };
+			compose4( lanes, outputs );
+		}
+#endif
+		for ( ; i < count; i++ )
+		{
+			composeOne( i );
+		}
+
+		// Only the flagged objects are reported, the others were recomposed to identical values
+		for ( u32 index = 0; index < count; index++ )
+		{
+			if ( m_Dirty[index] )
+			{
+				m_Dirty[index] = 0;
+				m_Updated.push_back( index );
+			}
+		}
+	}
+
+	//--------------------------------------------------------------------
+	void TransformStorage::composeDirty()
+	{
+		const u32 count = static_cast<u32>( size() );
+
+		// Drop duplicates and stale entries first, the batches then only see live flagged objects
+		for ( u32 index : m_DirtyList )
+		{
+			if ( index < count && m_Dirty[index] )
+			{
+				m_Dirty[index] = 0;
+				m_Updated.push_back( index );
+			}
+		}
+
+		const u32 updated = static_cast<u32>( m_Updated.size() );
+		u32 i = 0;
+
+#if WRAP_SIMD_SSE
+		for ( ; i + 4 <= updated; i += 4 )
+		{
+			const u32 i0 = m_Updated[i], i1 = m_Updated[i + 1], i2 = m_Updated[i + 2], i3 = m_Updated[i + 3];
+
+			__m128 lanes[LANE_COUNT];
+			for ( u32 l = 0; l < LANE_COUNT; l++ )
+			{
+				const f32* pLane = m_Lanes[l].data();
+				lanes[l] = _mm_setr_ps( pLane[i0], pLane[i1], pLane[i2], pLane[i3] );
+			}
+
+			Maths::Matrix4* const outputs[4] = { &m_Matrices[i0], &m_Matrices[i1], &m_Matrices[i2], &m_Matrices[i3] };
+			compose4( lanes, outputs );
+		}
+#endif
+		for ( ; i < updated; i++ )
+		{
+			composeOne( m_Updated[i] );
+		}
+	}
+
+	//--------------------------------------------------------------------
+	void TransformStorage::composeOne( u32 _index )
+	{
+		auto lane = [this, _index]( Lane _lane ) { return m_Lanes[_lane][_index]; };
+
+		const Maths::Quaternion rotation{ lane( ROT_X ), lane( ROT_Y ), lane( ROT_Z ), lane( ROT_W ) };
+		m_Matrices[_index] = rotation.ToModelMatrix(
+			Maths::Vector3{ lane( POS_X ), lane( POS_Y ), lane( POS_Z ) },
+			Maths::Vector3{ lane( SCALE_X ), lane( SCALE_Y ), lane( SCALE_Z ) } );
+	}
+
+} // end namespace Scene
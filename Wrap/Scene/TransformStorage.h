@@ -0,0 +1,63 @@
+#pragma once
+
+#include "../Utils/Common.h"
+#include <span>
+
+#include "Transform.h"
+#include "../Maths/Matrix4.h"
+#include "../Maths/Quaternion.h"
+
+namespace Scene {
+
+	// Structure-of-arrays transform storage. Objects are addressed by dense index and removed with swap-and-pop,
+	// so a container mirroring the same moves (SlotMap values) stays aligned with it.
+	// Edits only flag the object, updateMatrices() then rebuilds every flagged model matrix in one SIMD batch.
+	class TransformStorage
+	{
+	public:
+		u32 push( const Transform& _transform );
+		void remove( u32 _index );
+		void reserve( size_t _capacity );
+		void clear();
+
+		void set( u32 _index, const Transform& _transform );
+		void setPosition( u32 _index, const Maths::Vector3& _position );
+		// Unit quaternion, composed into the matrix without any trig
+		void setRotation( u32 _index, const Maths::Quaternion& _rotation );
+		void setScale( u32 _index, const Maths::Vector3& _scale );
+
+		Transform get( u32 _index ) const;
+
+		// Rebuilds the model matrix of every flagged object, returns their indices
+		std::span<const u32> updateMatrices();
+		// Flags every object, for benchmarks and bulk loads
+		void markAllDirty();
+
+		std::span<const Maths::Matrix4> getMatrices() const { return m_Matrices; };
+		size_t size() const { return m_Matrices.size(); };
+		size_t dirtyCount() const { return m_DirtyList.size(); };
+
+	private:
+		enum Lane : u32 {
+			POS_X, POS_Y, POS_Z,
+			ROT_X, ROT_Y, ROT_Z, ROT_W,
+			SCALE_X, SCALE_Y, SCALE_Z,
+			LANE_COUNT
+		};
+
+		void markDirty( u32 _index );
+		void composeAll();
+		void composeDirty();
+		void composeOne( u32 _index );
+
+		std::array<std::vector<f32>, LANE_COUNT> m_Lanes;
+
+		std::vector<Maths::Matrix4> m_Matrices;
+
+		std::vector<u8> m_Dirty;
+		// May hold duplicates or stale entries after removals, m_Dirty is the source of truth
+		std::vector<u32> m_DirtyList;
+		std::vector<u32> m_Updated;
+	};
+
+} // end namespace Scene
@@ -1,2 +1,5 @@
+if not exist Compiled mkdir Compiled
 C:\VulkanSDK\1.3.290.0\Bin\glslc.exe main.vert -o Compiled/main.vert.spv
-C:\VulkanSDK\1.3.290.0\Bin\glslc.exe main.frag -o Compiled/main.frag.spv
\ No newline at end of file
+C:\VulkanSDK\1.3.290.0\Bin\glslc.exe main.frag -o Compiled/main.frag.spv
+C:\VulkanSDK\1.3.290.0\Bin\glslc.exe cull.comp -o Compiled/cull.comp.spv
+C:\VulkanSDK\1.3.290.0\Bin\glslc.exe pull.vert -o Compiled/pull.vert.spv
@@ -1,6 +1,10 @@
 #version 450
 
-#extension GL_EXT_nonuniform_qualifier : enable
+// Engine::TransformEncoding, set per pipeline so only one decode path is compiled in
+layout( constant_id = 0 ) const uint TRANSFORM_ENCODING = 0;
+const uint ENCODING_MATRIX_4X4 = 0;
+const uint ENCODING_AFFINE_3X4 = 1;
+const uint ENCODING_QUANTIZED = 2;
 
 layout( set = 0, binding = 0 ) uniform CameraUBO
 {
@@ -8,22 +12,59 @@ layout( set = 0, binding = 0 ) uniform CameraUBO
     mat4 proj;
 } camera;
 
-layout( set = 0, binding = 1 ) uniform ModelUBO
+// Raw words, the stride and layout depend on TRANSFORM_ENCODING
+layout( std430, set = 0, binding = 1 ) readonly buffer ModelBuffer
 {
-    mat4 model;
-} models[];
+    uint modelWords[];
+};
 
-layout(location = 0) in vec2 inPosition;
+layout(location = 0) in vec3 inPosition;
 layout(location = 1) in vec3 inColor;
 
+// Engine::MeshPushConstants
 layout(push_constant) uniform PushConstants {
+    // Engine::PositionFrame of the bound geometry: offset, then uniform scale
+    vec4 positionFrame;
     uint modelIndex;
 } pushConsts;
 
 layout(location = 0) out vec3 fragColor;
 
+vec4 loadVec4( uint _word )
+{
+    return uintBitsToFloat( uvec4( modelWords[_word], modelWords[_word + 1], modelWords[_word + 2], modelWords[_word + 3] ) );
+}
+
+vec3 toWorld( uint _index, vec3 _pos )
+{
+    if ( TRANSFORM_ENCODING == ENCODING_AFFINE_3X4 )
+    {
+        // Three rows, 12 words
+        const uint base = _index * 12;
+        const vec4 pos = vec4( _pos, 1.0 );
+        return vec3( dot( loadVec4( base ), pos ), dot( loadVec4( base + 4 ), pos ), dot( loadVec4( base + 8 ), pos ) );
+    }
+    else if ( TRANSFORM_ENCODING == ENCODING_QUANTIZED )
+    {
+        // Position, uniform scale, snorm16 quaternion, 6 words
+        const uint base = _index * 6;
+        const vec4 posScale = loadVec4( base );
+        const vec4 q = normalize( vec4( unpackSnorm2x16( modelWords[base + 4] ), unpackSnorm2x16( modelWords[base + 5] ) ) );
+
+        const vec3 v = _pos * posScale.w;
+        return v + 2.0 * cross( q.xyz, cross( q.xyz, v ) + q.w * v ) + posScale.xyz;
+    }
+    else
+    {
+        const uint base = _index * 16;
+        const mat4 model = mat4( loadVec4( base ), loadVec4( base + 4 ), loadVec4( base + 8 ), loadVec4( base + 12 ) );
+        return ( model * vec4( _pos, 1.0 ) ).xyz;
+    }
+}
+
 void main() 
 {
-    gl_Position = camera.proj * camera.view * models[nonuniformEXT(pushConsts.modelIndex)].model * vec4(inPosition, 0.0, 1.0 );
+    const vec3 position = inPosition * pushConsts.positionFrame.w + pushConsts.positionFrame.xyz;
+    gl_Position = camera.proj * camera.view * vec4( toWorld( pushConsts.modelIndex, position ), 1.0 );
     fragColor = inColor;
-}
\ No newline at end of file
+}
@@ -0,0 +1,108 @@
+#version 450
+#extension GL_EXT_buffer_reference : require
+
+// main.vert without fixed-function vertex input: indices and vertices are fetched through the
+// buffer addresses of the draw's Engine::DrawRecord, so one indirect draw can span any number of meshes
+
+// Engine::TransformEncoding, set per pipeline so only one decode path is compiled in
+layout( constant_id = 0 ) const uint TRANSFORM_ENCODING = 0;
+const uint ENCODING_MATRIX_4X4 = 0;
+const uint ENCODING_AFFINE_3X4 = 1;
+const uint ENCODING_QUANTIZED = 2;
+
+layout( buffer_reference, std430, buffer_reference_align = 4 ) readonly buffer Words
+{
+    uint words[];
+};
+
+struct DrawRecord
+{
+    Words vertices;
+    Words indices;
+    // 2 or 4
+    uint indexSize;
+    // In words
+    uint vertexStride;
+    // Engine::PositionFrame of the stored positions: offset, then uniform scale
+    vec4 positionFrame;
+};
+
+layout( set = 0, binding = 0 ) uniform CameraUBO
+{
+    mat4 view;
+    mat4 proj;
+} camera;
+
+// Raw words, the stride and layout depend on TRANSFORM_ENCODING
+layout( std430, set = 0, binding = 1 ) readonly buffer ModelBuffer
+{
+    uint modelWords[];
+};
+
+// One per model, the draw's first instance selects it
+layout( std430, set = 0, binding = 2 ) readonly buffer DrawRecords
+{
+    DrawRecord records[];
+};
+
+layout(location = 0) out vec3 fragColor;
+
+vec4 loadVec4( uint _word )
+{
+    return uintBitsToFloat( uvec4( modelWords[_word], modelWords[_word + 1], modelWords[_word + 2], modelWords[_word + 3] ) );
+}
+
+vec3 toWorld( uint _index, vec3 _pos )
+{
+    if ( TRANSFORM_ENCODING == ENCODING_AFFINE_3X4 )
+    {
+        // Three rows, 12 words
+        const uint base = _index * 12;
+        const vec4 pos = vec4( _pos, 1.0 );
+        return vec3( dot( loadVec4( base ), pos ), dot( loadVec4( base + 4 ), pos ), dot( loadVec4( base + 8 ), pos ) );
+    }
+    else if ( TRANSFORM_ENCODING == ENCODING_QUANTIZED )
+    {
+        // Position, uniform scale, snorm16 quaternion, 6 words
+        const uint base = _index * 6;
+        const vec4 posScale = loadVec4( base );
+        const vec4 q = normalize( vec4( unpackSnorm2x16( modelWords[base + 4] ), unpackSnorm2x16( modelWords[base + 5] ) ) );
+
+        const vec3 v = _pos * posScale.w;
+        return v + 2.0 * cross( q.xyz, cross( q.xyz, v ) + q.w * v ) + posScale.xyz;
+    }
+    else
+    {
+        const uint base = _index * 16;
+        const mat4 model = mat4( loadVec4( base ), loadVec4( base + 4 ), loadVec4( base + 8 ), loadVec4( base + 12 ) );
+        return ( model * vec4( _pos, 1.0 ) ).xyz;
+    }
+}
+
+uint fetchIndex( DrawRecord _record, uint _position )
+{
+    if ( _record.indexSize == 2 )
+    {
+        // Two per word, the first in the low half
+        const uint word = _record.indices.words[_position >> 1];
+        return ( _position & 1 ) != 0 ? word >> 16 : word & 0xFFFF;
+    }
+
+    return _record.indices.words[_position];
+}
+
+void main()
+{
+    const uint modelIndex = gl_InstanceIndex;
+    const DrawRecord record = records[modelIndex];
+
+    // Engine::Vertex: half float position padded to four halves, then RGBA8 color
+    const uint base = fetchIndex( record, gl_VertexIndex ) * record.vertexStride;
+    const vec2 xy = unpackHalf2x16( record.vertices.words[base] );
+    const float z = unpackHalf2x16( record.vertices.words[base + 1] ).x;
+    const vec3 color = unpackUnorm4x8( record.vertices.words[base + 2] ).rgb;
+    const vec3 position = vec3( xy, z ) * record.positionFrame.w + record.positionFrame.xyz;
+
+    gl_Position = camera.proj * camera.view * vec4( toWorld( modelIndex, position ), 1.0 );
+    fragColor = color;
+}
@@ -0,0 +1,106 @@
+#include "Hash.h"
+
+#include <bit>
+#include <cstring>
+
+namespace Utils
+{
+	namespace {
+		constexpr u64 PRIME_1 = 0x9E3779B185EBCA87ull;
+		constexpr u64 PRIME_2 = 0xC2B2AE3D27D4EB4Full;
+		constexpr u64 PRIME_3 = 0x165667B19E3779F9ull;
+		constexpr u64 PRIME_4 = 0x85EBCA77C2B2AE63ull;
+		constexpr u64 PRIME_5 = 0x27D4EB2F165667C5ull;
+
+		//--------------------------------------------------------------------
+		u64 Read64( const std::byte* _p )
+		{
+			// Blobs have no alignment guarantee
+			u64 value;
+			std::memcpy( &value, _p, sizeof( value ) );
+			return value;
+		}
+
+		//--------------------------------------------------------------------
+		u32 Read32( const std::byte* _p )
+		{
+			u32 value;
+			std::memcpy( &value, _p, sizeof( value ) );
+			return value;
+		}
+
+		//--------------------------------------------------------------------
+		u64 Round( u64 _acc, u64 _input )
+		{
+			_acc += _input * PRIME_2;
+			_acc = std::rotl( _acc, 31 );
+			return _acc * PRIME_1;
+		}
+
+		//--------------------------------------------------------------------
+		u64 MergeRound( u64 _acc, u64 _lane )
+		{
+			_acc ^= Round( 0, _lane );
+			return _acc * PRIME_1 + PRIME_4;
+		}
+	} // end anonymous namespace
+
+	//--------------------------------------------------------------------
+	u64 Hash::Bytes( std::span<const std::byte> _bytes, u64 _seed /*= 0*/ )
+	{
+		const std::byte* p = _bytes.data();
+		const std::byte* const pEnd = p + _bytes.size();
+
+		u64 hash;
+		if ( _bytes.size() >= 32 )
+		{
+			// Four independent lanes of 8 bytes, the loop is bound by memory bandwidth rather than multiply latency
+			u64 lanes[4] = { _seed + PRIME_1 + PRIME_2, _seed + PRIME_2, _seed, _seed - PRIME_1 };
+			for ( ; pEnd - p >= 32; p += 32 )
+			{
+				lanes[0] = Round( lanes[0], Read64( p ) );
+				lanes[1] = Round( lanes[1], Read64( p + 8 ) );
+				lanes[2] = Round( lanes[2], Read64( p + 16 ) );
+				lanes[3] = Round( lanes[3], Read64( p + 24 ) );
+			}
+
+			hash = std::rotl( lanes[0], 1 ) + std::rotl( lanes[1], 7 ) + std::rotl( lanes[2], 12 ) + std::rotl( lanes[3], 18 );
+			for ( u64 lane : lanes )
+			{
+				hash = MergeRound( hash, lane );
+			}
+		}
+		else
+		{
+			hash = _seed + PRIME_5;
+		}
+
+		hash += static_cast<u64>( _bytes.size() );
+
+		// Tail, 8 then 4 then 1 byte at a time
+		for ( ; pEnd - p >= 8; p += 8 )
+		{
+			hash ^= Round( 0, Read64( p ) );
+			hash = std::rotl( hash, 27 ) * PRIME_1 + PRIME_4;
+		}
+		if ( pEnd - p >= 4 )
+		{
+			hash ^= u64( Read32( p ) ) * PRIME_1;
+			hash = std::rotl( hash, 23 ) * PRIME_2 + PRIME_3;
+			p += 4;
+		}
+		for ( ; p < pEnd; p++ )
+		{
+			hash ^= u64( std::to_integer<u8>( *p ) ) * PRIME_5;
+			hash = std::rotl( hash, 11 ) * PRIME_1;
+		}
+
+		// Avalanche
+		hash ^= hash >> 33;
+		hash *= PRIME_2;
+		hash ^= hash >> 29;
+		hash *= PRIME_3;
+		hash ^= hash >> 32;
+		return hash;
+	}
+} // end namespace Utils
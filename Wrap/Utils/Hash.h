@@ -0,0 +1,25 @@
+#pragma once
+
+#include <span>
+#include <type_traits>
+
+#include "Common.h"
+
+namespace Utils
+{
+	// 64-bit non-cryptographic hash of byte blobs (the xxHash64 algorithm), fast enough to run over whole vertex and index buffers.
+	// For content addressing, not persisted: the values may change between versions
+	class Hash
+	{
+	public:
+		static u64 Bytes( std::span<const std::byte> _bytes, u64 _seed = 0 );
+
+		// Padding bytes are indeterminate, only types without any may be hashed by value
+		template<typename T>
+		static u64 Span( std::span<const T> _values, u64 _seed = 0 )
+		{
+			static_assert( std::is_trivially_copyable_v<T>, "Hashed types must be trivially copyable" );
+			return Bytes( std::as_bytes( _values ), _seed );
+		}
+	};
+} // end namespace Utils
@@ -0,0 +1,251 @@
+#include "JobSystem.h"
+
+namespace Utils {
+
+	namespace {
+		// Failed searches before an idle worker goes to sleep
+		constexpr u32 IDLE_SPIN_COUNT = 64;
+
+		thread_local const JobSystem* t_pSystem = nullptr;
+		thread_local u32 t_WorkerIndex = JobSystem::NOT_A_WORKER;
+
+		u32 currentWorker( const JobSystem* _pSystem )
+		{
+			return t_pSystem == _pSystem ? t_WorkerIndex : JobSystem::NOT_A_WORKER;
+		}
+	} // end anonymous namespace
+
+	//--------------------------------------------------------------------
+	JobSystem& JobSystem::Instance()
+	{
+		// The threads submitting work help in wait(), one core is left for them. 0 means the count is unknown
+		const u32 cores = std::thread::hardware_concurrency();
+		static JobSystem system( cores > 1 ? cores - 1 : 1 );
+		return system;
+	}
+
+	//--------------------------------------------------------------------
+	JobSystem::JobSystem( u32 _workerCount )
+	{
+		m_Workers.reserve( _workerCount );
+		for ( u32 i = 0; i < _workerCount; i++ )
+		{
+			m_Workers.push_back( std::make_unique<Worker>() );
+		}
+
+		// Started once every deque exists, workers steal from each other right away
+		for ( u32 i = 0; i < _workerCount; i++ )
+		{
+			m_Workers[i]->m_Thread = std::jthread( [this, i]( std::stop_token _stop ) { workerLoop( _stop, i ); } );
+		}
+	}
+
+	//--------------------------------------------------------------------
+	JobSystem::~JobSystem()
+	{
+		for ( auto& pWorker : m_Workers )
+		{
+			pWorker->m_Thread.request_stop();
+		}
+
+		m_WorkEpoch.fetch_add( 1 );
+		m_WorkEpoch.notify_all();
+
+		for ( auto& pWorker : m_Workers )
+		{
+			pWorker->m_Thread.join();
+		}
+
+		// Whatever was never picked up is dropped, nothing can wait on it any more
+		for ( Job* pJob : m_Injected )
+		{
+			delete pJob;
+		}
+	}
+
+	//--------------------------------------------------------------------
+	void JobSystem::run( JobFunction&& _function, JobCounter* _pCounter /*= nullptr*/ )
+	{
+		if ( _pCounter )
+		{
+			_pCounter->m_Pending.fetch_add( 1, std::memory_order_relaxed );
+		}
+
+		schedule( new Job{ .m_Function = std::move( _function ), .m_pCounter = _pCounter } );
+	}
+
+	//--------------------------------------------------------------------
+	void JobSystem::runAfter( JobCounter& _dependency, JobFunction&& _function, JobCounter* _pCounter /*= nullptr*/ )
+	{
+		if ( _pCounter )
+		{
+			_pCounter->m_Pending.fetch_add( 1, std::memory_order_relaxed );
+		}
+
+		Job* pJob = new Job{ .m_Function = std::move( _function ), .m_pCounter = _pCounter };
+
+		{
+			// finish() decrements under the same lock, the dependency cannot complete between the check and the push
+			std::lock_guard<std::mutex> guard( _dependency.m_Mutex );
+			if ( _dependency.m_Pending.load( std::memory_order_acquire ) > 0 )
+			{
+				_dependency.m_Continuations.push_back( pJob );
+				return;
+			}
+		}
+
+		schedule( pJob );
+	}
+
+	//--------------------------------------------------------------------
+	void JobSystem::wait( const JobCounter& _counter )
+	{
+		const u32 self = currentWorker( this );
+
+		while ( !_counter.isDone() )
+		{
+			if ( Job* pJob = findJob( self ) )
+			{
+				execute( pJob );
+			}
+			else
+			{
+				// The remaining jobs are running elsewhere
+				std::this_thread::yield();
+			}
+		}
+
+		// The thread that finished the last job may still be releasing continuations under the lock
+		std::lock_guard<std::mutex> guard( _counter.m_Mutex );
+	}
+
+	//--------------------------------------------------------------------
+	void JobSystem::schedule( Job* _pJob )
+	{
+		const u32 self = currentWorker( this );
+
+		if ( self == NOT_A_WORKER || !m_Workers[self]->m_Deque.push( _pJob ) )
+		{
+			std::lock_guard<std::mutex> guard( m_InjectedMutex );
+			m_Injected.push_back( _pJob );
+			m_InjectedCount.fetch_add( 1, std::memory_order_release );
+		}
+
+		m_WorkEpoch.fetch_add( 1 );
+		if ( m_Sleeping.load() > 0 )
+		{
+			m_WorkEpoch.notify_one();
+		}
+	}
+
+	//--------------------------------------------------------------------
+	void JobSystem::execute( Job* _pJob )
+	{
+		_pJob->m_Function();
+
+		if ( _pJob->m_pCounter )
+		{
+			finish( *_pJob->m_pCounter );
+		}
+
+		delete _pJob;
+	}
+
+	//--------------------------------------------------------------------
+	void JobSystem::finish( JobCounter& _counter )
+	{
+		std::vector<void*> released;
+		{
+			std::lock_guard<std::mutex> guard( _counter.m_Mutex );
+			if ( _counter.m_Pending.fetch_sub( 1, std::memory_order_acq_rel ) == 1 )
+			{
+				released.swap( _counter.m_Continuations );
+			}
+		}
+
+		for ( void* pJob : released )
+		{
+			schedule( static_cast<Job*>( pJob ) );
+		}
+	}
+
+	//--------------------------------------------------------------------
+	JobSystem::Job* JobSystem::findJob( u32 _self )
+	{
+		// Own deque first, its newest jobs are the most likely to be in cache
+		if ( _self != NOT_A_WORKER )
+		{
+			if ( auto job = m_Workers[_self]->m_Deque.pop() )
+				return *job;
+		}
+
+		if ( m_InjectedCount.load( std::memory_order_acquire ) > 0 )
+		{
+			std::lock_guard<std::mutex> guard( m_InjectedMutex );
+			if ( !m_Injected.empty() )
+			{
+				Job* pJob = m_Injected.front();
+				m_Injected.pop_front();
+				m_InjectedCount.fetch_sub( 1, std::memory_order_relaxed );
+				return pJob;
+			}
+		}
+
+		// Start next to ourselves so thieves spread over the victims
+		const u32 workerCount = getWorkerCount();
+		const u32 first = _self != NOT_A_WORKER ? _self + 1 : 0;
+		for ( u32 i = 0; i < workerCount; i++ )
+		{
+			const u32 victim = ( first + i ) % workerCount;
+			if ( victim == _self )
+				continue;
+
+			if ( auto job = m_Workers[victim]->m_Deque.steal() )
+				return *job;
+		}
+
+		return nullptr;
+	}
+
+	//--------------------------------------------------------------------
+	void JobSystem::workerLoop( std::stop_token _stop, u32 _index )
+	{
+		t_pSystem = this;
+		t_WorkerIndex = _index;
+
+		u32 idleCount = 0;
+		while ( !_stop.stop_requested() )
+		{
+			if ( Job* pJob = findJob( _index ) )
+			{
+				execute( pJob );
+				idleCount = 0;
+				continue;
+			}
+
+			if ( ++idleCount < IDLE_SPIN_COUNT )
+			{
+				std::this_thread::yield();
+				continue;
+			}
+
+			// Read the epoch before the last search: a job submitted after it changes the epoch and the wait returns at once
+			const u32 epoch = m_WorkEpoch.load();
+			if ( Job* pJob = findJob( _index ) )
+			{
+				execute( pJob );
+				idleCount = 0;
+				continue;
+			}
+
+			m_Sleeping.fetch_add( 1 );
+			if ( !_stop.stop_requested() )
+			{
+				m_WorkEpoch.wait( epoch );
+			}
+			m_Sleeping.fetch_sub( 1 );
+			idleCount = 0;
+		}
+	}
+
+} // end namespace Utils
@@ -0,0 +1,125 @@
+#pragma once
+
+#include "Common.h"
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+#include "WorkStealingDeque.h"
+
+namespace Utils {
+
+	class JobSystem;
+
+	// Number of unfinished jobs tied to it. Reaching zero releases the jobs queued behind it with runAfter().
+	// Must outlive its jobs, which wait() guarantees.
+	class JobCounter
+	{
+	public:
+		JobCounter() = default;
+
+		JobCounter( const JobCounter& ) = delete;
+		JobCounter& operator=( const JobCounter& ) = delete;
+
+		bool isDone() const { return m_Pending.load( std::memory_order_acquire ) == 0; };
+
+	private:
+		friend class JobSystem;
+
+		std::atomic<u32> m_Pending{ 0 };
+
+		// Held while the last job finishes, so the counter is not released under a finishing thread
+		mutable std::mutex m_Mutex;
+		std::vector<void*> m_Continuations;
+	};
+
+	// Work-stealing scheduler: one worker per core but one, each with its own Chase-Lev deque.
+	// Workers run their own newest jobs first and steal the oldest jobs of others when idle.
+	// Threads outside the pool submit through a shared queue and help instead of blocking in wait().
+	class JobSystem
+	{
+	public:
+		using JobFunction = std::function<void()>;
+
+		static constexpr u32 NOT_A_WORKER = ~0u;
+
+		// Shared scheduler, workers start on first use
+		static JobSystem& Instance();
+
+		explicit JobSystem( u32 _workerCount );
+		~JobSystem();
+
+		JobSystem( const JobSystem& ) = delete;
+		JobSystem& operator=( const JobSystem& ) = delete;
+
+		// _pCounter, if any, is incremented now and decremented once the job has run
+		void run( JobFunction&& _function, JobCounter* _pCounter = nullptr );
+		// Scheduled once _dependency reaches zero, immediately if it already has
+		void runAfter( JobCounter& _dependency, JobFunction&& _function, JobCounter* _pCounter = nullptr );
+
+		// Runs pending jobs on the calling thread until _counter reaches zero, callable from any thread
+		void wait( const JobCounter& _counter );
+
+		// Calls _body( begin, end ) over [0, _count) in chunks of _grainSize, the caller takes part and returns when all are done
+		template<typename F>
+		void parallelFor( u32 _count, u32 _grainSize, F&& _body );
+
+		u32 getWorkerCount() const { return static_cast<u32>( m_Workers.size() ); };
+
+	private:
+		struct Job {
+			JobFunction m_Function;
+			JobCounter* m_pCounter;
+		};
+
+		struct Worker {
+			WorkStealingDeque<Job*, 4096> m_Deque;
+			std::jthread m_Thread;
+		};
+
+		void schedule( Job* _pJob );
+		void execute( Job* _pJob );
+		void finish( JobCounter& _counter );
+		Job* findJob( u32 _self );
+		void workerLoop( std::stop_token _stop, u32 _index );
+
+		std::vector<std::unique_ptr<Worker>> m_Workers;
+
+		// Jobs submitted from threads outside the pool, and overflow of full deques
+		std::mutex m_InjectedMutex;
+		std::deque<Job*> m_Injected;
+		std::atomic<u32> m_InjectedCount{ 0 };
+
+		// Bumped on every submission, idle workers sleep on it
+		std::atomic<u32> m_WorkEpoch{ 0 };
+		std::atomic<u32> m_Sleeping{ 0 };
+	};
+
+	//--------------------------------------------------------------------
+	template<typename F>
+	void JobSystem::parallelFor( u32 _count, u32 _grainSize, F&& _body )
+	{
+		const u32 grain = std::max( 1u, _grainSize );
+
+		if ( _count <= grain || m_Workers.empty() )
+		{
+			if ( _count > 0 )
+				_body( 0u, _count );
+			return;
+		}
+
+		// The body outlives every chunk, wait() below does not return before they are done
+		JobCounter counter;
+		for ( u32 begin = grain; begin < _count; begin += grain )
+		{
+			const u32 end = std::min( _count, begin + grain );
+			run( [&_body, begin, end]() { _body( begin, end ); }, &counter );
+		}
+
+		// First chunk on the calling thread, it would only sit waiting otherwise
+		_body( 0u, grain );
+		wait( counter );
+	}
+
+} // end namespace Utils
@@ -0,0 +1,287 @@
+#include "Json.h"
+
+#include <charconv>
+
+namespace Utils {
+
+	namespace {
+		// Guards against stack overflow on hostile input, real documents stay far below
+		constexpr u32 MAX_DEPTH = 256;
+
+		const JsonValue NULL_VALUE{};
+
+		//--------------------------------------------------------------------
+		void AppendUtf8( std::string& _out, u32 _codePoint )
+		{
+			if ( _codePoint < 0x80 )
+			{
+				_out += static_cast<char>( _codePoint );
+			}
+			else if ( _codePoint < 0x800 )
+			{
+				_out += static_cast<char>( 0xC0 | ( _codePoint >> 6 ) );
+				_out += static_cast<char>( 0x80 | ( _codePoint & 0x3F ) );
+			}
+			else if ( _codePoint < 0x10000 )
+			{
+				_out += static_cast<char>( 0xE0 | ( _codePoint >> 12 ) );
+				_out += static_cast<char>( 0x80 | ( ( _codePoint >> 6 ) & 0x3F ) );
+				_out += static_cast<char>( 0x80 | ( _codePoint & 0x3F ) );
+			}
+			else
+			{
+				_out += static_cast<char>( 0xF0 | ( _codePoint >> 18 ) );
+				_out += static_cast<char>( 0x80 | ( ( _codePoint >> 12 ) & 0x3F ) );
+				_out += static_cast<char>( 0x80 | ( ( _codePoint >> 6 ) & 0x3F ) );
+				_out += static_cast<char>( 0x80 | ( _codePoint & 0x3F ) );
+			}
+		}
+	} // end anonymous namespace
+
+	// Recursive descent over the whole text, every parse function leaves m_Pos after what it consumed
+	class JsonParser
+	{
+	public:
+		explicit JsonParser( std::string_view _text ) : m_Text( _text ) {};
+
+		//--------------------------------------------------------------------
+		bool parseDocument( JsonValue& _out )
+		{
+			if ( !parseValue( _out, 0 ) )
+				return false;
+
+			skipWhitespace();
+			return m_Pos == m_Text.size();
+		}
+
+	private:
+		//--------------------------------------------------------------------
+		void skipWhitespace()
+		{
+			while ( m_Pos < m_Text.size() && ( m_Text[m_Pos] == ' ' || m_Text[m_Pos] == '\t' || m_Text[m_Pos] == '\n' || m_Text[m_Pos] == '\r' ) )
+			{
+				m_Pos++;
+			}
+		}
+
+		//--------------------------------------------------------------------
+		bool consume( char _c )
+		{
+			skipWhitespace();
+			if ( m_Pos < m_Text.size() && m_Text[m_Pos] == _c )
+			{
+				m_Pos++;
+				return true;
+			}
+			return false;
+		}
+
+		//--------------------------------------------------------------------
+		bool consumeLiteral( std::string_view _literal )
+		{
+			if ( m_Text.substr( m_Pos, _literal.size() ) != _literal )
+				return false;
+
+			m_Pos += _literal.size();
+			return true;
+		}
+
+		//--------------------------------------------------------------------
+		bool parseValue( JsonValue& _out, u32 _depth )
+		{
+			if ( _depth > MAX_DEPTH )
+				return false;
+
+			skipWhitespace();
+			if ( m_Pos >= m_Text.size() )
+				return false;
+
+			switch ( m_Text[m_Pos] )
+			{
+			case '{':
+				return parseObject( _out, _depth );
+			case '[':
+				return parseArray( _out, _depth );
+			case '"':
+				_out.m_Type = JsonValue::Type::STRING;
+				return parseString( _out.m_String );
+			case 't':
+				_out.m_Type = JsonValue::Type::BOOLEAN;
+				_out.m_Bool = true;
+				return consumeLiteral( "true" );
+			case 'f':
+				_out.m_Type = JsonValue::Type::BOOLEAN;
+				_out.m_Bool = false;
+				return consumeLiteral( "false" );
+			case 'n':
+				_out.m_Type = JsonValue::Type::NUL;
+				return consumeLiteral( "null" );
+			default:
+				return parseNumber( _out );
+			}
+		}
+
+		//--------------------------------------------------------------------
+		bool parseObject( JsonValue& _out, u32 _depth )
+		{
+			_out.m_Type = JsonValue::Type::OBJECT;
+			m_Pos++;
+
+			if ( consume( '}' ) )
+				return true;
+
+			do
+			{
+				skipWhitespace();
+				std::string key;
+				if ( !parseString( key ) || !consume( ':' ) )
+					return false;
+
+				JsonValue value;
+				if ( !parseValue( value, _depth + 1 ) )
+					return false;
+
+				_out.m_Members.emplace_back( std::move( key ), std::move( value ) );
+			} while ( consume( ',' ) );
+
+			return consume( '}' );
+		}
+
+		//--------------------------------------------------------------------
+		bool parseArray( JsonValue& _out, u32 _depth )
+		{
+			_out.m_Type = JsonValue::Type::ARRAY;
+			m_Pos++;
+
+			if ( consume( ']' ) )
+				return true;
+
+			do
+			{
+				if ( !parseValue( _out.m_Elements.emplace_back(), _depth + 1 ) )
+					return false;
+			} while ( consume( ',' ) );
+
+			return consume( ']' );
+		}
+
+		//--------------------------------------------------------------------
+		bool parseHex4( u32& _out )
+		{
+			if ( m_Pos + 4 > m_Text.size() )
+				return false;
+
+			const char* pBegin = m_Text.data() + m_Pos;
+			const auto [pEnd, error] = std::from_chars( pBegin, pBegin + 4, _out, 16 );
+			if ( error != std::errc() || pEnd != pBegin + 4 )
+				return false;
+
+			m_Pos += 4;
+			return true;
+		}
+
+		//--------------------------------------------------------------------
+		bool parseString( std::string& _out )
+		{
+			if ( m_Pos >= m_Text.size() || m_Text[m_Pos] != '"' )
+				return false;
+			m_Pos++;
+
+			while ( m_Pos < m_Text.size() )
+			{
+				const char c = m_Text[m_Pos++];
+				if ( c == '"' )
+					return true;
+
+				if ( c != '\\' )
+				{
+					_out += c;
+					continue;
+				}
+
+				if ( m_Pos >= m_Text.size() )
+					return false;
+
+				switch ( m_Text[m_Pos++] )
+				{
+				case '"': _out += '"'; break;
+				case '\\': _out += '\\'; break;
+				case '/': _out += '/'; break;
+				case 'b': _out += '\b'; break;
+				case 'f': _out += '\f'; break;
+				case 'n': _out += '\n'; break;
+				case 'r': _out += '\r'; break;
+				case 't': _out += '\t'; break;
+				case 'u':
+				{
+					u32 codePoint;
+					if ( !parseHex4( codePoint ) )
+						return false;
+
+					// Characters outside the BMP come as a surrogate pair
+					if ( codePoint >= 0xD800 && codePoint < 0xDC00 )
+					{
+						u32 low;
+						if ( !consumeLiteral( "\\u" ) || !parseHex4( low ) || low < 0xDC00 || low >= 0xE000 )
+							return false;
+						codePoint = 0x10000 + ( ( codePoint - 0xD800 ) << 10 ) + ( low - 0xDC00 );
+					}
+
+					AppendUtf8( _out, codePoint );
+					break;
+				}
+				default:
+					return false;
+				}
+			}
+
+			return false;
+		}
+
+		//--------------------------------------------------------------------
+		bool parseNumber( JsonValue& _out )
+		{
+			_out.m_Type = JsonValue::Type::NUMBER;
+
+			const char* pBegin = m_Text.data() + m_Pos;
+			const auto [pEnd, error] = std::from_chars( pBegin, m_Text.data() + m_Text.size(), _out.m_Number );
+			if ( error != std::errc() )
+				return false;
+
+			m_Pos += pEnd - pBegin;
+			return true;
+		}
+
+		std::string_view m_Text;
+		size_t m_Pos{ 0 };
+	};
+
+	//--------------------------------------------------------------------
+	std::optional<JsonValue> JsonValue::parse( std::string_view _text )
+	{
+		JsonValue root;
+		if ( !JsonParser( _text ).parseDocument( root ) )
+			return std::nullopt;
+
+		return root;
+	}
+
+	//--------------------------------------------------------------------
+	const JsonValue& JsonValue::operator[]( std::string_view _key ) const
+	{
+		for ( const auto& [key, value] : m_Members )
+		{
+			if ( key == _key )
+				return value;
+		}
+
+		return NULL_VALUE;
+	}
+
+	//--------------------------------------------------------------------
+	const JsonValue& JsonValue::operator[]( size_t _index ) const
+	{
+		return _index < m_Elements.size() ? m_Elements[_index] : NULL_VALUE;
+	}
+
+} // end namespace Utils
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "Common.h"
+#include <optional>
+#include <span>
+#include <string_view>
+
+namespace Utils {
+
+	// Read-only JSON document, enough for asset descriptions such as glTF.
+	// Lookups never fail: a missing key or index yields a null value, and the as* accessors fall back to their default.
+	class JsonValue
+	{
+	public:
+		enum class Type : u8 {
+			NUL,
+			BOOLEAN,
+			NUMBER,
+			STRING,
+			ARRAY,
+			OBJECT
+		};
+
+		// Empty on malformed input
+		static std::optional<JsonValue> parse( std::string_view _text );
+
+		Type getType() const { return m_Type; };
+		bool isNull() const { return m_Type == Type::NUL; };
+		bool isObject() const { return m_Type == Type::OBJECT; };
+		bool isArray() const { return m_Type == Type::ARRAY; };
+
+		bool asBool( bool _default = false ) const { return m_Type == Type::BOOLEAN ? m_Bool : _default; };
+		f64 asNumber( f64 _default = 0.0 ) const { return m_Type == Type::NUMBER ? m_Number : _default; };
+		u32 asU32( u32 _default = 0 ) const { return m_Type == Type::NUMBER && m_Number >= 0.0 ? static_cast<u32>( m_Number ) : _default; };
+		std::string_view asString( std::string_view _default = {} ) const { return m_Type == Type::STRING ? std::string_view( m_String ) : _default; };
+
+		bool contains( std::string_view _key ) const { return !( *this )[_key].isNull(); };
+		const JsonValue& operator[]( std::string_view _key ) const;
+		const JsonValue& operator[]( size_t _index ) const;
+
+		// Elements of an array, empty for any other type
+		std::span<const JsonValue> getElements() const { return m_Elements; };
+		size_t size() const { return m_Type == Type::OBJECT ? m_Members.size() : m_Elements.size(); };
+
+	private:
+		friend class JsonParser;
+
+		Type m_Type{ Type::NUL };
+		bool m_Bool{ false };
+		f64 m_Number{ 0.0 };
+		std::string m_String;
+		std::vector<JsonValue> m_Elements;
+		// Documents are small, a linear search beats hashing here
+		std::vector<std::pair<std::string, JsonValue>> m_Members;
+	};
+
+} // end namespace Utils
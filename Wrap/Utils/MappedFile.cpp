@@ -0,0 +1,113 @@
+#include "MappedFile.h"
+
+#include <utility>
+
+#include "Windows.h"
+
+//------------------------------------------------------------------------------------
+MappedFile::MappedFile( const std::filesystem::path& _path )
+{
+	open( _path );
+}
+
+//------------------------------------------------------------------------------------
+MappedFile::~MappedFile()
+{
+	close();
+}
+
+//------------------------------------------------------------------------------------
+MappedFile::MappedFile( MappedFile&& _other ) noexcept
+{
+	*this = std::move( _other );
+}
+
+//------------------------------------------------------------------------------------
+MappedFile& MappedFile::operator=( MappedFile&& _other ) noexcept
+{
+	if ( this != &_other )
+	{
+		close();
+
+		m_pData = std::exchange( _other.m_pData, nullptr );
+		m_Size = std::exchange( _other.m_Size, 0 );
+		m_FileHandle = std::exchange( _other.m_FileHandle, nullptr );
+		m_MappingHandle = std::exchange( _other.m_MappingHandle, nullptr );
+	}
+
+	return *this;
+}
+
+//------------------------------------------------------------------------------------
+bool MappedFile::open( const std::filesystem::path& _path )
+{
+	close();
+
+	HANDLE hFile{ CreateFileW(
+		_path.wstring().c_str(),
+		GENERIC_READ,
+		FILE_SHARE_READ,
+		nullptr,
+		OPEN_EXISTING,
+		FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN,
+		nullptr
+	) };
+
+	if ( hFile == INVALID_HANDLE_VALUE )
+	{
+		return false;
+	}
+
+	LARGE_INTEGER fileSize;
+	if ( !GetFileSizeEx( hFile, &fileSize ) || fileSize.QuadPart == 0 )
+	{
+		CloseHandle( hFile );
+		return false;
+	}
+
+	HANDLE hMapping{ CreateFileMappingW( hFile, nullptr, PAGE_READONLY, 0, 0, nullptr ) };
+	if ( hMapping == nullptr )
+	{
+		CloseHandle( hFile );
+		return false;
+	}
+
+	void* pView = MapViewOfFile( hMapping, FILE_MAP_READ, 0, 0, 0 );
+	if ( pView == nullptr )
+	{
+		CloseHandle( hMapping );
+		CloseHandle( hFile );
+		return false;
+	}
+
+	m_FileHandle = hFile;
+	m_MappingHandle = hMapping;
+	m_pData = static_cast<const std::byte*>( pView );
+	m_Size = static_cast<size_t>( fileSize.QuadPart );
+
+	return true;
+}
+
+//------------------------------------------------------------------------------------
+void MappedFile::close()
+{
+	if ( m_pData )
+	{
+		UnmapViewOfFile( m_pData );
+		m_pData = nullptr;
+	}
+
+	if ( m_MappingHandle )
+	{
+		CloseHandle( m_MappingHandle );
+		m_MappingHandle = nullptr;
+	}
+
+	if ( m_FileHandle )
+	{
+		CloseHandle( m_FileHandle );
+		m_FileHandle = nullptr;
+	}
+
+	m_Size = 0;
+}
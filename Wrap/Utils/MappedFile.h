@@ -0,0 +1,35 @@
+#pragma once
+
+#include <filesystem>
+#include <span>
+
+#include "Common.h"
+
+// Read-only view of a whole file mapped into the address space, the OS pages it in on demand
+class MappedFile {
+
+public:
+	MappedFile() = default;
+	explicit MappedFile( const std::filesystem::path& _path );
+	~MappedFile();
+
+	MappedFile( const MappedFile& ) = delete;
+	MappedFile& operator=( const MappedFile& ) = delete;
+	MappedFile( MappedFile&& _other ) noexcept;
+	MappedFile& operator=( MappedFile&& _other ) noexcept;
+
+	bool open( const std::filesystem::path& _path );
+	void close();
+
+	bool isOpen() const { return m_pData != nullptr; };
+	const std::byte* data() const { return m_pData; };
+	size_t size() const { return m_Size; };
+	std::span<const std::byte> bytes() const { return { m_pData, m_Size }; };
+
+private:
+	const std::byte* m_pData{ nullptr };
+	size_t m_Size{ 0 };
+
+	void* m_FileHandle{ nullptr };
+	void* m_MappingHandle{ nullptr };
+};
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "Common.h"
+#include <atomic>
+#include <optional>
+
+namespace Utils {
+
+	// Unbounded multi-producer / single-consumer queue (Vyukov's intrusive list, with a stub node).
+	// push() is wait-free and callable from any thread, pop() belongs to one consumer thread.
+	template<typename T>
+	class MpscQueue
+	{
+	public:
+		MpscQueue();
+		~MpscQueue();
+
+		MpscQueue( const MpscQueue& ) = delete;
+		MpscQueue& operator=( const MpscQueue& ) = delete;
+
+		void push( T&& _value );
+
+		// Empty if nothing is queued, or if a producer is midway through linking its node
+		std::optional<T> pop();
+
+	private:
+		struct Node {
+			std::atomic<Node*> m_pNext{ nullptr };
+			std::optional<T> m_Value;
+		};
+
+		// Producers swap themselves in at the head, the consumer walks from the tail
+		alignas( 64 ) std::atomic<Node*> m_pHead;
+		alignas( 64 ) Node* m_pTail;
+	};
+
+	//--------------------------------------------------------------------
+	template<typename T>
+	MpscQueue<T>::MpscQueue()
+	{
+		Node* pStub = new Node();
+		m_pHead.store( pStub, std::memory_order_relaxed );
+		m_pTail = pStub;
+	}
+
+	//--------------------------------------------------------------------
+	template<typename T>
+	MpscQueue<T>::~MpscQueue()
+	{
+		while ( pop() ) {}
+		delete m_pTail;
+	}
+
+	//--------------------------------------------------------------------
+	template<typename T>
+	void MpscQueue<T>::push( T&& _value )
+	{
+		Node* pNode = new Node();
+		pNode->m_Value.emplace( std::move( _value ) );
+
+		Node* pPrev = m_pHead.exchange( pNode, std::memory_order_acq_rel );
+		pPrev->m_pNext.store( pNode, std::memory_order_release );
+	}
+
+	//--------------------------------------------------------------------
+	template<typename T>
+	std::optional<T> MpscQueue<T>::pop()
+	{
+		Node* pNext = m_pTail->m_pNext.load( std::memory_order_acquire );
+		if ( pNext == nullptr )
+			return std::nullopt;
+
+		// pNext becomes the new stub, its value moves out
+		std::optional<T> value = std::move( pNext->m_Value );
+		pNext->m_Value.reset();
+
+		delete m_pTail;
+		m_pTail = pNext;
+
+		return value;
+	}
+
+} // end namespace Utils
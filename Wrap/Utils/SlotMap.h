@@ -0,0 +1,193 @@
+#pragma once
+
+#include <span>
+
+#include "Common.h"
+
+namespace Utils
+{
+	// Index into the slot table plus the generation the slot had when the handle was issued.
+	// A slot's generation is bumped every time it is freed, so stale handles never alias a new element
+	struct SlotHandle
+	{
+		static constexpr u32 INVALID_INDEX = ~0u;
+
+		u32 m_Index{ INVALID_INDEX };
+		u32 m_Generation{ 0 };
+
+		constexpr bool isNull() const { return m_Index == INVALID_INDEX; };
+		constexpr bool operator==( const SlotHandle& _other ) const = default;
+	};
+
+	// Generational slot map: O(1) insert, erase and lookup, values kept densely packed for iteration.
+	// Erasing swaps the last value into the hole, so dense indices are not stable across erases, handles are
+	template<typename T>
+	class SlotMap
+	{
+	public:
+		template<typename... Args>
+		SlotHandle emplace( Args&&... _args );
+		SlotHandle insert( const T& _value ) { return emplace( _value ); };
+
+		bool erase( SlotHandle _handle );
+		void clear();
+		void reserve( size_t _capacity );
+
+		bool contains( SlotHandle _handle ) const { return findDenseIndex( _handle ) != SlotHandle::INVALID_INDEX; };
+
+		T* get( SlotHandle _handle );
+		const T* get( SlotHandle _handle ) const;
+
+		// Position of the value in values(), INVALID_INDEX if the handle is stale
+		u32 findDenseIndex( SlotHandle _handle ) const;
+		SlotHandle handleAt( size_t _denseIndex ) const;
+
+		size_t size() const { return m_Dense.size(); };
+		bool empty() const { return m_Dense.empty(); };
+
+		std::span<T> values() { return m_Dense; };
+		std::span<const T> values() const { return m_Dense; };
+
+		auto begin() { return m_Dense.begin(); };
+		auto end() { return m_Dense.end(); };
+		auto begin() const { return m_Dense.begin(); };
+		auto end() const { return m_Dense.end(); };
+
+	private:
+		struct Slot
+		{
+			// Dense index while alive, next free slot while on the free list
+			u32 m_DenseOrNextFree;
+			u32 m_Generation;
+		};
+
+		std::vector<Slot> m_Slots;
+		std::vector<T> m_Dense;
+		std::vector<u32> m_DenseToSlot;
+
+		u32 m_FreeHead{ SlotHandle::INVALID_INDEX };
+	};
+
+	//------------------------------------------------------------------------------------
+	template<typename T>
+	template<typename... Args>
+	SlotHandle SlotMap<T>::emplace( Args&&... _args )
+	{
+		u32 slotIdx;
+		if ( m_FreeHead != SlotHandle::INVALID_INDEX )
+		{
+			slotIdx = m_FreeHead;
+			m_FreeHead = m_Slots[slotIdx].m_DenseOrNextFree;
+		}
+		else
+		{
+			slotIdx = static_cast<u32>( m_Slots.size() );
+			m_Slots.push_back( Slot{ .m_DenseOrNextFree = 0, .m_Generation = 0 } );
+		}
+
+		m_Slots[slotIdx].m_DenseOrNextFree = static_cast<u32>( m_Dense.size() );
+		m_Dense.emplace_back( std::forward<Args>( _args )... );
+		m_DenseToSlot.push_back( slotIdx );
+
+		return SlotHandle{ .m_Index = slotIdx, .m_Generation = m_Slots[slotIdx].m_Generation };
+	}
+
+	//------------------------------------------------------------------------------------
+	template<typename T>
+	bool SlotMap<T>::erase( SlotHandle _handle )
+	{
+		const u32 denseIdx = findDenseIndex( _handle );
+		if ( denseIdx == SlotHandle::INVALID_INDEX )
+		{
+			return false;
+		}
+
+		const u32 lastIdx = static_cast<u32>( m_Dense.size() - 1 );
+		if ( denseIdx != lastIdx )
+		{
+			m_Dense[denseIdx] = std::move( m_Dense[lastIdx] );
+			m_DenseToSlot[denseIdx] = m_DenseToSlot[lastIdx];
+			m_Slots[m_DenseToSlot[denseIdx]].m_DenseOrNextFree = denseIdx;
+		}
+
+		m_Dense.pop_back();
+		m_DenseToSlot.pop_back();
+
+		Slot& slot = m_Slots[_handle.m_Index];
+		slot.m_Generation++;
+		slot.m_DenseOrNextFree = m_FreeHead;
+		m_FreeHead = _handle.m_Index;
+
+		return true;
+	}
+
+	//------------------------------------------------------------------------------------
+	template<typename T>
+	void SlotMap<T>::clear()
+	{
+		for ( const u32 slotIdx : m_DenseToSlot )
+		{
+			Slot& slot = m_Slots[slotIdx];
+			slot.m_Generation++;
+			slot.m_DenseOrNextFree = m_FreeHead;
+			m_FreeHead = slotIdx;
+		}
+
+		m_Dense.clear();
+		m_DenseToSlot.clear();
+	}
+
+	//------------------------------------------------------------------------------------
+	template<typename T>
+	void SlotMap<T>::reserve( size_t _capacity )
+	{
+		m_Slots.reserve( _capacity );
+		m_Dense.reserve( _capacity );
+		m_DenseToSlot.reserve( _capacity );
+	}
+
+	//------------------------------------------------------------------------------------
+	template<typename T>
+	T* SlotMap<T>::get( SlotHandle _handle )
+	{
+		const u32 denseIdx = findDenseIndex( _handle );
+		return denseIdx != SlotHandle::INVALID_INDEX ? &m_Dense[denseIdx] : nullptr;
+	}
+
+	//------------------------------------------------------------------------------------
+	template<typename T>
+	const T* SlotMap<T>::get( SlotHandle _handle ) const
+	{
+		const u32 denseIdx = findDenseIndex( _handle );
+		return denseIdx != SlotHandle::INVALID_INDEX ? &m_Dense[denseIdx] : nullptr;
+	}
+
+	//------------------------------------------------------------------------------------
+	template<typename T>
+	u32 SlotMap<T>::findDenseIndex( SlotHandle _handle ) const
+	{
+		if ( _handle.m_Index >= m_Slots.size() )
+		{
+			return SlotHandle::INVALID_INDEX;
+		}
+
+		const Slot& slot = m_Slots[_handle.m_Index];
+		if ( slot.m_Generation != _handle.m_Generation || slot.m_DenseOrNextFree >= m_Dense.size()
+			|| m_DenseToSlot[slot.m_DenseOrNextFree] != _handle.m_Index )
+		{
+			return SlotHandle::INVALID_INDEX;
+		}
+
+		return slot.m_DenseOrNextFree;
+	}
+
+	//------------------------------------------------------------------------------------
+	template<typename T>
+	SlotHandle SlotMap<T>::handleAt( size_t _denseIndex ) const
+	{
+		assert( _denseIndex < m_Dense.size() );
+		const u32 slotIdx = m_DenseToSlot[_denseIndex];
+		return SlotHandle{ .m_Index = slotIdx, .m_Generation = m_Slots[slotIdx].m_Generation };
+	}
+
+} // end namespace Utils
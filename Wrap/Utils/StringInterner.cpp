@@ -0,0 +1,36 @@
+#include "StringInterner.h"
+
+namespace Utils
+{
+	//------------------------------------------------------------------------------------
+	NameId StringInterner::intern( std::string_view _str )
+	{
+		if ( auto it = m_Ids.find( _str ); it != m_Ids.end() )
+		{
+			return it->second;
+		}
+
+		const NameId id = static_cast<NameId>( m_Strings.size() );
+		auto [it, inserted] = m_Ids.emplace( std::string( _str ), id );
+
+		// Node based map, the key's storage is stable for the lifetime of the interner
+		m_Strings.push_back( it->first );
+
+		return id;
+	}
+
+	//------------------------------------------------------------------------------------
+	NameId StringInterner::find( std::string_view _str ) const
+	{
+		auto it = m_Ids.find( _str );
+		return it != m_Ids.end() ? it->second : INVALID_NAME_ID;
+	}
+
+	//------------------------------------------------------------------------------------
+	std::string_view StringInterner::str( NameId _id ) const
+	{
+		assert( _id < m_Strings.size() );
+		return m_Strings[_id];
+	}
+
+} // end namespace Utils
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <unordered_map>
+#include <string_view>
+
+#include "Common.h"
+
+namespace Utils
+{
+	using NameId = u32;
+	constexpr NameId INVALID_NAME_ID = ~0u;
+
+	// Transparent hash so maps keyed by std::string can be queried with a string_view without allocating
+	struct StringHash
+	{
+		using is_transparent = void;
+
+		size_t operator()( std::string_view _str ) const { return std::hash<std::string_view>{}( _str ); };
+		size_t operator()( const std::string& _str ) const { return std::hash<std::string_view>{}( _str ); };
+		size_t operator()( const char* _str ) const { return std::hash<std::string_view>{}( _str ); };
+	};
+
+	template<typename T>
+	using StringMap = std::unordered_map<std::string, T, StringHash, std::equal_to<>>;
+
+	// Maps strings to compact ids, ids are dense and never reused
+	class StringInterner
+	{
+	public:
+		NameId intern( std::string_view _str );
+
+		// INVALID_NAME_ID if the string was never interned
+		NameId find( std::string_view _str ) const;
+		std::string_view str( NameId _id ) const;
+
+		size_t size() const { return m_Strings.size(); };
+
+	private:
+		StringMap<NameId> m_Ids;
+		std::vector<std::string_view> m_Strings;
+	};
+
+} // end namespace Utils
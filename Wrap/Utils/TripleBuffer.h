@@ -0,0 +1,48 @@
+#pragma once
+
+#include "Common.h"
+#include <atomic>
+
+namespace Utils {
+
+	// Single producer / single consumer hand-off of whole values without locks.
+	// The producer fills back() and publishes it, the consumer picks up the latest published value,
+	// intermediate values are skipped if the consumer is slower. Neither side ever waits.
+	template<typename T>
+	class TripleBuffer
+	{
+	public:
+		// Producer side
+		T& back() { return m_Buffers[m_BackIdx]; };
+
+		void publish()
+		{
+			// Hand the filled buffer over and take back whichever one sat in the middle
+			m_BackIdx = m_Middle.exchange( m_BackIdx | FRESH_BIT, std::memory_order_acq_rel ) & INDEX_MASK;
+		}
+
+		// Consumer side, returns true if a newer value than front() was picked up
+		bool acquire()
+		{
+			if ( ( m_Middle.load( std::memory_order_relaxed ) & FRESH_BIT ) == 0 )
+				return false;
+
+			m_FrontIdx = m_Middle.exchange( m_FrontIdx, std::memory_order_acq_rel ) & INDEX_MASK;
+			return true;
+		}
+
+		const T& front() const { return m_Buffers[m_FrontIdx]; };
+
+	private:
+		static constexpr u8 INDEX_MASK = 0x3;
+		static constexpr u8 FRESH_BIT = 0x4;
+
+		std::array<T, 3> m_Buffers{};
+
+		// Each index is only touched by its own side, the middle one is the only shared state
+		u8 m_BackIdx{ 0 };
+		u8 m_FrontIdx{ 1 };
+		std::atomic<u8> m_Middle{ 2 };
+	};
+
+} // end namespace Utils
@@ -0,0 +1,112 @@
+#pragma once
+
+#include "Common.h"
+#include <atomic>
+#include <bit>
+#include <optional>
+
+namespace Utils {
+
+	// Bounded Chase-Lev deque (the C11 formulation by Le, Pop, Cohen and Zappa Nardelli).
+	// The owner thread pushes and pops at the bottom (LIFO, cache-warm), any other thread steals from the top (FIFO).
+	// T is stored in atomics, so it must be trivially copyable, typically a pointer.
+	template<typename T, u32 Capacity>
+	class WorkStealingDeque
+	{
+		static_assert( std::has_single_bit( Capacity ), "Capacity must be a power of two" );
+		static_assert( std::is_trivially_copyable_v<T> );
+
+	public:
+		// Owner only, false when full
+		bool push( T _value );
+		// Owner only
+		std::optional<T> pop();
+		// Any thread, empty if there was nothing or another thief won the race
+		std::optional<T> steal();
+
+		bool empty() const;
+
+	private:
+		static constexpr i64 MASK = Capacity - 1;
+
+		// Thieves and the owner each hammer their own end, keep them off the same cache line
+		alignas( 64 ) std::atomic<i64> m_Top{ 0 };
+		alignas( 64 ) std::atomic<i64> m_Bottom{ 0 };
+		alignas( 64 ) std::array<std::atomic<T>, Capacity> m_Buffer;
+	};
+
+	//--------------------------------------------------------------------
+	template<typename T, u32 Capacity>
+	bool WorkStealingDeque<T, Capacity>::push( T _value )
+	{
+		const i64 bottom = m_Bottom.load( std::memory_order_relaxed );
+		const i64 top = m_Top.load( std::memory_order_acquire );
+
+		if ( bottom - top >= static_cast<i64>( Capacity ) )
+			return false;
+
+		m_Buffer[bottom & MASK].store( _value, std::memory_order_relaxed );
+		// The slot must be visible before a thief can see the new bottom
+		std::atomic_thread_fence( std::memory_order_release );
+		m_Bottom.store( bottom + 1, std::memory_order_relaxed );
+		return true;
+	}
+
+	//--------------------------------------------------------------------
+	template<typename T, u32 Capacity>
+	std::optional<T> WorkStealingDeque<T, Capacity>::pop()
+	{
+		// Claim the bottom slot first, then check whether a thief got there too
+		const i64 bottom = m_Bottom.load( std::memory_order_relaxed ) - 1;
+		m_Bottom.store( bottom, std::memory_order_relaxed );
+		std::atomic_thread_fence( std::memory_order_seq_cst );
+		i64 top = m_Top.load( std::memory_order_relaxed );
+
+		if ( top > bottom )
+		{
+			// Already empty
+			m_Bottom.store( bottom + 1, std::memory_order_relaxed );
+			return std::nullopt;
+		}
+
+		std::optional<T> value = m_Buffer[bottom & MASK].load( std::memory_order_relaxed );
+
+		if ( top == bottom )
+		{
+			// Last element, the owner and thieves race for it on top
+			if ( !m_Top.compare_exchange_strong( top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed ) )
+			{
+				value.reset();
+			}
+			m_Bottom.store( bottom + 1, std::memory_order_relaxed );
+		}
+
+		return value;
+	}
+
+	//--------------------------------------------------------------------
+	template<typename T, u32 Capacity>
+	std::optional<T> WorkStealingDeque<T, Capacity>::steal()
+	{
+		i64 top = m_Top.load( std::memory_order_acquire );
+		std::atomic_thread_fence( std::memory_order_seq_cst );
+		const i64 bottom = m_Bottom.load( std::memory_order_acquire );
+
+		if ( top >= bottom )
+			return std::nullopt;
+
+		const T value = m_Buffer[top & MASK].load( std::memory_order_relaxed );
+		if ( !m_Top.compare_exchange_strong( top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed ) )
+			return std::nullopt;
+
+		return value;
+	}
+
+	//--------------------------------------------------------------------
+	template<typename T, u32 Capacity>
+	bool WorkStealingDeque<T, Capacity>::empty() const
+	{
+		return m_Top.load( std::memory_order_relaxed ) >= m_Bottom.load( std::memory_order_relaxed );
+	}
+
+} // end namespace Utils
@@ -0,0 +1,583 @@
+#include "BenchApp.h"
+
+#include <cstring>
+#include <fstream>
+#include <numeric>
+#include <random>
+
+#include "../../Maths/Frustum.h"
+#include "../../Scene/Import/MeshFile.h"
+#include "../../Scene/Import/MeshImporter.h"
+
+namespace App::BenchApp {
+
+	namespace {
+		// Opens the simulation thread edits AppScene keeps to itself
+		class BenchScene : public ::Scene::BaseScene
+		{
+		public:
+			using BaseScene::addMesh;
+			using BaseScene::removeMesh;
+			using BaseScene::publishSnapshot;
+		};
+
+		//--------------------------------------------------------------------
+		// UV sphere of _segments^2 triangles, written as .obj and .glb, for when no model is given
+		std::vector<std::filesystem::path> WriteSphereModels( const std::filesystem::path& _directory, u32 _segments )
+		{
+			const u32 rings = _segments / 2;
+			std::vector<Maths::Vector3> points;
+			for ( u32 r = 0; r <= rings; r++ )
+			{
+				const f32 theta = PI * f32( r ) / f32( rings );
+				for ( u32 s = 0; s <= _segments; s++ )
+				{
+					const f32 phi = 2.0f * PI * f32( s ) / f32( _segments );
+					points.push_back( { std::sin( theta ) * std::cos( phi ), std::cos( theta ), std::sin( theta ) * std::sin( phi ) } );
+				}
+			}
+
+			std::vector<u32> indices;
+			for ( u32 r = 0; r < rings; r++ )
+			{
+				for ( u32 s = 0; s < _segments; s++ )
+				{
+					const u32 a = r * ( _segments + 1 ) + s;
+					const u32 b = a + _segments + 1;
+					indices.insert( indices.end(), { a, b, a + 1, a + 1, b, b + 1 } );
+				}
+			}
+
+			std::filesystem::create_directories( _directory );
+			const std::filesystem::path objPath = _directory / "sphere.obj";
+			const std::filesystem::path glbPath = _directory / "sphere.glb";
+
+			// The unit normal of a sphere is its position
+			std::ofstream obj( objPath );
+			for ( const Maths::Vector3& p : points )
+			{
+				obj << "v " << p.x << ' ' << p.y << ' ' << p.z << "\nvn " << p.x << ' ' << p.y << ' ' << p.z << '\n';
+			}
+			for ( size_t i = 0; i < indices.size(); i += 3 )
+			{
+				obj << "f " << indices[i] + 1 << "//" << indices[i] + 1 << ' ' << indices[i + 1] + 1 << "//" << indices[i + 1] + 1
+					<< ' ' << indices[i + 2] + 1 << "//" << indices[i + 2] + 1 << '\n';
+			}
+
+			const u32 pointBytes = static_cast<u32>( points.size() * sizeof( Maths::Vector3 ) );
+			const u32 indexBytes = static_cast<u32>( indices.size() * sizeof( u32 ) );
+			const std::string vertexCount = std::to_string( points.size() );
+			std::string json = R"({"asset":{"version":"2.0"},"scene":0,"scenes":[{"nodes":[0]}],"nodes":[{"mesh":0}],)"
+				R"("meshes":[{"primitives":[{"attributes":{"POSITION":0,"NORMAL":1},"indices":2}]}],"accessors":[)"
+				R"({"bufferView":0,"componentType":5126,"type":"VEC3","count":)" + vertexCount + "},"
+				R"({"bufferView":0,"componentType":5126,"type":"VEC3","count":)" + vertexCount + "},"
+				R"({"bufferView":1,"componentType":5125,"type":"SCALAR","count":)" + std::to_string( indices.size() ) + "}],"
+				R"("bufferViews":[{"buffer":0,"byteLength":)" + std::to_string( pointBytes ) + "},"
+				R"({"buffer":0,"byteOffset":)" + std::to_string( pointBytes ) + R"(,"byteLength":)" + std::to_string( indexBytes ) + "}],"
+				R"("buffers":[{"byteLength":)" + std::to_string( pointBytes + indexBytes ) + "}]}";
+			json.resize( ( json.size() + 3 ) & ~size_t( 3 ), ' ' );
+
+			auto writeU32 = []( std::ofstream& _out, u32 _value ) { _out.write( reinterpret_cast<const char*>( &_value ), sizeof( _value ) ); };
+			const u32 jsonBytes = static_cast<u32>( json.size() );
+			std::ofstream glb( glbPath, std::ios::binary );
+			writeU32( glb, 0x46546C67 );
+			writeU32( glb, 2 );
+			writeU32( glb, 12 + 8 + jsonBytes + 8 + pointBytes + indexBytes );
+			writeU32( glb, jsonBytes );
+			writeU32( glb, 0x4E4F534A );
+			glb.write( json.data(), jsonBytes );
+			writeU32( glb, pointBytes + indexBytes );
+			writeU32( glb, 0x004E4942 );
+			glb.write( reinterpret_cast<const char*>( points.data() ), pointBytes );
+			glb.write( reinterpret_cast<const char*>( indices.data() ), indexBytes );
+
+			return { objPath, glbPath };
+		}
+	} // end anonymous namespace
+
+	//--------------------------------------------------------------------
+	BenchApp::BenchApp()
+	{
+	}
+
+	//--------------------------------------------------------------------
+	BenchApp::~BenchApp()
+	{
+
+	}
+
+	//--------------------------------------------------------------------
+	void BenchApp::initVulkan()
+	{
+		// Only GPU benchmarks open a window
+		Display::Instance( Config::WINDOW_WIDTH, Config::WINDOW_HEIGHT, "Vulkan Bench" );
+
+		m_pRenderer = std::make_unique<Engine::Renderer>();
+		m_pRenderer->init( Display::Instance().getWindowPtr() );
+	}
+
+	//--------------------------------------------------------------------
+	void BenchApp::createScene()
+	{
+		m_AppScene = std::make_unique<ModelApp::AppScene>( *m_pRenderer );
+	}
+
+	//--------------------------------------------------------------------
+	void BenchApp::runShaderProfiles( u32 _numFrames )
+	{
+		initVulkan();
+		createScene();
+
+		constexpr std::array<Engine::ShaderBuildProfile, 2> profiles{ Engine::ShaderBuildProfile::DEBUG, Engine::ShaderBuildProfile::RELEASE };
+
+		std::array<f64, profiles.size()> results{};
+		for ( size_t i = 0; i < profiles.size(); i++ )
+		{
+			m_pRenderer->setShaderBuildProfile( profiles[i] );
+			results[i] = measureGpuFrameTime( _numFrames );
+		}
+
+		std::cout << "Shader profile GPU frame time over " << _numFrames << " frames:" << std::endl;
+		for ( size_t i = 0; i < profiles.size(); i++ )
+		{
+			std::cout << "  " << Engine::RuntimeShaderCompiler::profileName( profiles[i] ) << ": " << results[i] << " ms" << std::endl;
+		}
+	}
+
+	//--------------------------------------------------------------------
+	void BenchApp::runTransformEncodings( u32 _numFrames )
+	{
+		using Clock = std::chrono::steady_clock;
+
+		initVulkan();
+		createScene();
+
+		constexpr std::array<Engine::TransformEncoding, 3> encodings{
+			Engine::TransformEncoding::MATRIX_4X4,
+			Engine::TransformEncoding::AFFINE_3X4,
+			Engine::TransformEncoding::QUANTIZED
+		};
+
+		// Uniform scale so the quantized encoding is lossless apart from rounding
+		constexpr u32 encodeCount = 100'000;
+		std::vector<Maths::Matrix4> models( encodeCount );
+		for ( u32 i = 0; i < encodeCount; i++ )
+		{
+			const f32 scale = 0.5f + f32( i % 8 ) * 0.1f;
+			models[i] = Maths::Quaternion::FromEuler( { f32( i % 360 ), f32( i % 90 ), 0.0f } ).ToModelMatrix( { f32( i % 100 ), 0.0f, f32( i / 100 ) }, { scale, scale, scale } );
+		}
+		std::vector<std::byte> encoded( size_t( encodeCount ) * sizeof( Maths::Matrix4 ) );
+
+		std::cout << "Transform encodings, GPU frame time over " << _numFrames << " frames:" << std::endl;
+		for ( const auto encoding : encodings )
+		{
+			const u32 stride = Engine::TransformEncoder::stride( encoding );
+
+			const auto start = Clock::now();
+			for ( u32 i = 0; i < encodeCount; i++ )
+			{
+				Engine::TransformEncoder::encode( encoding, models[i], encoded.data() + size_t( i ) * stride );
+			}
+			const f64 encodeRate = encodeCount / std::chrono::duration<f64>( Clock::now() - start ).count();
+
+			m_pRenderer->setTransformEncoding( encoding );
+			const f64 gpuMs = measureGpuFrameTime( _numFrames );
+
+			std::cout << "  " << Engine::TransformEncoder::name( encoding ) << ": " << stride << " bytes/object, "
+				<< encodeRate << " encodes/s, " << gpuMs << " ms" << std::endl;
+		}
+	}
+
+	//--------------------------------------------------------------------
+	void BenchApp::runVertexPulling( u32 _numFrames )
+	{
+		initVulkan();
+		createScene();
+
+		constexpr std::array<bool, 2> modes{ false, true };
+
+		std::array<f64, modes.size()> results{};
+		for ( size_t i = 0; i < modes.size(); i++ )
+		{
+			m_pRenderer->setVertexPulling( modes[i] );
+			if ( m_pRenderer->isVertexPullingEnabled() != modes[i] )
+			{
+				std::cout << "Vertex pulling not supported by the device" << std::endl;
+				return;
+			}
+			results[i] = measureGpuFrameTime( _numFrames );
+		}
+
+		std::cout << "Vertex fetch GPU frame time over " << _numFrames << " frames:" << std::endl;
+		std::cout << "  input assembler: " << results[0] << " ms" << std::endl;
+		std::cout << "  vertex pulling: " << results[1] << " ms" << std::endl;
+	}
+
+	//--------------------------------------------------------------------
+	void BenchApp::runMeshHandles( u32 _numMeshes )
+	{
+		using Clock = std::chrono::steady_clock;
+		auto elapsedMs = []( Clock::time_point _start ) { return std::chrono::duration<f64, std::milli>( Clock::now() - _start ).count(); };
+
+		// Names are unique within a scene, built before timing
+		std::vector<::Scene::Primitives::Quad> quads;
+		quads.reserve( _numMeshes );
+		for ( u32 i = 0; i < _numMeshes; i++ )
+		{
+			quads.emplace_back( "Bench_Quad_" + std::to_string( i ) );
+		}
+
+		// Through the scene, so the journal, TransformStorage, SceneGraph and name map are part of every measurement
+		BenchScene scene;
+		std::vector<::Scene::MeshHandle> handles( _numMeshes );
+
+		auto start = Clock::now();
+		for ( u32 i = 0; i < _numMeshes; i++ )
+		{
+			handles[i] = scene.addMesh( quads[i] );
+		}
+		const f64 addMs = elapsedMs( start );
+
+		// The world matrices and the snapshot are only built here
+		start = Clock::now();
+		scene.publishSnapshot();
+		const f64 publishMs = elapsedMs( start );
+
+		start = Clock::now();
+		size_t found = 0;
+		for ( const auto handle : handles )
+		{
+			found += scene.getMesh( handle ).has_value() ? 1 : 0;
+		}
+		const f64 lookupMs = elapsedMs( start );
+
+		// Remove in insertion order, the worst case for the old swap-and-pop + rebuild scheme
+		start = Clock::now();
+		for ( const auto handle : handles )
+		{
+			scene.removeMesh( handle );
+		}
+		const f64 removeMs = elapsedMs( start );
+
+		assert( found == _numMeshes );
+
+		std::cout << "Mesh handles, " << _numMeshes << " meshes:" << std::endl;
+		std::cout << "  add: " << addMs << " ms" << std::endl;
+		std::cout << "  publish: " << publishMs << " ms" << std::endl;
+		std::cout << "  lookup: " << lookupMs << " ms" << std::endl;
+		std::cout << "  remove: " << removeMs << " ms" << std::endl;
+	}
+
+	//--------------------------------------------------------------------
+	void BenchApp::runTransformBatch( std::span<const u32> _objectCounts )
+	{
+		using Clock = std::chrono::steady_clock;
+		auto elapsedSec = []( Clock::time_point _start ) { return std::chrono::duration<f64>( Clock::now() - _start ).count(); };
+
+		std::mt19937 rng( 42 );
+		std::uniform_real_distribution<f32> angle( -180.0f, 180.0f );
+		std::uniform_real_distribution<f32> unit( -1.0f, 1.0f );
+
+		std::cout << "Model matrix composition (matrices/s):" << std::endl;
+
+		for ( const u32 count : _objectCounts )
+		{
+			std::vector<::Scene::Transform> transforms( count );
+			std::vector<Maths::Vector3> eulerAngles( count );
+			for ( u32 i = 0; i < count; i++ )
+			{
+				eulerAngles[i] = { angle( rng ), angle( rng ), angle( rng ) };
+				transforms[i].m_Position = { unit( rng ) * 100.0f, unit( rng ) * 100.0f, unit( rng ) * 100.0f };
+				transforms[i].m_Rotation = Maths::Quaternion::FromEuler( eulerAngles[i] );
+				transforms[i].m_Scale = { 1.0f + unit( rng ) * 0.5f, 1.0f, 1.0f };
+			}
+
+			::Scene::TransformStorage storage;
+			storage.reserve( count );
+			for ( const auto& transform : transforms )
+			{
+				storage.push( transform );
+			}
+
+			// Aim for roughly the same amount of work whatever the count
+			const u32 repeats = std::max( 1u, 10'000'000u / count );
+
+			// Baseline, one Euler Matrix4::Model per object with its six trig calls
+			std::vector<Maths::Matrix4> matrices( count );
+			auto start = Clock::now();
+			for ( u32 r = 0; r < repeats; r++ )
+			{
+				for ( u32 i = 0; i < count; i++ )
+				{
+					matrices[i] = Maths::Matrix4::Model( transforms[i].m_Position, eulerAngles[i], transforms[i].m_Scale );
+				}
+			}
+			const f64 eulerRate = f64( count ) * repeats / elapsedSec( start );
+
+			// Same loop from quaternions, no trig left
+			start = Clock::now();
+			for ( u32 r = 0; r < repeats; r++ )
+			{
+				for ( u32 i = 0; i < count; i++ )
+				{
+					matrices[i] = transforms[i].toMatrix();
+				}
+			}
+			const f64 quaternionRate = f64( count ) * repeats / elapsedSec( start );
+
+			f64 batchSec = 0.0;
+			for ( u32 r = 0; r < repeats; r++ )
+			{
+				storage.markAllDirty();
+				start = Clock::now();
+				storage.updateMatrices();
+				batchSec += elapsedSec( start );
+			}
+			const f64 batchRate = f64( count ) * repeats / batchSec;
+
+			// Typical frame, a tenth of the objects animated: blended rotation plus a new position, timed with the edits
+			const u32 movedCount = std::max( 1u, count / 10 );
+			const Maths::Quaternion target = Maths::Quaternion::FromEuler( { 90.0f, 45.0f, 0.0f } );
+			f64 sparseSec = 0.0;
+			for ( u32 r = 0; r < repeats; r++ )
+			{
+				const u32 first = rng() % count;
+				const f32 t = f32( r % 100 ) / 100.0f;
+				start = Clock::now();
+				for ( u32 m = 0; m < movedCount; m++ )
+				{
+					const u32 index = ( first + m * 7919 ) % count;
+					storage.setRotation( index, Maths::Quaternion::Nlerp( transforms[index].m_Rotation, target, t ) );
+					storage.setPosition( index, transforms[index].m_Position );
+				}
+				storage.updateMatrices();
+				sparseSec += elapsedSec( start );
+			}
+			const f64 sparseRate = f64( movedCount ) * repeats / sparseSec;
+
+			std::cout << "  " << count << " objects: Euler Matrix4::Model " << eulerRate
+				<< ", quaternion per object " << quaternionRate
+				<< ", batch all dirty " << batchRate
+				<< ", animated 10% " << sparseRate << std::endl;
+		}
+	}
+
+	//--------------------------------------------------------------------
+	void BenchApp::runMathsKernels( u32 _count )
+	{
+		using Clock = std::chrono::steady_clock;
+
+		std::mt19937 rng( 42 );
+		std::uniform_real_distribution<f32> angle( -180.0f, 180.0f );
+		std::uniform_real_distribution<f32> unit( -1.0f, 1.0f );
+
+		std::vector<Maths::Matrix4> matrices( _count );
+		std::vector<Maths::Vector3> points( _count );
+		for ( u32 i = 0; i < _count; i++ )
+		{
+			matrices[i] = Maths::Matrix4::Model( { unit( rng ) * 100.0f, unit( rng ) * 100.0f, unit( rng ) * 100.0f },
+				{ angle( rng ), angle( rng ), angle( rng ) }, { 1.0f + unit( rng ) * 0.5f, 1.0f, 1.0f } );
+			points[i] = { unit( rng ), unit( rng ), unit( rng ) };
+		}
+
+		std::vector<Maths::Matrix4> results( _count );
+		std::vector<Maths::Vector3> transformed( _count );
+		std::vector<Maths::Frustum> frustums( _count );
+
+		// Roughly ten million operations per measurement
+		const u32 repeats = std::max( 1u, 10'000'000u / _count );
+
+		// Operations per second of _kernel( i ) over every element
+		auto measure = [&]( auto&& _kernel ) {
+			const auto start = Clock::now();
+			for ( u32 r = 0; r < repeats; r++ )
+			{
+				for ( u32 i = 0; i < _count; i++ )
+				{
+					_kernel( i );
+				}
+			}
+			return f64( _count ) * repeats / std::chrono::duration<f64>( Clock::now() - start ).count();
+		};
+
+		auto report = []( const char* _name, f64 _simdRate, f64 _scalarRate ) {
+			std::cout << "  " << _name << ": simd " << _simdRate << ", scalar " << _scalarRate << " (x" << _simdRate / _scalarRate << ")" << std::endl;
+		};
+
+		std::cout << "Matrix4 kernels (ops/s), " << _count << " elements, SIMD " << ( WRAP_SIMD_SSE ? "SSE" : "disabled" ) << ":" << std::endl;
+
+		report( "multiply",
+			measure( [&]( u32 i ) { results[i] = matrices[i] * matrices[_count - 1 - i]; } ),
+			measure( [&]( u32 i ) { results[i] = Maths::Scalar::Multiply( matrices[i], matrices[_count - 1 - i] ); } ) );
+
+		report( "affine inverse",
+			measure( [&]( u32 i ) { results[i] = matrices[i].AffineInverse(); } ),
+			measure( [&]( u32 i ) { results[i] = Maths::Scalar::AffineInverse( matrices[i] ); } ) );
+
+		report( "transpose",
+			measure( [&]( u32 i ) { results[i] = matrices[i].Transpose(); } ),
+			measure( [&]( u32 i ) { results[i] = Maths::Scalar::Transpose( matrices[i] ); } ) );
+
+		report( "frustum planes",
+			measure( [&]( u32 i ) { frustums[i] = Maths::Frustum::FromMatrix( matrices[i] ); } ),
+			measure( [&]( u32 i ) { frustums[i] = Maths::Scalar::ExtractFrustum( matrices[i] ); } ) );
+
+		// Batch kernels take the whole array at once, one call per repeat
+		auto measureBatch = [&]( auto&& _kernel ) {
+			const auto start = Clock::now();
+			for ( u32 r = 0; r < repeats; r++ )
+			{
+				_kernel( matrices[r % _count] );
+			}
+			return f64( _count ) * repeats / std::chrono::duration<f64>( Clock::now() - start ).count();
+		};
+
+		report( "transform points",
+			measureBatch( [&]( const Maths::Matrix4& _m ) { _m.TransformPoints( points, transformed ); } ),
+			measureBatch( [&]( const Maths::Matrix4& _m ) { Maths::Scalar::TransformPoints( _m, points, transformed ); } ) );
+
+		report( "transform vectors",
+			measureBatch( [&]( const Maths::Matrix4& _m ) { _m.TransformVectors( points, transformed ); } ),
+			measureBatch( [&]( const Maths::Matrix4& _m ) { Maths::Scalar::TransformVectors( _m, points, transformed ); } ) );
+	}
+
+	//--------------------------------------------------------------------
+	void BenchApp::runMeshImport( std::span<const std::filesystem::path> _paths )
+	{
+		using Clock = std::chrono::steady_clock;
+		auto elapsedSec = []( Clock::time_point _start ) { return std::chrono::duration<f64>( Clock::now() - _start ).count(); };
+
+		std::vector<std::filesystem::path> paths( _paths.begin(), _paths.end() );
+		if ( paths.empty() )
+		{
+			paths = WriteSphereModels( std::filesystem::temp_directory_path() / "WrapImportBench", 1448 );
+		}
+
+		// Same importer on the calling thread only, against every worker helping
+		Utils::JobSystem serialJobs( 0 );
+		Utils::JobSystem& parallelJobs = Utils::JobSystem::Instance();
+
+		auto bestParse = [&]( const std::filesystem::path& _path, Utils::JobSystem& _jobs, std::shared_ptr<::Scene::ImportedMesh>& _mesh ) {
+			f64 best = std::numeric_limits<f64>::max();
+			for ( u32 r = 0; r < 3; r++ )
+			{
+				const auto start = Clock::now();
+				_mesh = ::Scene::MeshImporter::parse( _path, _jobs );
+				best = std::min( best, elapsedSec( start ) );
+			}
+			return best;
+		};
+
+		std::cout << "Mesh import, best of 3 (triangles/s):" << std::endl;
+
+		for ( const std::filesystem::path& path : paths )
+		{
+			std::shared_ptr<::Scene::ImportedMesh> pMesh;
+			const f64 serialSec = bestParse( path, serialJobs, pMesh );
+			const f64 parallelSec = bestParse( path, parallelJobs, pMesh );
+			if ( !pMesh )
+				continue;
+
+			const auto optimizeStart = Clock::now();
+			const ::Scene::MeshOptimizeReport report = pMesh->optimize();
+			const f64 optimizeSec = elapsedSec( optimizeStart );
+
+			const auto lodStart = Clock::now();
+			pMesh->generateLods();
+			const f64 lodSec = elapsedSec( lodStart );
+
+			const auto clusterStart = Clock::now();
+			pMesh->buildClusters();
+			const f64 clusterSec = elapsedSec( clusterStart );
+
+			// Stands in for the mapped staging buffer the renderer hands to the writer
+			std::vector<Engine::Vertex> vertices( pMesh->getVertexCount() );
+			std::vector<u32> indices( pMesh->getIndexCount() );
+			const auto start = Clock::now();
+			pMesh->write( vertices, indices, parallelJobs );
+			const f64 writeSec = elapsedSec( start );
+
+			const f64 triangles = pMesh->getTriangleCount();
+			std::cout << "  " << path.filename().string() << ": " << pMesh->getTriangleCount() << " triangles, " << pMesh->getVertexCount()
+				<< " vertices of " << sizeof( Engine::Vertex ) << " bytes after dedup (" << f64( pMesh->getIndexCount() ) / pMesh->getVertexCount() << " corners each)" << std::endl;
+			std::cout << "    1 thread " << serialSec * 1000.0 << " ms (" << triangles / serialSec
+				<< "), " << parallelJobs.getWorkerCount() + 1 << " threads " << parallelSec * 1000.0 << " ms (" << triangles / parallelSec
+				<< "), staging write " << writeSec * 1000.0 << " ms" << std::endl;
+			std::cout << "    optimize " << optimizeSec * 1000.0 << " ms, ACMR " << report.m_Before.m_Acmr << " -> " << report.m_After.m_Acmr
+				<< ", ATVR " << report.m_Before.m_Atvr << " -> " << report.m_After.m_Atvr << std::endl;
+			std::cout << "    " << pMesh->getLods().size() << " LODs in " << lodSec * 1000.0 << " ms, triangles (error)";
+			for ( const ::Scene::GeometryLod& lod : pMesh->getLods() )
+			{
+				std::cout << " " << lod.m_IndexCount / 3 << " (" << lod.m_Error << ")";
+			}
+			std::cout << std::endl;
+
+			const u32 clusterCount = static_cast<u32>( pMesh->getClusters().size() );
+			const u32 clusteredTriangles = std::accumulate( pMesh->getClusters().begin(), pMesh->getClusters().end(), 0u,
+				[]( u32 _sum, const ::Scene::GeometryCluster& _cluster ) { return _sum + _cluster.m_IndexCount / 3; } );
+			std::cout << "    " << clusterCount << " clusters in " << clusterSec * 1000.0 << " ms, "
+				<< ( clusterCount > 0 ? f64( clusteredTriangles ) / clusterCount : 0.0 ) << " triangles each" << std::endl;
+
+			std::vector<::Scene::MeshFileFormat::LodEntry> lods;
+			for ( const ::Scene::GeometryLod& lod : pMesh->getLods() )
+			{
+				lods.push_back( ::Scene::MeshFileFormat::LodEntry{ .m_FirstIndex = lod.m_FirstIndex, .m_IndexCount = lod.m_IndexCount, .m_Error = lod.m_Error,
+					.m_FirstCluster = lod.m_FirstCluster, .m_ClusterCount = lod.m_ClusterCount, .m_Reserved = 0 } );
+			}
+
+			std::vector<::Scene::MeshFileFormat::ClusterEntry> clusters;
+			for ( const ::Scene::GeometryCluster& cluster : pMesh->getClusters() )
+			{
+				clusters.push_back( ::Scene::MeshFileFormat::ClusterEntry{ .m_FirstIndex = cluster.m_FirstIndex, .m_IndexCount = cluster.m_IndexCount,
+					.m_Center = cluster.m_Center, .m_Radius = cluster.m_Radius, .m_ConeAxis = cluster.m_ConeAxis, .m_ConeCutoff = cluster.m_ConeCutoff } );
+			}
+
+			// Same mesh through the native format: map, validate, copy both blobs into the staging stand-in
+			const std::filesystem::path binaryPath = std::filesystem::temp_directory_path() / std::filesystem::path( path.filename() ).replace_extension( ::Scene::MeshFileFormat::EXTENSION );
+			if ( !::Scene::MeshFile::write( binaryPath, vertices, indices, lods, clusters, pMesh->getFrame() ) )
+				continue;
+
+			f64 binarySec = std::numeric_limits<f64>::max();
+			for ( u32 r = 0; r < 3; r++ )
+			{
+				const auto binaryStart = Clock::now();
+				std::shared_ptr<const ::Scene::MeshFile> pFile = ::Scene::MeshFile::open( binaryPath );
+				if ( !pFile )
+					break;
+
+				std::memcpy( vertices.data(), pFile->getVertices().data(), pFile->getVertices().size_bytes() );
+				std::memcpy( indices.data(), pFile->getIndices().data(), pFile->getIndices().size_bytes() );
+				binarySec = std::min( binarySec, elapsedSec( binaryStart ) );
+			}
+
+			const f64 textSec = parallelSec + optimizeSec + lodSec + clusterSec + writeSec;
+			std::cout << "    " << binaryPath.filename().string() << " load and staging write " << binarySec * 1000.0 << " ms (" << triangles / binarySec
+				<< "), " << textSec / binarySec << "x the text path" << std::endl;
+		}
+	}
+
+	//--------------------------------------------------------------------
+	f64 BenchApp::measureGpuFrameTime( u32 _numFrames )
+	{
+		// Warm up so pipeline creation and first use costs stay out of the average
+		constexpr u32 warmupFrames = 16;
+		for ( u32 i = 0; i < warmupFrames && !Display::Instance().shouldClose(); i++ )
+		{
+			Display::Instance().pollEvents();
+			m_AppScene->syncRenderer();
+			m_pRenderer->drawFrames();
+		}
+
+		m_pRenderer->resetGpuFrameTimings();
+
+		for ( u32 i = 0; i < _numFrames && !Display::Instance().shouldClose(); i++ )
+		{
+			Display::Instance().pollEvents();
+			m_AppScene->update();
+			m_AppScene->syncRenderer();
+			m_pRenderer->drawFrames();
+		}
+
+		return m_pRenderer->getAverageGpuFrameTimeMs();
+	}
+} // end namespace App::BenchApp
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "../../Utils/Common.h"
+#include <vulkan/vulkan.h>
+
+#include "../../Platforms/Windows/Display.h"
+#include "../../Engine/Renderer.h"
+#include "../ModelApp/AppScene.h"
+#include "../../Scene/TransformStorage.h"
+
+#include <filesystem>
+#include <span>
+
+namespace App {
+
+	namespace BenchApp
+	{
+		// Offline measurements run from the command line, results are printed to stdout
+		class BenchApp
+		{
+		public:
+			BenchApp();
+
+			~BenchApp();
+
+			void runShaderProfiles( u32 _numFrames );
+			// Bytes per object, CPU encode rate and GPU frame time of each Engine::TransformEncoding
+			void runTransformEncodings( u32 _numFrames );
+			// GPU frame time with the vertex input assembler and with pull.vert, on the same scene
+			void runVertexPulling( u32 _numFrames );
+			void runMeshHandles( u32 _numMeshes );
+			void runTransformBatch( std::span<const u32> _objectCounts );
+			// SIMD Matrix4 kernels against their Maths::Scalar reference
+			void runMathsKernels( u32 _count );
+			// Parse rate of Scene::MeshImporter on one thread and on the job system, then load rate of the same mesh as a Scene::MeshFile.
+			// A generated sphere without paths
+			void runMeshImport( std::span<const std::filesystem::path> _paths );
+
+		private:
+			void initVulkan();
+
+			void createScene();
+
+			f64 measureGpuFrameTime( u32 _numFrames );
+
+			std::unique_ptr<Engine::Renderer> m_pRenderer;
+			std::unique_ptr<ModelApp::AppScene> m_AppScene;
+		};
+	} // end namespace BenchApp
+
+} // end namespace App
@@ -19,10 +19,12 @@ void App::ModelApp::AppScene::addGeometry()
 {
 	m_Quad1 = addMesh( ::Scene::Primitives::Quad( "Quad_1" ) );
 
-	auto mesh2Mat = Maths::Matrix4::Model( {1.0f, 0.0f, 0.0f}, {0.0f, 20.0f, 0.0f}, {0.5f, 0.5f, 0.5f} );
-	m_Quad2 = addMesh( ::Scene::Primitives::Quad( "Quad_2", mesh2Mat ) );
-
-	rendererUpdateMeshes( m_Renderer );
+	const ::Scene::Transform mesh2Transform{
+		.m_Position = { 1.0f, 0.0f, 0.0f },
+		.m_Rotation = Maths::Quaternion::FromEuler( { 0.0f, 20.0f, 0.0f } ),
+		.m_Scale = { 0.5f, 0.5f, 0.5f }
+	};
+	m_Quad2 = addMesh( ::Scene::Primitives::Quad( "Quad_2", mesh2Transform ) );
 }
 
 //--------------------------------------------------------------------------------
@@ -31,6 +33,8 @@ void App::ModelApp::AppScene::start()
 	addGeometry();
 	setUpCamera();
 
+	publishSnapshot();
+
 	m_LastTimeUpdate = std::chrono::steady_clock::now();
 }
 
@@ -43,6 +47,13 @@ void App::ModelApp::AppScene::update()
 	m_LastTimeUpdate = now;
 	m_SceneTime += delta.count();
 
+	publishSnapshot();
+}
+
+//--------------------------------------------------------------------------------
+void App::ModelApp::AppScene::syncRenderer()
+{
+	BaseScene::syncRenderer( m_Renderer );
 }
 
 //--------------------------------------------------------------------------------
@@ -60,5 +71,5 @@ void App::ModelApp::AppScene::setUpCamera()
 		.m_Far = 10.0f
 	};
 
-	updateCamera( m_Renderer, m_Camera, m_ProjectionSettings );
+	updateCamera( m_Camera, m_ProjectionSettings );
 }
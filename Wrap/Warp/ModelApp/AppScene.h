@@ -15,7 +15,10 @@ namespace App::ModelApp
 		virtual ~AppScene();
 
 		void start();
+		// Simulation thread
 		void update();
+		// Render thread, before drawing
+		void syncRenderer();
 
 	private:
 		void addGeometry();
@@ -32,12 +32,20 @@ namespace App::ModelApp {
 	//--------------------------------------------------------------------
 	void ModelApp::mainLoop()
 	{
+		// Window events and simulation stay on the main thread, recording and submission move to the render thread
+		Engine::FramePipeline pipeline( [this]() {
+			m_AppScene->syncRenderer();
+			m_pRenderer->drawFrames();
+		} );
+
 		while ( !Display::Instance().shouldClose() )
 		{
 			Display::Instance().pollEvents();
 			m_AppScene->update();
-			m_pRenderer->drawFrames();
+			pipeline.submitFrame();
 		}
+
+		pipeline.stop();
 	}
 
 	//--------------------------------------------------------------------
@@ -5,6 +5,7 @@
 
 #include "../../Platforms/Windows/Display.h"
 #include "../../Engine/Renderer.h"
+#include "../../Engine/FramePipeline.h"
 #include "../../Engine/VulkanTypes.h"
 #include "../../Scene/BaseScene.h"
 #include "AppScene.h"
@@ -8,10 +8,103 @@
 
 #include "Warp/TriangleApp/TriangleApp.h"
 #include "Warp/ModelApp/ModelApp.h"
+#include "Warp/BenchApp/BenchApp.h"
 
 #include "Engine/RuntimeShaderCompiler.h"
+#include "Engine/ShaderArchive.h"
+#include "Scene/Import/MeshFile.h"
 
-int main() {
+int main( int argc, char** argv ) {
+
+	const std::vector<std::string_view> args( argv + 1, argv + argc );
+
+	// Wrap --bake-shaders [sourceDir] [archive]
+	if ( auto it = std::ranges::find( args, "--bake-shaders" ); it != args.end() )
+	{
+		std::filesystem::path sourceDir{ "./Shaders" };
+		std::filesystem::path archive{ Engine::ShaderArchiveFormat::DEFAULT_ARCHIVE_PATH };
+
+		if ( ++it != args.end() )
+			sourceDir = *it;
+		if ( it != args.end() && ++it != args.end() )
+			archive = *it;
+
+		return Engine::ShaderArchive::bake( sourceDir, archive ) ? 0 : 1;
+	}
+
+	if ( std::ranges::find( args, "--bench-shaders" ) != args.end() )
+	{
+		std::unique_ptr<App::BenchApp::BenchApp> bench = std::make_unique<App::BenchApp::BenchApp>();
+		bench->runShaderProfiles( 1000 );
+		return 0;
+	}
+
+	if ( std::ranges::find( args, "--bench-encodings" ) != args.end() )
+	{
+		std::unique_ptr<App::BenchApp::BenchApp> bench = std::make_unique<App::BenchApp::BenchApp>();
+		bench->runTransformEncodings( 1000 );
+		return 0;
+	}
+
+	if ( std::ranges::find( args, "--bench-pulling" ) != args.end() )
+	{
+		std::unique_ptr<App::BenchApp::BenchApp> bench = std::make_unique<App::BenchApp::BenchApp>();
+		bench->runVertexPulling( 1000 );
+		return 0;
+	}
+
+	if ( std::ranges::find( args, "--bench-handles" ) != args.end() )
+	{
+		std::unique_ptr<App::BenchApp::BenchApp> bench = std::make_unique<App::BenchApp::BenchApp>();
+		bench->runMeshHandles( 100000 );
+		return 0;
+	}
+
+	if ( std::ranges::find( args, "--bench-transforms" ) != args.end() )
+	{
+		std::unique_ptr<App::BenchApp::BenchApp> bench = std::make_unique<App::BenchApp::BenchApp>();
+		constexpr std::array<u32, 3> objectCounts{ 10'000, 100'000, 1'000'000 };
+		bench->runTransformBatch( objectCounts );
+		return 0;
+	}
+
+	if ( std::ranges::find( args, "--bench-maths" ) != args.end() )
+	{
+		std::unique_ptr<App::BenchApp::BenchApp> bench = std::make_unique<App::BenchApp::BenchApp>();
+		bench->runMathsKernels( 1 << 16 );
+		return 0;
+	}
+
+	// Wrap --convert-mesh source [dest]
+	if ( auto it = std::ranges::find( args, "--convert-mesh" ); it != args.end() )
+	{
+		if ( ++it == args.end() )
+		{
+			std::cerr << "--convert-mesh needs a source model" << std::endl;
+			return 1;
+		}
+
+		const std::filesystem::path source{ *it };
+		std::filesystem::path dest = std::filesystem::path( source ).replace_extension( Scene::MeshFileFormat::EXTENSION );
+		if ( ++it != args.end() )
+			dest = *it;
+
+		return Scene::MeshFile::convert( source, dest ) ? 0 : 1;
+	}
+
+	// Wrap --bench-import [model...]
+	if ( auto it = std::ranges::find( args, "--bench-import" ); it != args.end() )
+	{
+		std::vector<std::filesystem::path> models;
+		for ( ++it; it != args.end() && !it->starts_with( "--" ); ++it )
+		{
+			models.emplace_back( *it );
+		}
+
+		std::unique_ptr<App::BenchApp::BenchApp> bench = std::make_unique<App::BenchApp::BenchApp>();
+		bench->runMeshImport( models );
+		return 0;
+	}
 
 	std::unique_ptr<App::ModelApp::ModelApp> app = std::make_unique<App::ModelApp::ModelApp>();
 